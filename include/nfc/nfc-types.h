@@ -57,6 +57,11 @@ typedef struct nfc_device nfc_device;
  */
 typedef struct nfc_driver nfc_driver;
 
+/**
+ * NFC device hotplug monitor
+ */
+typedef struct nfc_device_monitor nfc_device_monitor;
+
 /**
  * Connection string
  */
@@ -140,6 +145,15 @@ typedef enum {
   NP_FORCE_ISO14443_B,
   /** Force the chip to run at 106 kbps */
   NP_FORCE_SPEED_106,
+  /** After activating an ISO14443-4 target, negotiate the highest data rate
+   * both the chip and the target support (PPS, sent with InPSL on PN53x).
+   * The target's nbr reports the rate in use. Disabled by default. */
+  NP_AUTO_BIT_RATE,
+  /** Integer property, in milliseconds. When positive,
+   * nfc_initiator_target_is_present() trusts any answer the target gave
+   * within this window instead of probing it again, and otherwise uses the
+   * cheapest probe for the card type. 0 (the default) always probes. */
+  NP_PRESENCE_WINDOW,
 } nfc_property;
 
 // Compiler directive, set struct alignment to 1 uint8_t for compatibility
@@ -335,6 +349,15 @@ typedef enum {
   N_INITIATOR,
 } nfc_mode;
 
+/**
+ * @enum nfc_device_event
+ * @brief Hotplug event returned by nfc_device_monitor_next_event()
+ */
+typedef enum {
+  NFC_DEVICE_ADDED = 1,
+  NFC_DEVICE_REMOVED = 2,
+} nfc_device_event;
+
 /**
  * @struct nfc_modulation
  * @brief NFC modulation structure
@@ -93,6 +93,12 @@ extern "C"
     NFC_EXPORT size_t nfc_list_devices(nfc_context *context, nfc_connstring connstrings[], size_t connstrings_len) ATTRIBUTE_NONNULL(1);
     NFC_EXPORT int nfc_idle(nfc_device *pnd);
 
+    /* NFC device hotplug monitoring */
+    NFC_EXPORT nfc_device_monitor *nfc_device_monitor_new(nfc_context *context) ATTRIBUTE_NONNULL(1);
+    NFC_EXPORT int nfc_device_monitor_get_fd(const nfc_device_monitor *monitor);
+    NFC_EXPORT int nfc_device_monitor_next_event(nfc_device_monitor *monitor, nfc_connstring connstring, int timeout);
+    NFC_EXPORT void nfc_device_monitor_free(nfc_device_monitor *monitor);
+
     /* NFC initiator: act as "reader" */
     NFC_EXPORT int nfc_initiator_init(nfc_device *pnd);
     NFC_EXPORT int nfc_initiator_init_secure_element(nfc_device *pnd);
@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Replays the `test/test_access_storm.c` loop (list devices, then open,
+// initiator init, list ISO14443A targets and close each one) against fake
+// readers whose transport charges a fixed latency per frame exchange and
+// per port claim. Compares plain open/close with the context device pool.
+//
+//     cargo bench --manifest-path rust/Cargo.toml -p proximate-driver \
+//         --bench access_storm
+
+use proximate_driver::{
+    BaudRate, ConnectionString, Context, ContextConfig, DeviceCaps, DeviceHandle, DeviceMeta,
+    DiscoveredDevice, Driver, DriverRegistry, Error, InfoBackend, InitiatorBackend, Mode,
+    Modulation, ModulationType, Pn53xBackend, Property, PropertyBackend, ScanType, Target,
+    TargetBackend,
+};
+use std::collections::HashSet;
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::{Duration, Instant};
+
+const NTESTS: usize = 10;
+const READERS: usize = 2;
+const MAX_TARGET_COUNT: usize = 8;
+// Roughly a USB interface claim or termios setup plus the settle delay.
+const CLAIM_LATENCY: Duration = Duration::from_micros(2_000);
+// One command/ACK/response round trip at 115200 baud.
+const EXCHANGE_LATENCY: Duration = Duration::from_micros(300);
+
+struct FakeTransport;
+
+impl FakeTransport {
+    fn claim() -> Self {
+        thread::sleep(CLAIM_LATENCY);
+        Self
+    }
+
+    fn exchange(&mut self) {
+        thread::sleep(EXCHANGE_LATENCY);
+    }
+}
+
+struct FakeReader {
+    connstring: ConnectionString,
+    transport: FakeTransport,
+    claimed: Arc<Mutex<HashSet<String>>>,
+}
+
+impl Drop for FakeReader {
+    fn drop(&mut self) {
+        self.claimed
+            .lock()
+            .unwrap()
+            .remove(self.connstring.as_str());
+    }
+}
+
+impl DeviceMeta for FakeReader {
+    fn name(&self) -> &str {
+        "fake reader"
+    }
+
+    fn connstring(&self) -> &ConnectionString {
+        &self.connstring
+    }
+
+    fn caps(&self) -> DeviceCaps {
+        DeviceCaps::SET_PROPERTY_BOOL
+            | DeviceCaps::SUPPORTED_MODULATIONS
+            | DeviceCaps::SUPPORTED_BAUD_RATES
+            | DeviceCaps::INITIATOR_INIT
+            | DeviceCaps::SELECT_PASSIVE_TARGET
+            | DeviceCaps::DESELECT_TARGET
+            | DeviceCaps::IDLE
+    }
+}
+
+impl InfoBackend for FakeReader {}
+
+impl PropertyBackend for FakeReader {
+    fn set_property_bool(&mut self, _property: Property, _enable: bool) -> Result<(), Error> {
+        self.transport.exchange();
+        Ok(())
+    }
+
+    fn set_property_int(&mut self, _property: Property, _value: i32) -> Result<(), Error> {
+        Ok(())
+    }
+
+    fn supported_modulations(&mut self, _mode: Mode) -> Result<Vec<ModulationType>, Error> {
+        Ok(vec![ModulationType::Iso14443A])
+    }
+
+    fn supported_baud_rates(
+        &mut self,
+        _mode: Mode,
+        _modulation_type: ModulationType,
+    ) -> Result<Vec<BaudRate>, Error> {
+        Ok(vec![BaudRate::Br106])
+    }
+}
+
+impl InitiatorBackend for FakeReader {
+    fn initiator_init_driver(&mut self) -> Result<i32, Error> {
+        self.transport.exchange();
+        Ok(0)
+    }
+
+    // No card in the field: one InListPassiveTarget that finds nothing.
+    fn select_passive_target_driver(
+        &mut self,
+        _nm: Modulation,
+        _init_data: &[u8],
+    ) -> Result<Option<Target>, Error> {
+        self.transport.exchange();
+        Ok(None)
+    }
+
+    fn deselect_target_driver(&mut self) -> Result<(), Error> {
+        self.transport.exchange();
+        Ok(())
+    }
+
+    fn idle_driver(&mut self) -> Result<(), Error> {
+        self.transport.exchange();
+        Ok(())
+    }
+
+    fn reset_session_driver(&mut self) -> Result<(), Error> {
+        Ok(())
+    }
+}
+
+impl TargetBackend for FakeReader {}
+
+impl Pn53xBackend for FakeReader {}
+
+// A claimed port cannot be opened again, so scans skip it just as the serial
+// drivers skip a port another handle holds locked.
+struct FakeReaderDriver {
+    claimed: Arc<Mutex<HashSet<String>>>,
+}
+
+impl FakeReaderDriver {
+    fn connstrings() -> impl Iterator<Item = ConnectionString> {
+        (0..READERS).map(|index| ConnectionString::new(format!("fake:reader{index}")).unwrap())
+    }
+}
+
+impl Driver for FakeReaderDriver {
+    fn name(&self) -> &str {
+        "fake"
+    }
+
+    fn scan_type(&self) -> ScanType {
+        ScanType::NotIntrusive
+    }
+
+    fn scan(&self, _context: &Context) -> Result<Vec<DiscoveredDevice>, Error> {
+        let mut found = Vec::new();
+        for connstring in Self::connstrings() {
+            if self.claimed.lock().unwrap().contains(connstring.as_str()) {
+                continue;
+            }
+            // Probing a port means claiming it and asking for the firmware.
+            let mut transport = FakeTransport::claim();
+            transport.exchange();
+            found.push(self.describe_discovered("fake reader".into(), connstring, None));
+        }
+        Ok(found)
+    }
+
+    fn open(
+        &self,
+        _context: &Context,
+        connstring: &ConnectionString,
+    ) -> Result<Box<dyn DeviceHandle>, Error> {
+        if !self
+            .claimed
+            .lock()
+            .unwrap()
+            .insert(connstring.as_str().to_string())
+        {
+            return Err(Error::DriverOpenFailed("port already claimed".into()));
+        }
+        let mut transport = FakeTransport::claim();
+        // SAMConfiguration, then GetFirmwareVersion.
+        transport.exchange();
+        transport.exchange();
+        Ok(Box::new(FakeReader {
+            connstring: connstring.clone(),
+            transport,
+            claimed: Arc::clone(&self.claimed),
+        }))
+    }
+}
+
+fn access_storm(device_pool_size: u32) -> Duration {
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(Box::new(FakeReaderDriver {
+        claimed: Arc::new(Mutex::new(HashSet::new())),
+    }));
+    let context = Context::with_config(ContextConfig {
+        device_pool_size,
+        ..ContextConfig::default()
+    });
+    let nm = Modulation {
+        modulation_type: ModulationType::Iso14443A,
+        baud_rate: BaudRate::Br106,
+    };
+
+    let reference_count = registry.list_devices(&context).unwrap().len();
+    assert_eq!(reference_count, READERS);
+
+    let started = Instant::now();
+    for _ in 0..NTESTS {
+        let devices = registry.list_devices(&context).unwrap();
+        assert_eq!(devices.len(), reference_count, "device count");
+
+        for discovered in devices {
+            let mut device = registry
+                .open(&context, Some(&discovered.connstring))
+                .expect("open");
+            let mut initiator = device.passive_scan_ops().expect("passive_scan_ops");
+            assert_eq!(initiator.init().expect("initiator_init"), 0);
+            initiator
+                .list_passive_targets(nm, MAX_TARGET_COUNT)
+                .expect("list_passive_targets");
+            registry.park(&context, device.into_handle());
+        }
+    }
+    let elapsed = started.elapsed();
+    registry.drain_device_pool();
+    elapsed
+}
+
+fn main() {
+    let cycles = (NTESTS * READERS) as f64;
+    let plain = access_storm(0);
+    let pooled = access_storm(READERS as u32);
+
+    let per_cycle = |elapsed: Duration| elapsed.as_secs_f64() * 1e6 / cycles;
+    println!(
+        "open/close cycles:            {:>10.1} us/cycle",
+        per_cycle(plain)
+    );
+    println!(
+        "pooled open/close cycles:     {:>10.1} us/cycle",
+        per_cycle(pooled)
+    );
+    println!(
+        "speedup:                      {:>10.2}x",
+        plain.as_secs_f64() / pooled.as_secs_f64()
+    );
+}
@@ -16,6 +16,7 @@ const MAX_CONFIG_LINE_BYTES: usize = 8192;
 const CONFIG_MAX_DEVICES_MESSAGE: &str = "Configuration exceeded maximum user-defined devices.";
 const DEFAULT_NON_WINDOWS_CONFDIR: &str = "/usr/local/etc/nfc";
 const DEFAULT_WINDOWS_CONFDIR: &str = "./config";
+const DEFAULT_DRIVER_SCAN_BUDGET_MS: u32 = 2000;
 
 #[derive(Clone, Debug, Eq, PartialEq)]
 enum ConfRoot {
@@ -41,6 +42,28 @@ pub struct ContextConfig {
     pub allow_intrusive_scan: bool,
     pub log_level: u32,
     pub user_defined_devices: Vec<UserDefinedDevice>,
+    /// Scan every driver on its own worker thread when listing devices.
+    pub parallel_scan: bool,
+    /// Time a driver may spend scanning before it is asked to stop and
+    /// reported as timed out; what it found is still listed. Sequential scans
+    /// count it from each driver's start. Zero waits for every driver.
+    pub driver_scan_budget_ms: u32,
+    /// How long a device listing may be reused by later scans and default
+    /// opens. Zero disables the cache.
+    pub scan_cache_ttl_ms: u32,
+    /// Remember chip type and firmware per device node so that reopening a
+    /// known reader skips the firmware probe.
+    pub chip_identity_cache: bool,
+    /// Number of closed devices kept open for reuse by a later open of the
+    /// same connection string; 0 disables the pool.
+    pub device_pool_size: u32,
+    /// Fastest rate, in baud, a PN532 UART reader is switched to after it
+    /// has been opened; 0 keeps the connstring's rate.
+    pub uart_max_speed: u32,
+    /// Put serial readers in low-latency mode: the driver asks the tty for
+    /// ASYNC_LOW_LATENCY and serves each wakeup with one read, without
+    /// querying FIONREAD first.
+    pub uart_low_latency: bool,
 }
 
 impl Default for ContextConfig {
@@ -50,6 +73,13 @@ impl Default for ContextConfig {
             allow_intrusive_scan: false,
             log_level: if cfg!(libnfc_debug) { 3 } else { 1 },
             user_defined_devices: Vec::new(),
+            parallel_scan: false,
+            driver_scan_budget_ms: DEFAULT_DRIVER_SCAN_BUDGET_MS,
+            scan_cache_ttl_ms: 0,
+            chip_identity_cache: false,
+            device_pool_size: 0,
+            uart_max_speed: 0,
+            uart_low_latency: false,
         }
     }
 }
@@ -193,6 +223,13 @@ pub(crate) struct ContextConfigSource {
     pub allow_intrusive_scan: Option<bool>,
     pub log_level: Option<u32>,
     pub user_defined_devices: Vec<UserDefinedDevice>,
+    pub parallel_scan: Option<bool>,
+    pub driver_scan_budget_ms: Option<u32>,
+    pub scan_cache_ttl_ms: Option<u32>,
+    pub chip_identity_cache: Option<bool>,
+    pub device_pool_size: Option<u32>,
+    pub uart_max_speed: Option<u32>,
+    pub uart_low_latency: Option<bool>,
 }
 
 #[derive(Clone, Copy, Debug, Default, Eq, PartialEq)]
@@ -226,6 +263,13 @@ impl ContextConfigBuilder {
             allow_intrusive_scan,
             log_level,
             user_defined_devices,
+            parallel_scan,
+            driver_scan_budget_ms,
+            scan_cache_ttl_ms,
+            chip_identity_cache,
+            device_pool_size,
+            uart_max_speed,
+            uart_low_latency,
         } = source;
 
         if let Some(value) = allow_autoscan {
@@ -240,6 +284,34 @@ impl ContextConfigBuilder {
             self.config.log_level = value;
         }
 
+        if let Some(value) = parallel_scan {
+            self.config.parallel_scan = value;
+        }
+
+        if let Some(value) = driver_scan_budget_ms {
+            self.config.driver_scan_budget_ms = value;
+        }
+
+        if let Some(value) = scan_cache_ttl_ms {
+            self.config.scan_cache_ttl_ms = value;
+        }
+
+        if let Some(value) = chip_identity_cache {
+            self.config.chip_identity_cache = value;
+        }
+
+        if let Some(value) = device_pool_size {
+            self.config.device_pool_size = value;
+        }
+
+        if let Some(value) = uart_max_speed {
+            self.config.uart_max_speed = value;
+        }
+
+        if let Some(value) = uart_low_latency {
+            self.config.uart_low_latency = value;
+        }
+
         self.config
             .user_defined_devices
             .extend(user_defined_devices);
@@ -340,6 +412,13 @@ struct ParsedConfigSource {
     allow_intrusive_scan: Option<bool>,
     log_level: Option<u32>,
     user_defined_devices: Vec<UserDefinedDeviceDraft>,
+    parallel_scan: Option<bool>,
+    driver_scan_budget_ms: Option<u32>,
+    scan_cache_ttl_ms: Option<u32>,
+    chip_identity_cache: Option<bool>,
+    device_pool_size: Option<u32>,
+    uart_max_speed: Option<u32>,
+    uart_low_latency: Option<bool>,
 }
 
 impl ParsedConfigSource {
@@ -360,6 +439,13 @@ impl ParsedConfigSource {
                     })
                 })
                 .collect(),
+            parallel_scan: self.parallel_scan,
+            driver_scan_budget_ms: self.driver_scan_budget_ms,
+            scan_cache_ttl_ms: self.scan_cache_ttl_ms,
+            chip_identity_cache: self.chip_identity_cache,
+            device_pool_size: self.device_pool_size,
+            uart_max_speed: self.uart_max_speed,
+            uart_low_latency: self.uart_low_latency,
         }
     }
 }
@@ -849,6 +935,36 @@ fn apply_config_key_value(
         "log_level" => {
             context.log_level = Some(atoi_bytes(value.as_bytes()));
         }
+        "parallel_scan" => match parse_config_boolean(value) {
+            Some(value) => context.parallel_scan = Some(value),
+            None => diagnostics.push(ContextDiagnostic::config_info(format!(
+                "Ignoring invalid boolean in config line: {key} = {value}"
+            ))),
+        },
+        "driver_scan_budget_ms" => {
+            context.driver_scan_budget_ms = Some(atoi_bytes(value.as_bytes()));
+        }
+        "scan_cache_ttl_ms" => {
+            context.scan_cache_ttl_ms = Some(atoi_bytes(value.as_bytes()));
+        }
+        "chip_identity_cache" => match parse_config_boolean(value) {
+            Some(value) => context.chip_identity_cache = Some(value),
+            None => diagnostics.push(ContextDiagnostic::config_info(format!(
+                "Ignoring invalid boolean in config line: {key} = {value}"
+            ))),
+        },
+        "device_pool_size" => {
+            context.device_pool_size = Some(atoi_bytes(value.as_bytes()));
+        }
+        "uart_max_speed" => {
+            context.uart_max_speed = Some(atoi_bytes(value.as_bytes()));
+        }
+        "uart_low_latency" => match parse_config_boolean(value) {
+            Some(value) => context.uart_low_latency = Some(value),
+            None => diagnostics.push(ContextDiagnostic::config_info(format!(
+                "Ignoring invalid boolean in config line: {key} = {value}"
+            ))),
+        },
         "device.name" => {
             let device = current_device_slot(context, UserDeviceField::Name);
             device.name = Some(truncate_string(value, DEVICE_NAME_LENGTH));
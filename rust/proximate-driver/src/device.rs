@@ -61,6 +61,7 @@ fn passive_scan_view_caps() -> DeviceCaps {
         | DeviceCaps::SUPPORTED_BAUD_RATES
         | DeviceCaps::INITIATOR_INIT
         | DeviceCaps::SELECT_PASSIVE_TARGET
+        | DeviceCaps::LIST_PASSIVE_TARGETS
         | DeviceCaps::POLL_TARGET
         | DeviceCaps::DESELECT_TARGET
 }
@@ -161,6 +162,18 @@ pub trait InitiatorBackend: DeviceMeta {
         Err(Error::UnsupportedOperation("select_passive_target"))
     }
 
+    /// Selects up to `max_targets` passive targets with a single command.
+    /// Drivers may return fewer than asked for when their hardware lists
+    /// fewer targets at once; an empty list means none answered.
+    fn list_passive_targets_driver(
+        &mut self,
+        _nm: Modulation,
+        _init_data: &[u8],
+        _max_targets: usize,
+    ) -> Result<Vec<Target>, Error> {
+        Err(Error::UnsupportedOperation("list_passive_targets"))
+    }
+
     fn poll_target_driver(
         &mut self,
         _modulations: &[Modulation],
@@ -235,6 +248,12 @@ pub trait InitiatorBackend: DeviceMeta {
         Err(Error::UnsupportedOperation("idle"))
     }
 
+    /// Puts back the properties, timeouts and selection `open` handed the
+    /// device out with, before a pooled device starts a new session.
+    fn reset_session_driver(&mut self) -> Result<(), Error> {
+        Err(Error::UnsupportedOperation("reset_session"))
+    }
+
     fn powerdown_driver(&mut self) -> Result<(), Error> {
         Err(Error::UnsupportedOperation("powerdown"))
     }
@@ -940,7 +959,13 @@ mod ops {
             let previous = device.property_bool_state(Property::InfiniteSelect);
             device.set_property_bool(Property::InfiniteSelect, false)?;
 
+            let batched = max_targets > 1
+                && !modulation_requires_single_attempt(nm)
+                && device.caps().contains(DeviceCaps::LIST_PASSIVE_TARGETS);
             let result = (|| {
+                if batched {
+                    return list_passive_target_batches(device, nm, max_targets);
+                }
                 let mut targets = Vec::new();
                 while let Some(target) = select_passive_target(device, nm, None)? {
                     if targets.contains(&target) {
@@ -961,6 +986,38 @@ mod ops {
             result
         }
 
+        // Same inventory as the one-by-one loop, with each command
+        // selecting as many targets as the driver can list at once.
+        fn list_passive_target_batches<D>(
+            device: &mut D,
+            nm: Modulation,
+            max_targets: usize,
+        ) -> Result<Vec<Target>, Error>
+        where
+            D: PropertyBackend + InitiatorBackend + ?Sized,
+        {
+            validate_modulation(device, Mode::Initiator, nm)?;
+            let payload = default_initiator_payload(nm);
+            let mut targets: Vec<Target> = Vec::new();
+            loop {
+                let batch =
+                    device.list_passive_targets_driver(nm, payload, max_targets - targets.len())?;
+                if batch.is_empty() {
+                    return Ok(targets);
+                }
+                for target in batch {
+                    if targets.contains(&target) {
+                        return Ok(targets);
+                    }
+                    targets.push(target);
+                    if targets.len() >= max_targets {
+                        return Ok(targets);
+                    }
+                }
+                deselect_target(device)?;
+            }
+        }
+
         pub(crate) fn poll_target<D>(
             device: &mut D,
             modulations: &[Modulation],
@@ -1,3 +1,7 @@
+use std::sync::{Arc, Mutex, MutexGuard, mpsc};
+use std::thread;
+use std::time::{Duration, Instant};
+
 use crate::{
     ConnectionString, Context, ContextConfig, Device, DeviceCaps, DeviceHandle, DriverCaps, Error,
     ScanType,
@@ -54,6 +58,23 @@ pub trait Driver: Send + Sync {
         }
     }
     fn scan(&self, context: &Context) -> Result<Vec<DiscoveredDevice>, Error>;
+    /// Scans like `scan`, but should wind down once `deadline` passes; a
+    /// parallel scan waits for every driver to return before it does, and
+    /// keeps what a late driver found. Drivers that cannot stop early scan in
+    /// full.
+    fn scan_until(
+        &self,
+        context: &Context,
+        deadline: Option<Instant>,
+    ) -> Result<Vec<DiscoveredDevice>, Error> {
+        let _ = deadline;
+        self.scan(context)
+    }
+    /// Probes one device node that just appeared, for hotplug monitoring.
+    /// Drivers that cannot map a node to a device report nothing.
+    fn probe_node(&self, _context: &Context, _path: &str) -> Result<Vec<DiscoveredDevice>, Error> {
+        Ok(Vec::new())
+    }
     fn open(
         &self,
         context: &Context,
@@ -66,11 +87,24 @@ pub trait Driver: Send + Sync {
 pub struct ListDevicesOutcome {
     pub devices: Vec<DiscoveredDevice>,
     pub warn_manual_selection: bool,
+    pub timed_out_drivers: Vec<String>,
+}
+
+type ScanResult = Result<Vec<DiscoveredDevice>, Error>;
+
+// A listing is only reused for the configuration that produced it.
+struct CachedScan {
+    config: ContextConfig,
+    taken_at: Instant,
+    outcome: ListDevicesOutcome,
 }
 
 #[derive(Default)]
 pub struct DriverRegistry {
-    drivers: Vec<Box<dyn Driver>>,
+    drivers: Vec<Arc<dyn Driver>>,
+    scan_cache: Mutex<Option<CachedScan>>,
+    // Closed devices kept open for reuse, oldest first.
+    device_pool: Mutex<Vec<Box<dyn DeviceHandle>>>,
 }
 
 impl DriverRegistry {
@@ -79,7 +113,125 @@ impl DriverRegistry {
     }
 
     pub fn register_driver(&mut self, driver: Box<dyn Driver>) {
-        self.drivers.push(driver);
+        self.drivers.push(Arc::from(driver));
+        self.invalidate_scan_cache();
+    }
+
+    pub fn invalidate_scan_cache(&self) {
+        *self.scan_cache() = None;
+    }
+
+    fn scan_cache(&self) -> MutexGuard<'_, Option<CachedScan>> {
+        self.scan_cache
+            .lock()
+            .unwrap_or_else(|poison| poison.into_inner())
+    }
+
+    fn cached_outcome(&self, config: &ContextConfig) -> Option<ListDevicesOutcome> {
+        let ttl = Duration::from_millis(u64::from(config.scan_cache_ttl_ms));
+        self.scan_cache()
+            .as_ref()
+            .filter(|cached| cached.config == *config && cached.taken_at.elapsed() < ttl)
+            .map(|cached| cached.outcome.clone())
+    }
+
+    fn store_outcome(&self, config: &ContextConfig, outcome: &ListDevicesOutcome) {
+        *self.scan_cache() = Some(CachedScan {
+            config: config.clone(),
+            taken_at: Instant::now(),
+            outcome: outcome.clone(),
+        });
+    }
+
+    fn device_pool(&self) -> MutexGuard<'_, Vec<Box<dyn DeviceHandle>>> {
+        self.device_pool
+            .lock()
+            .unwrap_or_else(|poison| poison.into_inner())
+    }
+
+    /// Hands a closed device back for reuse by a later `open` of the same
+    /// connection string. The RF field is idled first; when pooling is off,
+    /// or the device cannot be idled, it is dropped (and so closed) instead.
+    /// A full pool gives up its oldest device.
+    pub fn park(&self, context: &Context, mut handle: Box<dyn DeviceHandle>) {
+        let capacity = context.config.device_pool_size as usize;
+        if capacity == 0
+            || !handle.caps().contains(DeviceCaps::IDLE)
+            || handle.idle_driver().is_err()
+        {
+            return;
+        }
+
+        let evicted = {
+            let mut pool = self.device_pool();
+            let evicted = if pool.len() >= capacity {
+                Some(pool.remove(0))
+            } else {
+                None
+            };
+            pool.push(handle);
+            evicted
+        };
+        drop(evicted);
+    }
+
+    /// Closes every parked device.
+    pub fn drain_device_pool(&self) {
+        let parked = std::mem::take(&mut *self.device_pool());
+        drop(parked);
+    }
+
+    #[doc(hidden)]
+    pub fn parked_device_count(&self) -> usize {
+        self.device_pool().len()
+    }
+
+    fn is_parked(&self, connstring: &ConnectionString) -> bool {
+        self.device_pool()
+            .iter()
+            .any(|handle| handle.connstring() == connstring)
+    }
+
+    // A reused device starts over from its open-time settings; one that
+    // cannot be reset is closed so that a fresh one is opened instead.
+    fn unpark(&self, connstring: &ConnectionString) -> Option<Box<dyn DeviceHandle>> {
+        let mut handle = {
+            let mut pool = self.device_pool();
+            let index = pool
+                .iter()
+                .rposition(|handle| handle.connstring() == connstring)?;
+            pool.remove(index)
+        };
+        handle.reset_session_driver().ok()?;
+        Some(handle)
+    }
+
+    // The most recently parked device `driver` opened, standing in for the
+    // scan that can no longer find it.
+    fn parked_device_of(&self, driver: &dyn Driver) -> Option<DiscoveredDevice> {
+        self.device_pool()
+            .iter()
+            .rev()
+            .find(|handle| driver.accepts_family(handle.connstring().family()))
+            .map(|handle| parked_descriptor(handle.as_ref()))
+    }
+
+    // Parked devices keep their port claimed, so drivers no longer find them
+    // when scanning; they are listed from the pool instead.
+    fn append_parked_devices(&self, devices: &mut Vec<DiscoveredDevice>) {
+        for handle in self.device_pool().iter() {
+            if devices
+                .iter()
+                .any(|device| device.connstring == *handle.connstring())
+            {
+                continue;
+            }
+            devices.push(parked_descriptor(handle.as_ref()));
+        }
+    }
+
+    fn optional_device_missing(&self, context: &Context, connstring: &ConnectionString) -> bool {
+        !self.is_parked(connstring) && self.open(context, Some(connstring)).is_err()
     }
 
     pub fn is_empty(&self) -> bool {
@@ -93,10 +245,32 @@ impl DriverRegistry {
 
     #[doc(hidden)]
     pub fn list_devices_outcome(&self, context: &Context) -> Result<ListDevicesOutcome, Error> {
+        let mut outcome = self.cached_or_scanned_outcome(context)?;
+        if context.config.allow_autoscan {
+            self.append_parked_devices(&mut outcome.devices);
+        }
+        Ok(outcome)
+    }
+
+    fn cached_or_scanned_outcome(&self, context: &Context) -> Result<ListDevicesOutcome, Error> {
+        if context.config.scan_cache_ttl_ms == 0 {
+            return self.scan_outcome(context);
+        }
+        if let Some(outcome) = self.cached_outcome(&context.config) {
+            return Ok(outcome);
+        }
+
+        let outcome = self.scan_outcome(context)?;
+        self.store_outcome(&context.config, &outcome);
+        Ok(outcome)
+    }
+
+    fn scan_outcome(&self, context: &Context) -> Result<ListDevicesOutcome, Error> {
         let mut devices = Vec::new();
 
         for configured in &context.config.user_defined_devices {
-            if configured.optional && self.open(context, Some(&configured.connstring)).is_err() {
+            if configured.optional && self.optional_device_missing(context, &configured.connstring)
+            {
                 continue;
             }
             devices.push(DiscoveredDevice {
@@ -113,24 +287,44 @@ impl DriverRegistry {
             return Ok(ListDevicesOutcome {
                 devices,
                 warn_manual_selection: context.config.user_defined_devices.is_empty(),
+                timed_out_drivers: Vec::new(),
             });
         }
 
-        for driver in self.drivers.iter().rev() {
-            if !driver.caps().contains(DriverCaps::SCAN) {
+        let scanners: Vec<&Arc<dyn Driver>> = self
+            .drivers
+            .iter()
+            .rev()
+            .filter(|driver| driver.caps().contains(DriverCaps::SCAN))
+            .filter(|driver| scan_allowed_for_driver(&context.config, driver.as_ref()))
+            .collect();
+
+        let results = if context.config.parallel_scan && scanners.len() > 1 {
+            scan_in_parallel(&scanners, context)
+        } else {
+            scanners
+                .iter()
+                .map(|driver| scan_within_budget(driver.as_ref(), context))
+                .collect()
+        };
+        let mut timed_out_drivers = Vec::new();
+        for (driver, (result, late)) in scanners.iter().zip(results) {
+            if !late {
+                devices.append(&mut result?);
                 continue;
             }
-            if !scan_allowed_for_driver(&context.config, driver.as_ref()) {
-                continue;
+            // A late scan may have been cut short, but what it found is
+            // still there; its error, if any, is likely the cut itself.
+            timed_out_drivers.push(driver.name().to_string());
+            if let Ok(mut found) = result {
+                devices.append(&mut found);
             }
-
-            let mut scanned = driver.scan(context)?;
-            devices.append(&mut scanned);
         }
 
         Ok(ListDevicesOutcome {
             devices,
             warn_manual_selection: false,
+            timed_out_drivers,
         })
     }
 
@@ -138,9 +332,43 @@ impl DriverRegistry {
         Ok(self.list_devices_outcome(context)?.devices)
     }
 
+    pub fn probe_node(
+        &self,
+        context: &Context,
+        path: &str,
+    ) -> Result<Vec<DiscoveredDevice>, Error> {
+        let mut devices = Vec::new();
+        if !context.config.allow_autoscan {
+            return Ok(devices);
+        }
+
+        for driver in self.drivers.iter().rev() {
+            if !driver.caps().contains(DriverCaps::SCAN) {
+                continue;
+            }
+            if !scan_allowed_for_driver(&context.config, driver.as_ref()) {
+                continue;
+            }
+
+            let mut probed = driver.probe_node(context, path)?;
+            devices.append(&mut probed);
+        }
+
+        Ok(devices)
+    }
+
     fn first_available_device(&self, context: &Context) -> Result<Option<DiscoveredDevice>, Error> {
+        if context.config.scan_cache_ttl_ms != 0 {
+            return Ok(self
+                .list_devices_outcome(context)?
+                .devices
+                .into_iter()
+                .next());
+        }
+
         for configured in &context.config.user_defined_devices {
-            if configured.optional && self.open(context, Some(&configured.connstring)).is_err() {
+            if configured.optional && self.optional_device_missing(context, &configured.connstring)
+            {
                 continue;
             }
             return Ok(Some(DiscoveredDevice {
@@ -165,6 +393,9 @@ impl DriverRegistry {
                 continue;
             }
 
+            if let Some(device) = self.parked_device_of(driver.as_ref()) {
+                return Ok(Some(device));
+            }
             if let Some(device) = driver.scan(context)?.into_iter().next() {
                 return Ok(Some(device));
             }
@@ -177,6 +408,37 @@ impl DriverRegistry {
         &self,
         context: &Context,
         connstring: Option<&ConnectionString>,
+    ) -> Result<Device, Error> {
+        let resolved;
+        let mut connstring = connstring;
+        if context.config.device_pool_size != 0 {
+            // Pick the default device the way an unpooled open would, so a
+            // parked device never jumps ahead of a configured one.
+            if connstring.is_none() {
+                resolved = self
+                    .first_available_device(context)?
+                    .ok_or_else(|| Error::DriverNotFound("no device available".to_string()))?
+                    .connstring;
+                connstring = Some(&resolved);
+            }
+            if let Some(handle) = connstring.and_then(|connstring| self.unpark(connstring)) {
+                let override_name =
+                    user_defined_device_name(context, handle.connstring()).map(str::to_owned);
+                return Ok(Device::new(handle, override_name));
+            }
+        }
+
+        let opened = self.open_device(context, connstring);
+        if opened.is_err() {
+            self.invalidate_scan_cache();
+        }
+        opened
+    }
+
+    fn open_device(
+        &self,
+        context: &Context,
+        connstring: Option<&ConnectionString>,
     ) -> Result<Device, Error> {
         let requested = if let Some(connstring) = connstring {
             connstring.clone()
@@ -212,6 +474,17 @@ impl DriverRegistry {
     }
 }
 
+fn parked_descriptor(handle: &dyn DeviceHandle) -> DiscoveredDevice {
+    DiscoveredDevice {
+        display_name: handle.name().to_string(),
+        connstring: handle.connstring().clone(),
+        caps: Some(handle.caps()),
+        scan_type: ScanType::NotIntrusive,
+        exclusive: false,
+        origin: DeviceOrigin::Driver(handle.connstring().family().to_string()),
+    }
+}
+
 fn user_defined_device_name<'a>(
     context: &'a Context,
     connstring: &ConnectionString,
@@ -224,6 +497,79 @@ fn user_defined_device_name<'a>(
         .map(|device| device.name.as_str())
 }
 
+fn scan_budget(config: &ContextConfig) -> Option<Duration> {
+    match config.driver_scan_budget_ms {
+        0 => None,
+        ms => Some(Duration::from_millis(u64::from(ms))),
+    }
+}
+
+fn is_past(deadline: Option<Instant>) -> bool {
+    deadline.is_some_and(|deadline| Instant::now() > deadline)
+}
+
+// One driver of a sequential scan, with the budget counted from its start.
+fn scan_within_budget(driver: &dyn Driver, context: &Context) -> (ScanResult, bool) {
+    let deadline = scan_budget(&context.config).map(|budget| Instant::now() + budget);
+    let result = driver.scan_until(context, deadline);
+    (result, is_past(deadline))
+}
+
+// Runs every scan on its own worker so that a slow driver cannot hold up
+// the others. Results come back indexed by position in `drivers`, each with
+// whether it came in after the budget. Late drivers are told the deadline and
+// joined before returning, so none is still holding a port once the listing
+// is handed out; what they return while being joined is kept.
+fn scan_in_parallel(drivers: &[&Arc<dyn Driver>], context: &Context) -> Vec<(ScanResult, bool)> {
+    let deadline = scan_budget(&context.config).map(|budget| Instant::now() + budget);
+    let (sender, receiver) = mpsc::channel::<(usize, ScanResult)>();
+    let mut results: Vec<Option<(ScanResult, bool)>> = drivers.iter().map(|_| None).collect();
+
+    thread::scope(|scope| {
+        let mut pending = 0usize;
+        for (index, driver) in drivers.iter().enumerate() {
+            let worker_sender = sender.clone();
+            let spawned = thread::Builder::new()
+                .name(format!("nfc-scan-{}", driver.name()))
+                .spawn_scoped(scope, move || {
+                    let _ = worker_sender.send((index, driver.scan_until(context, deadline)));
+                });
+            match spawned {
+                Ok(_) => pending += 1,
+                Err(_) => {
+                    let result = driver.scan_until(context, deadline);
+                    results[index] = Some((result, is_past(deadline)));
+                }
+            }
+        }
+        drop(sender);
+
+        while pending > 0 {
+            let received = match deadline {
+                Some(deadline) => {
+                    receiver.recv_timeout(deadline.saturating_duration_since(Instant::now()))
+                }
+                None => receiver
+                    .recv()
+                    .map_err(|_| mpsc::RecvTimeoutError::Disconnected),
+            };
+            let Ok((index, result)) = received else {
+                break;
+            };
+            results[index] = Some((result, false));
+            pending -= 1;
+        }
+    });
+
+    for (index, result) in receiver.try_iter() {
+        results[index] = Some((result, true));
+    }
+    results
+        .into_iter()
+        .map(|result| result.expect("every scan worker reports before it is joined"))
+        .collect()
+}
+
 fn scan_allowed_for_driver(context: &ContextConfig, driver: &dyn Driver) -> bool {
     match driver.scan_type() {
         ScanType::NotIntrusive => true,
@@ -3,8 +3,10 @@ use std::fs;
 use std::path::{Path, PathBuf};
 use std::process;
 use std::sync::Arc;
-use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
 use std::sync::{Mutex, OnceLock};
+use std::thread;
+use std::time::{Duration, Instant};
 
 use super::*;
 use crate::context::{ContextConfigBuilder, ContextConfigSource, ContextScalarOverrides};
@@ -24,10 +26,13 @@ struct FakeDevice {
     supported_modulations: Vec<ModulationType>,
     supported_baud_rates: Vec<BaudRate>,
     passive_targets: VecDeque<Result<Option<Target>, Error>>,
+    passive_batches: VecDeque<Vec<Target>>,
+    list_passive_limits: Vec<usize>,
     deselect_calls: usize,
     select_passive_payloads: Vec<Vec<u8>>,
     dep_results: VecDeque<Result<Option<Target>, Error>>,
     target_init_calls: usize,
+    idle_calls: usize,
 }
 
 impl Default for FakeDevice {
@@ -49,10 +54,13 @@ impl Default for FakeDevice {
             supported_modulations: Vec::new(),
             supported_baud_rates: Vec::new(),
             passive_targets: VecDeque::new(),
+            passive_batches: VecDeque::new(),
+            list_passive_limits: Vec::new(),
             deselect_calls: 0,
             select_passive_payloads: Vec::new(),
             dep_results: VecDeque::new(),
             target_init_calls: 0,
+            idle_calls: 0,
         }
     }
 }
@@ -142,6 +150,16 @@ impl InitiatorBackend for FakeDevice {
         self.passive_targets.pop_front().unwrap_or(Ok(None))
     }
 
+    fn list_passive_targets_driver(
+        &mut self,
+        _nm: Modulation,
+        _init_data: &[u8],
+        max_targets: usize,
+    ) -> Result<Vec<Target>, Error> {
+        self.list_passive_limits.push(max_targets);
+        Ok(self.passive_batches.pop_front().unwrap_or_default())
+    }
+
     fn deselect_target_driver(&mut self) -> Result<(), Error> {
         self.deselect_calls += 1;
         Ok(())
@@ -156,6 +174,16 @@ impl InitiatorBackend for FakeDevice {
     ) -> Result<Option<Target>, Error> {
         self.dep_results.pop_front().unwrap_or(Ok(None))
     }
+
+    fn idle_driver(&mut self) -> Result<(), Error> {
+        self.idle_calls += 1;
+        Ok(())
+    }
+
+    fn reset_session_driver(&mut self) -> Result<(), Error> {
+        self.property_state.clear();
+        Ok(())
+    }
 }
 
 impl TargetBackend for FakeDevice {
@@ -531,6 +559,7 @@ fn context_sources_apply_precedence_and_cap() {
                 optional: false,
             },
         ],
+        ..ContextConfigSource::default()
     });
     builder.apply_selected_device(Some(UserDefinedDevice {
         name: "selected".into(),
@@ -578,6 +607,7 @@ fn driver_registry_honors_intrusive_scan_and_usb_fallback() {
         allow_intrusive_scan: false,
         log_level: 1,
         user_defined_devices: Vec::new(),
+        ..ContextConfig::default()
     });
 
     let listed = registry.list_devices(&context).unwrap();
@@ -607,6 +637,7 @@ fn driver_registry_prefers_user_defined_name_override() {
             connstring: connstring.clone(),
             optional: false,
         }],
+        ..ContextConfig::default()
     });
 
     let mut registry = DriverRegistry::new();
@@ -756,6 +787,48 @@ fn list_passive_targets_dedupes_and_restores_infinite_select() {
     );
 }
 
+fn iso14443a_target(uid: u8) -> Target {
+    Target {
+        info: TargetInfo::Iso14443A {
+            atqa: [0x00, 0x44],
+            sak: 0x00,
+            uid: vec![0x04, uid, 0x00, 0x00, 0x00, 0x00, 0x00],
+            ats: Vec::new(),
+        },
+        ..Target::new(modulation(ModulationType::Iso14443A, BaudRate::Br106))
+    }
+}
+
+#[test]
+fn list_passive_targets_uses_batched_driver_listing_when_advertised() {
+    let mut fake = FakeDevice::new("pn53x_usb");
+    fake.caps |= DeviceCaps::LIST_PASSIVE_TARGETS;
+    fake.passive_batches
+        .push_back(vec![iso14443a_target(1), iso14443a_target(2)]);
+    fake.passive_batches.push_back(vec![iso14443a_target(3)]);
+    let mut device = Device::new(Box::new(fake), None);
+
+    let listed = device
+        .passive_scan_ops()
+        .unwrap()
+        .list_passive_targets(modulation(ModulationType::Iso14443A, BaudRate::Br106), 8)
+        .unwrap();
+    assert_eq!(
+        listed,
+        vec![
+            iso14443a_target(1),
+            iso14443a_target(2),
+            iso14443a_target(3)
+        ]
+    );
+
+    let handle: Box<dyn std::any::Any> = device.into_handle();
+    let fake = handle.downcast::<FakeDevice>().unwrap();
+    assert_eq!(fake.list_passive_limits, vec![8, 6, 5]);
+    assert_eq!(fake.deselect_calls, 2);
+    assert!(fake.select_passive_payloads.is_empty());
+}
+
 #[test]
 fn poll_dep_target_retries_timeout_and_restores_infinite_select() {
     let mut device = FakeDevice::new("pn53x_usb");
@@ -829,6 +902,7 @@ fn list_devices_outcome_warns_only_for_manual_selection_mode_without_devices() {
         allow_intrusive_scan: false,
         log_level: 1,
         user_defined_devices: Vec::new(),
+        ..ContextConfig::default()
     });
 
     let outcome = registry.list_devices_outcome(&context).unwrap();
@@ -844,6 +918,7 @@ fn list_devices_outcome_warns_only_for_manual_selection_mode_without_devices() {
             connstring: ConnectionString::new("alpha:manual").unwrap(),
             optional: false,
         }],
+        ..ContextConfig::default()
     });
 
     assert!(
@@ -918,6 +993,7 @@ fn open_without_connstring_uses_first_listed_device() {
         allow_intrusive_scan: false,
         log_level: 1,
         user_defined_devices: Vec::new(),
+        ..ContextConfig::default()
     });
 
     let device = registry.open(&context, None).unwrap();
@@ -953,6 +1029,7 @@ fn list_devices_outcome_uses_effective_driver_priority_order() {
         allow_intrusive_scan: false,
         log_level: 1,
         user_defined_devices: Vec::new(),
+        ..ContextConfig::default()
     });
 
     assert_eq!(
@@ -970,6 +1047,341 @@ fn list_devices_outcome_uses_effective_driver_priority_order() {
     );
 }
 
+struct DelayedScanDriver {
+    name: String,
+    delay: Duration,
+    result: Result<Vec<ConnectionString>, Error>,
+    finished: Arc<AtomicBool>,
+}
+
+// How long a cooperative scan takes to wind down once its deadline passes.
+const SCAN_WIND_DOWN: Duration = Duration::from_millis(30);
+
+impl Driver for DelayedScanDriver {
+    fn name(&self) -> &str {
+        &self.name
+    }
+
+    fn scan_type(&self) -> ScanType {
+        ScanType::NotIntrusive
+    }
+
+    fn scan(&self, context: &Context) -> Result<Vec<DiscoveredDevice>, Error> {
+        self.scan_until(context, None)
+    }
+
+    fn scan_until(
+        &self,
+        _context: &Context,
+        deadline: Option<Instant>,
+    ) -> Result<Vec<DiscoveredDevice>, Error> {
+        let delay = match deadline {
+            Some(deadline) => self
+                .delay
+                .min(deadline.saturating_duration_since(Instant::now()) + SCAN_WIND_DOWN),
+            None => self.delay,
+        };
+        thread::sleep(delay);
+        self.finished.store(true, Ordering::SeqCst);
+        let connstrings = self.result.clone()?;
+        Ok(connstrings
+            .into_iter()
+            .map(|connstring| {
+                self.describe_discovered(connstring.as_str().to_string(), connstring, None)
+            })
+            .collect())
+    }
+
+    fn open(
+        &self,
+        _context: &Context,
+        connstring: &ConnectionString,
+    ) -> Result<Box<dyn DeviceHandle>, Error> {
+        Ok(Box::new(FakeDevice::new(connstring.as_str())))
+    }
+}
+
+fn delayed_scan_driver(name: &str, delay_ms: u64, connstrings: &[&str]) -> Box<dyn Driver> {
+    Box::new(DelayedScanDriver {
+        name: name.into(),
+        delay: Duration::from_millis(delay_ms),
+        result: Ok(connstrings
+            .iter()
+            .map(|connstring| ConnectionString::new(*connstring).unwrap())
+            .collect()),
+        finished: Arc::default(),
+    })
+}
+
+fn parallel_scan_context(budget_ms: u32) -> Context {
+    Context::with_config(ContextConfig {
+        parallel_scan: true,
+        driver_scan_budget_ms: budget_ms,
+        ..ContextConfig::default()
+    })
+}
+
+#[test]
+fn parallel_scan_merges_results_in_driver_priority_order() {
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(delayed_scan_driver("alpha", 0, &["alpha:001"]));
+    registry.register_driver(delayed_scan_driver("beta", 60, &["beta:001", "beta:002"]));
+    registry.register_driver(delayed_scan_driver("gamma", 20, &["gamma:001"]));
+
+    let outcome = registry
+        .list_devices_outcome(&parallel_scan_context(0))
+        .unwrap();
+
+    assert!(outcome.timed_out_drivers.is_empty());
+    assert_eq!(
+        outcome
+            .devices
+            .into_iter()
+            .map(|device| device.connstring.as_str().to_string())
+            .collect::<Vec<_>>(),
+        vec!["gamma:001", "beta:001", "beta:002", "alpha:001"]
+    );
+}
+
+#[test]
+fn parallel_scan_stops_drivers_that_exceed_the_budget() {
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(delayed_scan_driver("alpha", 0, &["alpha:001"]));
+    let stuck_finished = Arc::new(AtomicBool::new(false));
+    registry.register_driver(Box::new(DelayedScanDriver {
+        name: "stuck".into(),
+        delay: Duration::from_millis(2_000),
+        result: Ok(vec![ConnectionString::new("stuck:001").unwrap()]),
+        finished: Arc::clone(&stuck_finished),
+    }));
+
+    let started = Instant::now();
+    let outcome = registry
+        .list_devices_outcome(&parallel_scan_context(50))
+        .unwrap();
+
+    assert!(started.elapsed() < Duration::from_millis(1_000));
+    // The late scan was told to stop and has returned, so it no longer holds
+    // anything the caller might open next.
+    assert!(stuck_finished.load(Ordering::SeqCst));
+    assert_eq!(outcome.timed_out_drivers, vec!["stuck".to_string()]);
+    // What it found before winding down is still listed.
+    assert_eq!(
+        outcome
+            .devices
+            .into_iter()
+            .map(|device| device.connstring.as_str().to_string())
+            .collect::<Vec<_>>(),
+        vec!["stuck:001", "alpha:001"]
+    );
+}
+
+#[test]
+fn sequential_scan_applies_the_budget_to_each_driver() {
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(delayed_scan_driver("alpha", 0, &["alpha:001"]));
+    registry.register_driver(delayed_scan_driver("stuck", 2_000, &["stuck:001"]));
+    let context = Context::with_config(ContextConfig {
+        driver_scan_budget_ms: 50,
+        ..ContextConfig::default()
+    });
+
+    let started = Instant::now();
+    let outcome = registry.list_devices_outcome(&context).unwrap();
+
+    assert!(started.elapsed() < Duration::from_millis(1_000));
+    assert_eq!(outcome.timed_out_drivers, vec!["stuck".to_string()]);
+    assert_eq!(
+        outcome
+            .devices
+            .into_iter()
+            .map(|device| device.connstring.as_str().to_string())
+            .collect::<Vec<_>>(),
+        vec!["stuck:001", "alpha:001"]
+    );
+}
+
+// Scans in full whatever the deadline: only `scan` is implemented.
+struct SlowScanDriver;
+
+impl Driver for SlowScanDriver {
+    fn name(&self) -> &str {
+        "slow"
+    }
+
+    fn scan_type(&self) -> ScanType {
+        ScanType::NotIntrusive
+    }
+
+    fn scan(&self, _context: &Context) -> Result<Vec<DiscoveredDevice>, Error> {
+        thread::sleep(Duration::from_millis(300));
+        let connstring = ConnectionString::new("slow:001").unwrap();
+        Ok(vec![self.describe_discovered(
+            connstring.as_str().to_string(),
+            connstring,
+            None,
+        )])
+    }
+
+    fn open(
+        &self,
+        _context: &Context,
+        connstring: &ConnectionString,
+    ) -> Result<Box<dyn DeviceHandle>, Error> {
+        Ok(Box::new(FakeDevice::new(connstring.as_str())))
+    }
+}
+
+#[test]
+fn parallel_scan_keeps_devices_of_a_driver_that_cannot_stop_early() {
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(delayed_scan_driver("alpha", 0, &["alpha:001"]));
+    registry.register_driver(Box::new(SlowScanDriver));
+
+    let started = Instant::now();
+    let outcome = registry
+        .list_devices_outcome(&parallel_scan_context(50))
+        .unwrap();
+    let elapsed = started.elapsed();
+
+    // The listing waits for the whole scan, and loses nothing by it.
+    assert!(elapsed >= Duration::from_millis(300), "{elapsed:?}");
+    assert!(elapsed < Duration::from_millis(1_000), "{elapsed:?}");
+    assert_eq!(outcome.timed_out_drivers, vec!["slow".to_string()]);
+    assert_eq!(
+        outcome
+            .devices
+            .into_iter()
+            .map(|device| device.connstring.as_str().to_string())
+            .collect::<Vec<_>>(),
+        vec!["slow:001", "alpha:001"]
+    );
+}
+
+#[test]
+fn parallel_scan_propagates_the_first_error_in_priority_order() {
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(Box::new(DelayedScanDriver {
+        name: "late_failure".into(),
+        delay: Duration::ZERO,
+        result: Err(Error::DriverOpenFailed("late".into())),
+        finished: Arc::default(),
+    }));
+    registry.register_driver(Box::new(DelayedScanDriver {
+        name: "early_failure".into(),
+        delay: Duration::from_millis(30),
+        result: Err(Error::DriverOpenFailed("early".into())),
+        finished: Arc::default(),
+    }));
+
+    assert!(matches!(
+        registry.list_devices_outcome(&parallel_scan_context(0)),
+        Err(Error::DriverOpenFailed(message)) if message == "early"
+    ));
+}
+
+struct CachedScanDriver {
+    scan_calls: Arc<AtomicUsize>,
+    fail_open: Arc<AtomicBool>,
+}
+
+impl Driver for CachedScanDriver {
+    fn name(&self) -> &str {
+        "cached"
+    }
+
+    fn scan_type(&self) -> ScanType {
+        ScanType::NotIntrusive
+    }
+
+    fn scan(&self, _context: &Context) -> Result<Vec<DiscoveredDevice>, Error> {
+        self.scan_calls.fetch_add(1, Ordering::SeqCst);
+        let connstring = ConnectionString::new("cached:001").unwrap();
+        Ok(vec![self.describe_discovered(
+            "cached".into(),
+            connstring,
+            None,
+        )])
+    }
+
+    fn open(
+        &self,
+        _context: &Context,
+        connstring: &ConnectionString,
+    ) -> Result<Box<dyn DeviceHandle>, Error> {
+        if self.fail_open.load(Ordering::SeqCst) {
+            return Err(Error::DriverOpenFailed("unplugged".into()));
+        }
+        Ok(Box::new(FakeDevice::new(connstring.as_str())))
+    }
+}
+
+fn cached_scan_registry() -> (DriverRegistry, Arc<AtomicUsize>, Arc<AtomicBool>) {
+    let scan_calls = Arc::new(AtomicUsize::new(0));
+    let fail_open = Arc::new(AtomicBool::new(false));
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(Box::new(CachedScanDriver {
+        scan_calls: scan_calls.clone(),
+        fail_open: fail_open.clone(),
+    }));
+    (registry, scan_calls, fail_open)
+}
+
+fn scan_cache_context(ttl_ms: u32) -> Context {
+    Context::with_config(ContextConfig {
+        scan_cache_ttl_ms: ttl_ms,
+        ..ContextConfig::default()
+    })
+}
+
+#[test]
+fn scan_cache_serves_listings_and_default_opens_within_ttl() {
+    let (registry, scan_calls, _) = cached_scan_registry();
+    let context = scan_cache_context(60_000);
+
+    assert_eq!(registry.list_devices(&context).unwrap().len(), 1);
+    assert_eq!(registry.list_devices(&context).unwrap().len(), 1);
+    let device = registry.open(&context, None).unwrap();
+    assert_eq!(device.connstring().as_str(), "cached:001");
+    assert_eq!(scan_calls.load(Ordering::SeqCst), 1);
+
+    let mut changed = context.clone();
+    changed.config.allow_intrusive_scan = true;
+    registry.list_devices(&changed).unwrap();
+    assert_eq!(scan_calls.load(Ordering::SeqCst), 2);
+
+    let expiring = scan_cache_context(1);
+    registry.list_devices(&expiring).unwrap();
+    thread::sleep(Duration::from_millis(5));
+    registry.list_devices(&expiring).unwrap();
+    assert_eq!(scan_calls.load(Ordering::SeqCst), 4);
+}
+
+#[test]
+fn scan_cache_is_disabled_by_default() {
+    let (registry, scan_calls, _) = cached_scan_registry();
+    let context = scan_cache_context(0);
+
+    registry.list_devices(&context).unwrap();
+    registry.open(&context, None).unwrap();
+    assert_eq!(scan_calls.load(Ordering::SeqCst), 2);
+}
+
+#[test]
+fn failed_open_invalidates_the_scan_cache() {
+    let (registry, scan_calls, fail_open) = cached_scan_registry();
+    let context = scan_cache_context(60_000);
+
+    registry.list_devices(&context).unwrap();
+    fail_open.store(true, Ordering::SeqCst);
+    assert!(registry.open(&context, None).is_err());
+    assert_eq!(scan_calls.load(Ordering::SeqCst), 1);
+
+    fail_open.store(false, Ordering::SeqCst);
+    registry.open(&context, None).unwrap();
+    assert_eq!(scan_calls.load(Ordering::SeqCst), 2);
+}
+
 #[test]
 fn load_from_dir_loads_config_files_and_devices_d_entries() {
     let _env_guard = env_lock().lock().unwrap();
@@ -983,6 +1395,13 @@ fn load_from_dir_loads_config_files_and_devices_d_entries() {
             "allow_autoscan = false\n",
             "allow_intrusive_scan = true\n",
             "log_level = 7\n",
+            "parallel_scan = yes\n",
+            "driver_scan_budget_ms = 150\n",
+            "scan_cache_ttl_ms = 500\n",
+            "chip_identity_cache = true\n",
+            "device_pool_size = 4\n",
+            "uart_max_speed = 921600\n",
+            "uart_low_latency = true\n",
             "device.name = \"config device\"\n",
             "device.connstring = pn532_spi:/dev/spidev0.0\n",
             "device.optional = True\n"
@@ -1003,6 +1422,13 @@ fn load_from_dir_loads_config_files_and_devices_d_entries() {
     assert!(!context.config.allow_autoscan);
     assert!(context.config.allow_intrusive_scan);
     assert_eq!(context.config.log_level, 7);
+    assert!(context.config.parallel_scan);
+    assert_eq!(context.config.driver_scan_budget_ms, 150);
+    assert_eq!(context.config.scan_cache_ttl_ms, 500);
+    assert!(context.config.chip_identity_cache);
+    assert_eq!(context.config.device_pool_size, 4);
+    assert_eq!(context.config.uart_max_speed, 921_600);
+    assert!(context.config.uart_low_latency);
     assert_eq!(context.config.user_defined_devices.len(), 2);
     assert_eq!(context.config.user_defined_devices[0].name, "config device");
     assert_eq!(
@@ -1222,3 +1648,186 @@ fn public_version_labels_and_error_messages_are_stable() {
     assert_eq!(ModulationType::Dep.label(), "D.E.P.");
     assert_eq!(device_error_message(-6), "Timeout");
 }
+
+struct PoolDriver {
+    opens: Arc<AtomicUsize>,
+    idle_capable: bool,
+}
+
+impl Driver for PoolDriver {
+    fn name(&self) -> &str {
+        "pool"
+    }
+
+    fn scan_type(&self) -> ScanType {
+        ScanType::NotIntrusive
+    }
+
+    // Every device this driver opens stays claimed, so a scan finds none.
+    fn scan(&self, _context: &Context) -> Result<Vec<DiscoveredDevice>, Error> {
+        Ok(Vec::new())
+    }
+
+    fn open(
+        &self,
+        _context: &Context,
+        connstring: &ConnectionString,
+    ) -> Result<Box<dyn DeviceHandle>, Error> {
+        self.opens.fetch_add(1, Ordering::SeqCst);
+        let mut device = FakeDevice::new(connstring.as_str());
+        if self.idle_capable {
+            device.caps |= DeviceCaps::IDLE;
+        }
+        Ok(Box::new(device))
+    }
+}
+
+fn pool_registry(idle_capable: bool) -> (DriverRegistry, Arc<AtomicUsize>) {
+    let opens = Arc::new(AtomicUsize::new(0));
+    let mut registry = DriverRegistry::new();
+    registry.register_driver(Box::new(PoolDriver {
+        opens: opens.clone(),
+        idle_capable,
+    }));
+    (registry, opens)
+}
+
+fn pool_context(size: u32) -> Context {
+    Context::with_config(ContextConfig {
+        device_pool_size: size,
+        ..ContextConfig::default()
+    })
+}
+
+fn pool_connstring(name: &str) -> ConnectionString {
+    ConnectionString::new(format!("pool:{name}")).unwrap()
+}
+
+#[test]
+fn device_pool_reuses_parked_devices_by_connstring() {
+    let (registry, opens) = pool_registry(true);
+    let context = pool_context(2);
+
+    let device = registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap();
+    registry.park(&context, device.into_handle());
+    assert_eq!(registry.parked_device_count(), 1);
+
+    let reopened = registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap();
+    assert_eq!(reopened.connstring(), &pool_connstring("a"));
+    assert_eq!(opens.load(Ordering::SeqCst), 1);
+    assert_eq!(registry.parked_device_count(), 0);
+
+    registry.park(&context, reopened.into_handle());
+    registry
+        .open(&context, Some(&pool_connstring("b")))
+        .unwrap();
+    assert_eq!(opens.load(Ordering::SeqCst), 2);
+    assert_eq!(registry.parked_device_count(), 1);
+
+    registry.drain_device_pool();
+    assert_eq!(registry.parked_device_count(), 0);
+}
+
+#[test]
+fn reused_pooled_devices_start_from_their_open_time_settings() {
+    let (registry, _) = pool_registry(true);
+    let context = pool_context(1);
+
+    let mut device = registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap();
+    device
+        .property_ops()
+        .unwrap()
+        .set_property_bool(Property::InfiniteSelect, true)
+        .unwrap();
+    registry.park(&context, device.into_handle());
+
+    let reopened = registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap()
+        .into_handle();
+    assert_eq!(reopened.property_bool_state(Property::InfiniteSelect), None);
+}
+
+#[test]
+fn pooled_default_open_keeps_the_configured_device_first() {
+    let (registry, opens) = pool_registry(true);
+    let mut context = pool_context(2);
+    context.config.user_defined_devices.push(UserDefinedDevice {
+        name: "configured".to_string(),
+        connstring: pool_connstring("b"),
+        optional: false,
+    });
+
+    let device = registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap();
+    registry.park(&context, device.into_handle());
+
+    let default = registry.open(&context, None).unwrap();
+    assert_eq!(default.connstring(), &pool_connstring("b"));
+    assert_eq!(opens.load(Ordering::SeqCst), 2);
+    assert_eq!(registry.parked_device_count(), 1);
+}
+
+#[test]
+fn device_pool_closes_devices_it_cannot_keep() {
+    let (registry, _) = pool_registry(true);
+    let device = registry
+        .open(&pool_context(0), Some(&pool_connstring("a")))
+        .unwrap();
+    registry.park(&pool_context(0), device.into_handle());
+    assert_eq!(registry.parked_device_count(), 0);
+
+    let (registry, _) = pool_registry(false);
+    let context = pool_context(2);
+    let device = registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap();
+    registry.park(&context, device.into_handle());
+    assert_eq!(registry.parked_device_count(), 0);
+}
+
+#[test]
+fn full_device_pool_evicts_the_oldest_device() {
+    let (registry, opens) = pool_registry(true);
+    let context = pool_context(1);
+
+    for name in ["a", "b"] {
+        let device = registry
+            .open(&context, Some(&pool_connstring(name)))
+            .unwrap();
+        registry.park(&context, device.into_handle());
+    }
+    assert_eq!(registry.parked_device_count(), 1);
+
+    registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap();
+    assert_eq!(opens.load(Ordering::SeqCst), 3);
+}
+
+#[test]
+fn parked_devices_stay_listed_while_their_port_is_claimed() {
+    let (registry, _) = pool_registry(true);
+    let context = pool_context(2);
+
+    let device = registry
+        .open(&context, Some(&pool_connstring("a")))
+        .unwrap();
+    assert!(registry.list_devices(&context).unwrap().is_empty());
+    registry.park(&context, device.into_handle());
+
+    let listed = registry.list_devices(&context).unwrap();
+    assert_eq!(listed.len(), 1);
+    assert_eq!(listed[0].connstring, pool_connstring("a"));
+    assert_eq!(listed[0].origin, DeviceOrigin::Driver("pool".into()));
+
+    let default = registry.open(&context, None).unwrap();
+    assert_eq!(default.connstring(), &pool_connstring("a"));
+}
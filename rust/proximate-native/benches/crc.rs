@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Throughput of the CRC_A/CRC_B kernels on frame sizes seen in raw-mode and
+// emulation traffic: short anticollision frames up to full extended frames.
+//
+//     cargo bench --manifest-path rust/Cargo.toml -p proximate-native \
+//         --bench crc
+
+use proximate_native::crc::{CrcKernel, iso14443a_crc_with, iso14443b_crc_with};
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+const FRAME_LENS: [usize; 5] = [2, 16, 64, 264, 4096];
+const MEASURE_FOR: Duration = Duration::from_millis(200);
+
+// Nanoseconds per CRC over `data`, both CRC_A and CRC_B averaged.
+fn measure(kernel: CrcKernel, data: &[u8]) -> f64 {
+    let mut iterations = 0u64;
+    let started = Instant::now();
+    while started.elapsed() < MEASURE_FOR {
+        for _ in 0..64 {
+            black_box(iso14443a_crc_with(kernel, black_box(data)));
+            black_box(iso14443b_crc_with(kernel, black_box(data)));
+        }
+        iterations += 128;
+    }
+    started.elapsed().as_secs_f64() * 1e9 / iterations as f64
+}
+
+fn main() {
+    let data: Vec<u8> = (0..4096u32)
+        .map(|index| (index.wrapping_mul(2_654_435_761) >> 24) as u8)
+        .collect();
+    println!("detected kernel: {:?}", CrcKernel::detect());
+    for len in FRAME_LENS {
+        let frame = &data[..len];
+        let reference = measure(CrcKernel::Bytewise, frame);
+        for kernel in CrcKernel::ALL {
+            if !kernel.is_available() {
+                continue;
+            }
+            let nanos = measure(kernel, frame);
+            println!(
+                "{len:>5} bytes  {:<10} {nanos:>9.1} ns/crc  {:>6.2} GB/s  {:>6.2}x",
+                format!("{kernel:?}"),
+                len as f64 / nanos,
+                reference / nanos
+            );
+        }
+    }
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Cost of interleaving parity bits into raw ISO14443A frames and taking them
+// out again, as `nfc_initiator_transceive_bits` does for every frame sent
+// with parity handling off: the grouped codec against the bit-at-a-time one
+// it replaced.
+//
+//     cargo bench --manifest-path rust/Cargo.toml -p proximate-native \
+//         --features bench_support --bench parity_frame
+
+use proximate_native::{
+    unwrap_parity_frame, unwrap_parity_frame_bitwise, wrap_parity_frame, wrap_parity_frame_bitwise,
+};
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+// SELECT with CRC, a MIFARE Classic block write with CRC, and a long frame.
+const FRAME_LENS: [usize; 3] = [9, 18, 64];
+const MEASURE_FOR: Duration = Duration::from_millis(200);
+
+type Wrap = fn(&[u8], usize, Option<&[u8]>) -> Result<Vec<u8>, proximate_driver::Error>;
+type Unwrap =
+    fn(&[u8], usize, &mut [u8], Option<&mut [u8]>) -> Result<usize, proximate_driver::Error>;
+
+fn nanos_per_call(mut call: impl FnMut()) -> f64 {
+    let mut iterations = 0u64;
+    let started = Instant::now();
+    while started.elapsed() < MEASURE_FOR {
+        for _ in 0..64 {
+            call();
+        }
+        iterations += 64;
+    }
+    started.elapsed().as_secs_f64() * 1e9 / iterations as f64
+}
+
+// Nanoseconds per wrap and per unwrap of a `len`-byte frame.
+fn measure(wrap: Wrap, unwrap: Unwrap, data: &[u8], parity: &[u8]) -> (f64, f64) {
+    let bits = data.len() * 8;
+    let frame = wrap(data, bits, Some(parity)).unwrap();
+    let frame_bits = bits + data.len();
+    let mut rx = vec![0u8; data.len()];
+    let mut rx_parity = vec![0u8; data.len()];
+    let wrap_nanos = nanos_per_call(|| {
+        black_box(wrap(black_box(data), bits, Some(black_box(parity))).unwrap());
+    });
+    let unwrap_nanos = nanos_per_call(|| {
+        black_box(unwrap(black_box(&frame), frame_bits, &mut rx, Some(&mut rx_parity)).unwrap());
+    });
+    (wrap_nanos, unwrap_nanos)
+}
+
+fn main() {
+    for len in FRAME_LENS {
+        let data: Vec<u8> = (0..len as u32)
+            .map(|index| (index.wrapping_mul(2_654_435_761) >> 24) as u8)
+            .collect();
+        let parity: Vec<u8> = data
+            .iter()
+            .map(|byte| u8::from(byte.count_ones() % 2 == 0))
+            .collect();
+        let (bitwise_wrap, bitwise_unwrap) = measure(
+            wrap_parity_frame_bitwise,
+            unwrap_parity_frame_bitwise,
+            &data,
+            &parity,
+        );
+        let (grouped_wrap, grouped_unwrap) =
+            measure(wrap_parity_frame, unwrap_parity_frame, &data, &parity);
+        println!(
+            "{len:>3} bytes  wrap   bit-at-a-time {bitwise_wrap:>7.1} ns  grouped {grouped_wrap:>7.1} ns  {:>5.2}x",
+            bitwise_wrap / grouped_wrap
+        );
+        println!(
+            "{len:>3} bytes  unwrap bit-at-a-time {bitwise_unwrap:>7.1} ns  grouped {grouped_unwrap:>7.1} ns  {:>5.2}x",
+            bitwise_unwrap / grouped_unwrap
+        );
+    }
+}
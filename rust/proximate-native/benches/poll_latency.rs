@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Measures card-detect latency of `nfc_initiator_poll_target` on a simulated
+// PN532: the time from an ISO14443A card entering the field until the poll
+// returns it. Compares the chip's InAutoPoll with the host polling loop
+// (InListPassiveTarget per modulation, then a host-side sleep per period).
+//
+//     cargo bench --manifest-path rust/Cargo.toml -p proximate-native \
+//         --features bench_support --bench poll_latency
+
+use proximate_driver::{BaudRate, Device, Modulation, ModulationType};
+use proximate_native::{SimulatedLink, simulated_pn532};
+use std::sync::Arc;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+
+const TRIALS: u32 = 40;
+const POLL_PERIOD: u8 = 1;
+// Card arrivals are spread over several polling rounds of either path.
+const ARRIVAL_SPREAD: Duration = Duration::from_millis(760);
+const LINK: SimulatedLink = SimulatedLink {
+    // One command/ACK/response round trip at 115200 baud.
+    exchange_latency: Duration::from_micros(3_000),
+    activation_time: Duration::from_micros(5_000),
+};
+
+fn modulations() -> Vec<Modulation> {
+    [
+        (ModulationType::Iso14443A, BaudRate::Br106),
+        (ModulationType::Felica, BaudRate::Br212),
+        (ModulationType::Felica, BaudRate::Br424),
+        (ModulationType::Iso14443B, BaudRate::Br106),
+        (ModulationType::Jewel, BaudRate::Br106),
+    ]
+    .into_iter()
+    .map(|(modulation_type, baud_rate)| Modulation {
+        modulation_type,
+        baud_rate,
+    })
+    .collect()
+}
+
+// Mean detect latency and host command frames per detection.
+fn detect(auto_poll: bool) -> (Duration, f64) {
+    let modulations = modulations();
+    let mut total = Duration::ZERO;
+    let mut frames = 0;
+    for trial in 0..TRIALS {
+        let offset = ARRIVAL_SPREAD * trial / TRIALS;
+        let card_at = Instant::now() + Duration::from_millis(20) + offset;
+        let exchanges = Arc::new(AtomicUsize::new(0));
+        let handle = simulated_pn532(LINK, card_at, auto_poll, Arc::clone(&exchanges));
+        let mut device = Device::from_handle(handle.expect("open"));
+        let probe_frames = exchanges.load(Ordering::Relaxed);
+        let target = device
+            .passive_scan_ops()
+            .expect("passive_scan_ops")
+            .poll_target(&modulations, 0xff, POLL_PERIOD)
+            .expect("poll_target");
+        assert!(target.is_some(), "card not detected");
+        total += card_at.elapsed();
+        frames += exchanges.load(Ordering::Relaxed) - probe_frames;
+    }
+    (total / TRIALS, frames as f64 / f64::from(TRIALS))
+}
+
+fn main() {
+    let (software, software_frames) = detect(false);
+    let (firmware, firmware_frames) = detect(true);
+
+    let millis = |latency: Duration| latency.as_secs_f64() * 1e3;
+    println!(
+        "host polling loop:  {:>8.1} ms to detect, {:>6.1} frames",
+        millis(software),
+        software_frames
+    );
+    println!(
+        "InAutoPoll:         {:>8.1} ms to detect, {:>6.1} frames",
+        millis(firmware),
+        firmware_frames
+    );
+    println!(
+        "speedup:            {:>8.2}x",
+        software.as_secs_f64() / firmware.as_secs_f64()
+    );
+}
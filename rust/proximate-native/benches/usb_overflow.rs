@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Cost of carrying the surplus of a USB bulk-IN transfer over to the next
+// read. A fake endpoint completes each PN53x command as one transfer that
+// holds the ACK and the response; the host reads the 6-byte ACK first, so
+// the response is left over and served from the overflow store. Runs the
+// USB handle's own read path, ReadOverflow over a BulkInSource, against the
+// per-endpoint HashMap of Vecs the handle used to keep.
+//
+//     cargo bench --manifest-path rust/Cargo.toml -p proximate-native \
+//         --bench usb_overflow
+
+use proximate_native::usb::{BulkInSource, ReadOverflow, UsbError};
+use std::collections::HashMap;
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+const ENDPOINT_IN: u8 = 0x84;
+const ACK_FRAME: [u8; 6] = [0x00, 0x00, 0xff, 0x00, 0xff, 0x00];
+// Response payload sizes: a status byte, a target record, a full frame.
+const RESPONSE_LENS: [usize; 3] = [3, 40, 264];
+const TRANSFER_LEN: usize = 320;
+const MEASURE_FOR: Duration = Duration::from_millis(200);
+
+// Completes every transfer with the ACK followed by one response frame.
+struct FakeEndpoint {
+    transfer: Vec<u8>,
+}
+
+impl FakeEndpoint {
+    fn new(response_len: usize) -> Self {
+        let mut transfer = ACK_FRAME.to_vec();
+        transfer.extend_from_slice(&[0x00, 0x00, 0xff, response_len.min(0xff) as u8, 0x00, 0xd5]);
+        transfer.extend((0..response_len).map(|index| index as u8));
+        transfer.extend_from_slice(&[0x00, 0x00]);
+        transfer.truncate(TRANSFER_LEN);
+        Self { transfer }
+    }
+
+    fn complete(&self, buffer: &mut Vec<u8>) -> usize {
+        buffer.clear();
+        buffer.extend_from_slice(&self.transfer);
+        buffer.len()
+    }
+}
+
+// Hands the same transfer buffer back and forth, as the handle's read
+// queue recycles its buffers.
+struct FakeBulkIn<'a> {
+    endpoint: &'a FakeEndpoint,
+    spare: Option<Vec<u8>>,
+}
+
+impl BulkInSource for FakeBulkIn<'_> {
+    type Transfer = Vec<u8>;
+
+    fn next_transfer(&mut self, _request_len: usize) -> Result<Vec<u8>, UsbError> {
+        let mut buffer = self.spare.take().unwrap_or_default();
+        self.endpoint.complete(&mut buffer);
+        Ok(buffer)
+    }
+
+    fn recycle(&mut self, transfer: Vec<u8>) {
+        self.spare = Some(transfer);
+    }
+}
+
+trait Overflow {
+    fn bulk_read(&mut self, source: &mut FakeBulkIn<'_>, out: &mut [u8]) -> usize;
+}
+
+impl Overflow for ReadOverflow {
+    fn bulk_read(&mut self, source: &mut FakeBulkIn<'_>, out: &mut [u8]) -> usize {
+        self.read(source, out).expect("surplus fits the ring")
+    }
+}
+
+// The read path UsbHandle::bulk_read had before ReadOverflow.
+struct MapOverflow(HashMap<u8, Vec<u8>>);
+
+impl MapOverflow {
+    fn take(&mut self, endpoint: u8, out: &mut [u8]) -> usize {
+        let mut copied = 0;
+        let mut remove_entry = false;
+        if let Some(overflow) = self.0.get_mut(&endpoint) {
+            copied = overflow.len().min(out.len());
+            out[..copied].copy_from_slice(&overflow[..copied]);
+            overflow.drain(..copied);
+            remove_entry = overflow.is_empty();
+        }
+        if remove_entry {
+            self.0.remove(&endpoint);
+        }
+        copied
+    }
+
+    fn stash(&mut self, endpoint: u8, data: &[u8]) {
+        self.0.entry(endpoint).or_default().extend_from_slice(data);
+    }
+}
+
+impl Overflow for MapOverflow {
+    fn bulk_read(&mut self, source: &mut FakeBulkIn<'_>, out: &mut [u8]) -> usize {
+        let copied = self.take(ENDPOINT_IN, out);
+        if copied == out.len() {
+            return copied;
+        }
+        let transfer = source.next_transfer(out.len() - copied).unwrap();
+        let copy_len = transfer.len().min(out.len() - copied);
+        out[copied..copied + copy_len].copy_from_slice(&transfer[..copy_len]);
+        self.stash(ENDPOINT_IN, &transfer[copy_len..]);
+        source.recycle(transfer);
+        copied + copy_len
+    }
+}
+
+// Nanoseconds per command: the ACK read, which completes a transfer, then
+// the response read, which the surplus serves in full.
+fn measure(overflow: &mut impl Overflow, endpoint: &FakeEndpoint) -> f64 {
+    let mut source = FakeBulkIn {
+        endpoint,
+        spare: Some(Vec::with_capacity(TRANSFER_LEN)),
+    };
+    let mut ack = [0u8; ACK_FRAME.len()];
+    let mut response = vec![0u8; endpoint.transfer.len() - ACK_FRAME.len()];
+    let mut commands = 0u64;
+    let started = Instant::now();
+    while started.elapsed() < MEASURE_FOR {
+        for _ in 0..256 {
+            black_box(overflow.bulk_read(&mut source, &mut ack));
+            let len = overflow.bulk_read(&mut source, &mut response);
+            black_box(&response[..len]);
+        }
+        commands += 256;
+    }
+    started.elapsed().as_secs_f64() * 1e9 / commands as f64
+}
+
+fn main() {
+    for response_len in RESPONSE_LENS {
+        let endpoint = FakeEndpoint::new(response_len);
+        let map = measure(&mut MapOverflow(HashMap::new()), &endpoint);
+        let ring = measure(&mut ReadOverflow::with_capacity(4096), &endpoint);
+        println!(
+            "{response_len:>4}-byte response  map {map:>7.1} ns/cmd  ring {ring:>7.1} ns/cmd  {:>5.2}x",
+            map / ring
+        );
+    }
+}
@@ -1,11 +1,25 @@
+#[path = "native_helpers/cancel.rs"]
+pub mod cancel;
+#[path = "native_helpers/crc.rs"]
+pub mod crc;
+#[cfg(target_os = "linux")]
+#[path = "native_helpers/gpio.rs"]
+pub mod gpio;
+#[path = "native_helpers/hotplug.rs"]
+pub mod hotplug;
 #[path = "native_helpers/i2c.rs"]
 pub mod i2c;
 #[cfg(any(test, feature = "nci_helper"))]
 pub mod nci;
 #[cfg(feature = "pcsc_helper")]
 pub mod pcsc;
+#[path = "native_helpers/ring.rs"]
+pub mod ring;
 #[path = "native_helpers/spi.rs"]
 pub mod spi;
+#[cfg(test)]
+#[path = "native_helpers/test_rng.rs"]
+pub(crate) mod test_rng;
 #[path = "native_helpers/uart.rs"]
 pub mod uart;
 #[cfg(feature = "usb_helper")]
@@ -15,3 +29,9 @@ pub mod usb;
 mod native;
 
 pub use native::register_builtin_drivers;
+#[cfg(feature = "bench_support")]
+#[doc(hidden)]
+pub use native::{
+    SimulatedLink, simulated_pn532, unwrap_parity_frame, unwrap_parity_frame_bitwise,
+    wrap_parity_frame, wrap_parity_frame_bitwise,
+};
@@ -4,10 +4,9 @@ use super::pn53x::{
     PN53X_ACK_FRAME, Pn53xDevice, Pn53xProfile, Pn53xTransport, build_response_frame,
     payload_from_host_frame,
 };
-use crate::usb::{UsbDeviceInfo, UsbError, UsbHandle, list_devices, strerror};
-use proximate_driver::{
-    ConnectionString, Context, DeviceHandle, Driver, Error, Property, PropertyBackend, ScanType,
-};
+use crate::cancel::CancelToken;
+use crate::usb::{UsbDeviceInfo, UsbError, UsbHandle, list_devices, read_node_ids, strerror};
+use proximate_driver::{ConnectionString, Context, DeviceHandle, Driver, Error, ScanType};
 use std::collections::VecDeque;
 #[cfg(test)]
 use std::sync::{Arc, Mutex};
@@ -16,9 +15,13 @@ const DRIVER_NAME: &str = "acr122_usb";
 const PROBE_TIMEOUT_MS: i32 = 250;
 const CONTROL_TIMEOUT_MS: i32 = 1_000;
 const RESPONSE_BUFFER_LEN: usize = 255 + 10;
+// IN transfers kept posted, so a CCID reply is already in flight when the
+// host asks for it.
+const READ_QUEUE_DEPTH: usize = 2;
 
 const NFC_EIO: i32 = -1;
 const NFC_ETIMEOUT: i32 = -6;
+const NFC_EOPABORTED: i32 = -7;
 
 const ACR122_CCID_PC_TO_RDR_ICC_POWER_ON: u8 = 0x62;
 const ACR122_CCID_PC_TO_RDR_XFR_BLOCK: u8 = 0x6F;
@@ -60,6 +63,24 @@ impl Driver for Acr122UsbDriver {
         Ok(found)
     }
 
+    fn probe_node(
+        &self,
+        _context: &Context,
+        path: &str,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        let Some(ids) = read_node_ids(path) else {
+            return Ok(Vec::new());
+        };
+        let Some(name) = acr122::usb_device_name(ids.vendor_id, ids.product_id) else {
+            return Ok(Vec::new());
+        };
+        Ok(vec![self.describe_discovered(
+            name.to_string(),
+            build_usb_connstring_for(DRIVER_NAME, ids.bus_number, ids.device_address)?,
+            Some(super::pn53x::scan_caps(Pn53xProfile::acr122_usb())),
+        )])
+    }
+
     fn open(
         &self,
         _context: &Context,
@@ -81,7 +102,7 @@ impl Driver for Acr122UsbDriver {
             transport,
             PROBE_TIMEOUT_MS,
         )?;
-        device.set_property_int(Property::TimeoutCommand, CONTROL_TIMEOUT_MS)?;
+        device.set_default_timeout_command(CONTROL_TIMEOUT_MS);
         Ok(Box::new(device))
     }
 }
@@ -136,6 +157,7 @@ fn device_error(operation: &'static str, code: i32) -> Error {
 fn map_usb_error(operation: &'static str, error: UsbError) -> Error {
     let code = match error {
         UsbError::Timeout => NFC_ETIMEOUT,
+        UsbError::Interrupted => NFC_EOPABORTED,
         UsbError::Io
         | UsbError::InvalidParam
         | UsbError::Access
@@ -144,7 +166,6 @@ fn map_usb_error(operation: &'static str, error: UsbError) -> Error {
         | UsbError::Busy
         | UsbError::Overflow
         | UsbError::Pipe
-        | UsbError::Interrupted
         | UsbError::NoMem
         | UsbError::NotSupported
         | UsbError::Other => NFC_EIO,
@@ -200,6 +221,11 @@ trait Acr122UsbIo: Send {
     fn bulk_read(&mut self, buffer: &mut [u8], timeout_ms: i32) -> Result<usize, Error>;
     fn bulk_write(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error>;
 
+    /// The token that ends a pending `bulk_read` early, if the link has one.
+    fn cancel_token(&self) -> Option<&CancelToken> {
+        None
+    }
+
     fn write_ccid_message(
         &mut self,
         message_type: u8,
@@ -285,6 +311,7 @@ struct UsbCcidHandle {
     endpoint_in: u8,
     endpoint_out: u8,
     max_packet_size: u16,
+    cancel: CancelToken,
 }
 
 impl UsbCcidHandle {
@@ -305,12 +332,21 @@ impl UsbCcidHandle {
                 .set_altinterface(selection.interface_number, selection.alternate_setting)
                 .map_err(usb_open_error)?;
         }
+        let cancel = CancelToken::new()
+            .map_err(|_| Error::DriverOpenFailed("failed to create USB abort event".into()))?;
+        handle
+            .set_cancel_token(cancel.clone())
+            .map_err(usb_open_error)?;
+        handle
+            .set_read_queue(selection.endpoint_in, READ_QUEUE_DEPTH, RESPONSE_BUFFER_LEN)
+            .map_err(usb_open_error)?;
 
         Ok(Self {
             handle,
             endpoint_in: selection.endpoint_in,
             endpoint_out: selection.endpoint_out,
             max_packet_size: selection.max_packet_size,
+            cancel,
         })
     }
 }
@@ -340,6 +376,10 @@ impl Acr122UsbIo for UsbCcidHandle {
         }
         Ok(())
     }
+
+    fn cancel_token(&self) -> Option<&CancelToken> {
+        Some(&self.cancel)
+    }
 }
 
 fn parse_ccid_data_block(frame: &[u8]) -> Result<Vec<u8>, Error> {
@@ -389,6 +429,9 @@ impl<IO> Acr122UsbTransport<IO> {
 
 impl<IO: Acr122UsbIo> Pn53xTransport for Acr122UsbTransport<IO> {
     fn send(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error> {
+        if let Some(cancel) = self.io.cancel_token() {
+            cancel.reset();
+        }
         let host_payload = payload_from_host_frame(payload)?;
         let command = *host_payload
             .first()
@@ -418,8 +461,13 @@ impl<IO: Acr122UsbIo> Pn53xTransport for Acr122UsbTransport<IO> {
         Ok(payload.len())
     }
 
+    // The whole exchange runs inside `send`, so an abort ends the bulk read
+    // it is waiting in.
     fn abort_command(&mut self) -> Result<(), Error> {
         self.pending.clear();
+        if let Some(cancel) = self.io.cancel_token() {
+            cancel.cancel();
+        }
         Ok(())
     }
 }
@@ -432,6 +480,10 @@ impl Acr122UsbIo for Box<dyn Acr122UsbIo> {
     fn bulk_write(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error> {
         self.as_mut().bulk_write(payload, timeout_ms)
     }
+
+    fn cancel_token(&self) -> Option<&CancelToken> {
+        self.as_ref().cancel_token()
+    }
 }
 
 #[cfg(test)]
@@ -442,9 +494,10 @@ struct FakeUsbIoState {
 }
 
 #[cfg(test)]
-#[derive(Clone, Default)]
+#[derive(Clone)]
 struct FakeUsbIo {
     state: Arc<Mutex<FakeUsbIoState>>,
+    cancel: CancelToken,
 }
 
 #[cfg(test)]
@@ -456,6 +509,7 @@ impl FakeUsbIo {
         };
         Self {
             state: Arc::new(Mutex::new(state)),
+            cancel: CancelToken::new().unwrap(),
         }
     }
 
@@ -471,6 +525,9 @@ impl FakeUsbIo {
 #[cfg(test)]
 impl Acr122UsbIo for FakeUsbIo {
     fn bulk_read(&mut self, buffer: &mut [u8], _timeout_ms: i32) -> Result<usize, Error> {
+        if self.cancel.check().is_err() {
+            return Err(device_error("fake_bulk_read", NFC_EOPABORTED));
+        }
         let mut state = self.state.lock().expect("poisoned fake USB state");
         let payload = state
             .reads
@@ -491,6 +548,10 @@ impl Acr122UsbIo for FakeUsbIo {
             .push(payload.to_vec());
         Ok(())
     }
+
+    fn cancel_token(&self) -> Option<&CancelToken> {
+        Some(&self.cancel)
+    }
 }
 
 #[cfg(test)]
@@ -540,4 +601,19 @@ mod tests {
         assert_eq!(writes.len(), 2);
         assert_eq!(writes[1][10..15], [0xFF, 0xC0, 0x00, 0x00, 0x04]);
     }
+
+    #[test]
+    fn abort_ends_the_pending_bulk_read_until_the_next_send() {
+        let io = FakeUsbIo::with_reads([build_ccid_data_block(&[0xD5, 0x03, 0x90, 0x00])]);
+        let mut transport = Acr122UsbTransport::new(io);
+
+        transport.abort_command().unwrap();
+        let mut buffer = [0u8; 16];
+        let error = transport.io.bulk_read(&mut buffer, -1).unwrap_err();
+        assert_eq!(error, device_error("fake_bulk_read", NFC_EOPABORTED));
+
+        transport.abort_command().unwrap();
+        let frame = crate::native::pn53x::build_frame(&[0x02]).unwrap();
+        transport.send(&frame, 25).unwrap();
+    }
 }
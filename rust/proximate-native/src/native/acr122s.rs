@@ -4,18 +4,21 @@ use super::pn53x::{
     PN53X_ACK_FRAME, Pn53xDevice, Pn53xProfile, Pn53xTransport, build_response_frame,
     payload_from_host_frame,
 };
-use super::uart::{UartPort, list_candidate_paths};
-use proximate_driver::{
-    ConnectionString, Context, DeviceHandle, Driver, Error, Property, PropertyBackend, ScanType,
+use super::uart::{
+    UartPort, list_candidate_paths, probe_candidate_ports, probe_cutoff, probe_single_port,
 };
+use proximate_driver::{ConnectionString, Context, DeviceHandle, Driver, Error, ScanType};
 use std::collections::VecDeque;
 #[cfg(test)]
 use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
 
 const DRIVER_NAME: &str = "ACR122S";
 const DEFAULT_SPEED: u32 = 9_600;
 const PROBE_TIMEOUT_MS: i32 = 250;
 const CONTROL_TIMEOUT_MS: i32 = 1_000;
+// A port probe waits on one control command, bounded by CONTROL_TIMEOUT_MS.
+const PORT_PROBE_BUDGET: Duration = Duration::from_millis(1_200);
 
 const STX: u8 = 0x02;
 const ETX: u8 = 0x03;
@@ -47,46 +50,33 @@ impl Driver for Acr122sDriver {
         ScanType::Intrusive
     }
 
-    fn scan(&self, _context: &Context) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
-        let mut devices = Vec::new();
-
-        for path in list_candidate_paths() {
-            let Ok(connstring) = build_path_speed_connstring(DRIVER_NAME, &path, DEFAULT_SPEED)
-            else {
-                continue;
-            };
-
-            #[cfg(target_os = "linux")]
-            {
-                let Ok(mut port) = UartPort::open(&path, DEFAULT_SPEED) else {
-                    continue;
-                };
-                port.flush_input()?;
-                let mut seq = 0u8;
-                let Ok(firmware) = fetch_firmware_version(&mut port, &mut seq) else {
-                    continue;
-                };
-                if acr122::is_acr122s_firmware(&firmware) {
-                    devices.push(self.describe_discovered(
-                        firmware,
-                        connstring,
-                        Some(super::pn53x::scan_caps(Pn53xProfile::acr122s())),
-                    ));
-                }
-            }
+    fn scan(&self, context: &Context) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        self.scan_until(context, None)
+    }
 
-            #[cfg(not(target_os = "linux"))]
-            {
-                let _ = connstring;
-            }
-        }
+    fn scan_until(
+        &self,
+        _context: &Context,
+        deadline: Option<Instant>,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        Ok(probe_candidate_ports(
+            list_candidate_paths(),
+            probe_cutoff(deadline, PORT_PROBE_BUDGET),
+            probe_port,
+        ))
+    }
 
-        Ok(devices)
+    fn probe_node(
+        &self,
+        _context: &Context,
+        path: &str,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        Ok(probe_single_port(path, probe_port))
     }
 
     fn open(
         &self,
-        _context: &Context,
+        context: &Context,
         connstring: &ConnectionString,
     ) -> Result<Box<dyn DeviceHandle>, Error> {
         let descriptor = decode_path_speed_descriptor(connstring, DRIVER_NAME, DEFAULT_SPEED)?;
@@ -94,6 +84,9 @@ impl Driver for Acr122sDriver {
         #[cfg(target_os = "linux")]
         {
             let mut port = UartPort::open(&descriptor.path, descriptor.speed)?;
+            if context.config.uart_low_latency {
+                port.set_low_latency();
+            }
             port.flush_input()?;
 
             let mut seq = 0u8;
@@ -114,7 +107,7 @@ impl Driver for Acr122sDriver {
                 transport,
                 PROBE_TIMEOUT_MS,
             )?;
-            device.set_property_int(Property::TimeoutCommand, CONTROL_TIMEOUT_MS)?;
+            device.set_default_timeout_command(CONTROL_TIMEOUT_MS);
             Ok(Box::new(device))
         }
 
@@ -128,6 +121,31 @@ impl Driver for Acr122sDriver {
     }
 }
 
+fn probe_port(path: &str) -> Option<proximate_driver::DiscoveredDevice> {
+    let connstring = build_path_speed_connstring(DRIVER_NAME, path, DEFAULT_SPEED).ok()?;
+
+    #[cfg(target_os = "linux")]
+    {
+        let mut port = UartPort::open(path, DEFAULT_SPEED).ok()?;
+        port.flush_input().ok()?;
+        let mut seq = 0u8;
+        let firmware = fetch_firmware_version(&mut port, &mut seq).ok()?;
+        acr122::is_acr122s_firmware(&firmware).then(|| {
+            Acr122sDriver.describe_discovered(
+                firmware,
+                connstring,
+                Some(super::pn53x::scan_caps(Pn53xProfile::acr122s())),
+            )
+        })
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    {
+        let _ = connstring;
+        None
+    }
+}
+
 trait Acr122sIo: Send {
     fn flush_input(&mut self) -> Result<(), Error>;
     fn write_all(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error>;
@@ -1,13 +1,18 @@
 use super::connstring::{build_path_speed_connstring, decode_path_speed_descriptor};
-use super::pn53x::{Pn53xDevice, Pn53xProfile, Pn53xTransport, is_ack_frame};
-use super::uart::{UartPort, list_candidate_paths};
+use super::pn53x::{PN53X_ACK_FRAME, Pn53xDevice, Pn53xProfile, Pn53xTransport, is_ack_frame};
+use super::uart::{
+    UartPort, list_candidate_paths, probe_candidate_ports, probe_cutoff, probe_single_port,
+};
 use proximate_driver::{ConnectionString, Context, DeviceHandle, Driver, Error, ScanType};
 use std::borrow::Cow;
+use std::time::{Duration, Instant};
 
 const DRIVER_NAME: &str = "arygon";
 const DEFAULT_SPEED: u32 = 9_600;
 const PROBE_TIMEOUT_MS: i32 = 250;
 const CONTROL_TIMEOUT_MS: i32 = 1_000;
+// A port probe waits on one control command, bounded by CONTROL_TIMEOUT_MS.
+const PORT_PROBE_BUDGET: Duration = Duration::from_millis(1_200);
 const FIRMWARE_BUFFER_LEN: usize = 16;
 const RESET_BUFFER_LEN: usize = 10;
 
@@ -38,41 +43,33 @@ impl Driver for ArygonDriver {
         ScanType::Intrusive
     }
 
-    fn scan(&self, _context: &Context) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
-        let mut devices = Vec::new();
-
-        for path in list_candidate_paths() {
-            let Ok(connstring) = build_path_speed_connstring(DRIVER_NAME, &path, DEFAULT_SPEED)
-            else {
-                continue;
-            };
-
-            #[cfg(target_os = "linux")]
-            {
-                let Ok(mut port) = UartPort::open(&path, DEFAULT_SPEED) else {
-                    continue;
-                };
-                if reset_tama(&mut port).is_ok() {
-                    devices.push(self.describe_discovered(
-                        format!("{DRIVER_NAME}:{path}"),
-                        connstring,
-                        Some(super::pn53x::scan_caps(Pn53xProfile::arygon())),
-                    ));
-                }
-            }
+    fn scan(&self, context: &Context) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        self.scan_until(context, None)
+    }
 
-            #[cfg(not(target_os = "linux"))]
-            {
-                let _ = connstring;
-            }
-        }
+    fn scan_until(
+        &self,
+        _context: &Context,
+        deadline: Option<Instant>,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        Ok(probe_candidate_ports(
+            list_candidate_paths(),
+            probe_cutoff(deadline, PORT_PROBE_BUDGET),
+            probe_port,
+        ))
+    }
 
-        Ok(devices)
+    fn probe_node(
+        &self,
+        _context: &Context,
+        path: &str,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        Ok(probe_single_port(path, probe_port))
     }
 
     fn open(
         &self,
-        _context: &Context,
+        context: &Context,
         connstring: &ConnectionString,
     ) -> Result<Box<dyn DeviceHandle>, Error> {
         let descriptor = decode_path_speed_descriptor(connstring, DRIVER_NAME, DEFAULT_SPEED)?;
@@ -80,6 +77,9 @@ impl Driver for ArygonDriver {
         #[cfg(target_os = "linux")]
         {
             let mut port = UartPort::open(&descriptor.path, descriptor.speed)?;
+            if context.config.uart_low_latency {
+                port.set_low_latency();
+            }
             reset_tama(&mut port)?;
             let firmware = query_firmware(&mut port)?;
             let display_name = if firmware.is_empty() {
@@ -109,6 +109,27 @@ impl Driver for ArygonDriver {
     }
 }
 
+fn probe_port(path: &str) -> Option<proximate_driver::DiscoveredDevice> {
+    let connstring = build_path_speed_connstring(DRIVER_NAME, path, DEFAULT_SPEED).ok()?;
+
+    #[cfg(target_os = "linux")]
+    {
+        let mut port = UartPort::open(path, DEFAULT_SPEED).ok()?;
+        reset_tama(&mut port).ok()?;
+        Some(ArygonDriver.describe_discovered(
+            format!("{DRIVER_NAME}:{path}"),
+            connstring,
+            Some(super::pn53x::scan_caps(Pn53xProfile::arygon())),
+        ))
+    }
+
+    #[cfg(not(target_os = "linux"))]
+    {
+        let _ = connstring;
+        None
+    }
+}
+
 struct ArygonTransport {
     port: UartPort,
 }
@@ -117,16 +138,20 @@ impl ArygonTransport {
     fn new(port: UartPort) -> Self {
         Self { port }
     }
+
+    fn write_tama(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error> {
+        let mut prefixed = Vec::with_capacity(payload.len() + 1);
+        prefixed.push(PROTOCOL_TAMA);
+        prefixed.extend_from_slice(payload);
+        self.port.write_all(&prefixed, timeout_ms)
+    }
 }
 
 impl Pn53xTransport for ArygonTransport {
     fn send(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error> {
+        self.port.clear_abort();
         self.port.flush_input()?;
-
-        let mut prefixed = Vec::with_capacity(payload.len() + 1);
-        prefixed.push(PROTOCOL_TAMA);
-        prefixed.extend_from_slice(payload);
-        self.port.write_all(&prefixed, timeout_ms)?;
+        self.write_tama(payload, timeout_ms)?;
 
         let mut ack = [0u8; 16];
         let ack_len = self.port.read_frame_into(&mut ack, timeout_ms)?;
@@ -149,6 +174,13 @@ impl Pn53xTransport for ArygonTransport {
     fn abort_command(&mut self) -> Result<(), Error> {
         self.port.abort_command()
     }
+
+    // `send` waits for the chip to acknowledge the frame, and an ACK is
+    // never acknowledged.
+    fn send_ack(&mut self, timeout_ms: i32) -> Result<(), Error> {
+        self.port.clear_abort();
+        self.write_tama(&PN53X_ACK_FRAME, timeout_ms)
+    }
 }
 
 fn device_error(operation: &'static str, code: i32) -> Error {
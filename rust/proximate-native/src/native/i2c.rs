@@ -1,12 +1,10 @@
 use super::connstring::{build_path_connstring, decode_path_descriptor};
-use super::pn53x::{Pn53xDevice, Pn53xProfile, Pn53xTransport};
+use super::pn53x::{ChipIdentityKey, Pn53xDevice, Pn53xProfile, Pn53xTransport};
 use proximate_driver::{ConnectionString, Context, DeviceHandle, Driver, Error, ScanType};
-use std::sync::{
-    Arc,
-    atomic::{AtomicBool, Ordering},
-};
 use std::time::{Duration, Instant};
 
+#[cfg(target_os = "linux")]
+use crate::cancel::CancelToken;
 #[cfg(target_os = "linux")]
 use crate::i2c::{I2cHandle, I2cIoError, I2cOpenError};
 
@@ -79,7 +77,7 @@ impl Driver for Pn532I2cDriver {
 
     fn open(
         &self,
-        _context: &Context,
+        context: &Context,
         connstring: &ConnectionString,
     ) -> Result<Box<dyn DeviceHandle>, Error> {
         let descriptor = decode_path_descriptor(connstring, DRIVER_NAME)?;
@@ -87,12 +85,14 @@ impl Driver for Pn532I2cDriver {
         #[cfg(target_os = "linux")]
         {
             let transport = I2cTransport::open(&descriptor.path)?;
-            let device = Pn53xDevice::probe_with_profile(
+            let identity = ChipIdentityKey::for_path(context, connstring, &descriptor.path);
+            let device = Pn53xDevice::open_with_profile(
                 format!("PN532 I2C ({})", descriptor.path),
                 connstring.clone(),
                 Pn53xProfile::pn532(DRIVER_NAME),
                 transport,
                 PROBE_TIMEOUT_MS,
+                identity,
             )?;
             return Ok(Box::new(device));
         }
@@ -114,7 +114,7 @@ fn list_candidate_paths() -> Vec<String> {
 #[cfg(target_os = "linux")]
 pub struct I2cTransport {
     handle: I2cHandle,
-    abort_requested: Arc<AtomicBool>,
+    cancel: CancelToken,
     last_transaction_stop: Option<Instant>,
 }
 
@@ -133,9 +133,13 @@ impl I2cTransport {
             }
         };
 
+        let cancel = CancelToken::new().map_err(|_| {
+            Error::DriverOpenFailed(format!("failed to create abort event for {path}"))
+        })?;
+
         Ok(Self {
             handle,
-            abort_requested: Arc::new(AtomicBool::new(false)),
+            cancel,
             last_transaction_stop: None,
         })
     }
@@ -158,7 +162,7 @@ impl I2cTransport {
 #[cfg(target_os = "linux")]
 impl Pn53xTransport for I2cTransport {
     fn send(&mut self, payload: &[u8], _timeout_ms: i32) -> Result<(), Error> {
-        self.abort_requested.store(false, Ordering::SeqCst);
+        self.cancel.reset();
         let mut last_error = None;
 
         for _ in 0..PN532_SEND_RETRIES {
@@ -181,9 +185,9 @@ impl Pn53xTransport for I2cTransport {
     fn receive(&mut self, buffer: &mut [u8], timeout_ms: i32) -> Result<usize, Error> {
         let start = Instant::now();
         loop {
-            if self.abort_requested.swap(false, Ordering::SeqCst) {
-                return Err(device_error("i2c_abort", NFC_EOPABORTED));
-            }
+            self.cancel
+                .check()
+                .map_err(|_| device_error("i2c_abort", NFC_EOPABORTED))?;
 
             self.respect_bus_free_time();
             let mut scratch = vec![0u8; buffer.len() + 1];
@@ -213,12 +217,14 @@ impl Pn53xTransport for I2cTransport {
                 return Err(device_error("i2c_receive", NFC_ETIMEOUT));
             }
 
-            std::thread::sleep(Duration::from_millis(1));
+            self.cancel
+                .sleep(Duration::from_millis(1))
+                .map_err(|_| device_error("i2c_abort", NFC_EOPABORTED))?;
         }
     }
 
     fn abort_command(&mut self) -> Result<(), Error> {
-        self.abort_requested.store(true, Ordering::SeqCst);
+        self.cancel.cancel();
         Ok(())
     }
 }
@@ -53,6 +53,12 @@ mod usb;
 
 use proximate_driver::DriverRegistry;
 
+#[cfg(feature = "bench_support")]
+pub use pn53x::{
+    SimulatedLink, simulated_pn532, unwrap_parity_frame, unwrap_parity_frame_bitwise,
+    wrap_parity_frame, wrap_parity_frame_bitwise,
+};
+
 pub fn register_builtin_drivers(_registry: &mut DriverRegistry) {
     // Keep libnfc_orig's init order here. DriverRegistry walks in reverse,
     // which preserves the original effective driver precedence.
@@ -463,7 +463,9 @@ impl PropertyBackend for PcscDevice {
                     self.fail("pcsc_set_property_bool", NFC_EDEVNOTSUPP)
                 }
             }
-            Property::AcceptInvalidFrames | Property::AcceptMultipleFrames => {
+            Property::AcceptInvalidFrames
+            | Property::AcceptMultipleFrames
+            | Property::AutoBitRate => {
                 if enable {
                     self.fail("pcsc_set_property_bool", NFC_EDEVNOTSUPP)
                 } else {
@@ -12,6 +12,9 @@ mod core;
 mod crc_bits;
 mod device;
 mod frame;
+mod identity;
+#[cfg(feature = "bench_support")]
+mod simulator;
 mod target_decode;
 #[cfg(test)]
 mod tests;
@@ -34,11 +37,14 @@ const PN53X_TO_HOST_TFI: u8 = 0xD5;
 const PN53X_GET_FIRMWARE_VERSION: u8 = 0x02;
 const PN53X_READ_REGISTER: u8 = 0x06;
 const PN53X_WRITE_REGISTER: u8 = 0x08;
+const PN532_SET_SERIAL_BAUD_RATE: u8 = 0x10;
 const PN532_SAM_CONFIGURATION: u8 = 0x14;
 const PN53X_IN_DATA_EXCHANGE: u8 = 0x40;
 const PN53X_IN_COMMUNICATE_THRU: u8 = 0x42;
 const PN53X_IN_DESELECT: u8 = 0x44;
 const PN53X_IN_LIST_PASSIVE_TARGET: u8 = 0x4A;
+const PN53X_IN_PSL: u8 = 0x4E;
+const PN532_IN_AUTO_POLL: u8 = 0x60;
 const PN53X_IN_JUMP_FOR_DEP: u8 = 0x56;
 const PN53X_TG_GET_DATA: u8 = 0x86;
 const PN53X_TG_INIT_AS_TARGET: u8 = 0x8C;
@@ -46,6 +52,10 @@ const PN53X_TG_SET_DATA: u8 = 0x8E;
 const PN53X_TG_GET_INITIATOR_COMMAND: u8 = 0x88;
 const PN53X_TG_RESPONSE_TO_INITIATOR: u8 = 0x90;
 
+// MI: more information follows, in the Tg byte of InDataExchange and in the
+// status byte of its response.
+const PN53X_MORE_INFORMATION: u8 = 0x40;
+
 const PN53X_STATUS_TIMEOUT: u8 = 0x01;
 const PN53X_STATUS_CRC: u8 = 0x02;
 const PN53X_STATUS_PARITY: u8 = 0x03;
@@ -81,18 +91,29 @@ const PN53X_TARGET_MODE_ISO14443_4_PICC_ONLY: u8 = 0x04;
 const SAK_ISO14443_4_COMPLIANT: u8 = 0x20;
 const SAK_MIFARE_CLASSIC_MASK: u8 = 0x08;
 
+const PN53X_REG_CIU_FIRST: u16 = 0x6301;
 const PN53X_REG_CIU_TX_MODE: u16 = 0x6302;
+const PN53X_REG_CIU_CRC_RESULT_MSB: u16 = 0x6311;
+const PN53X_REG_CIU_CRC_RESULT_LSB: u16 = 0x6312;
 const PN53X_REG_CIU_TMODE: u16 = 0x631a;
 const PN53X_REG_CIU_TPRESCALER: u16 = 0x631b;
 const PN53X_REG_CIU_TRELOAD_VAL_HI: u16 = 0x631c;
 const PN53X_REG_CIU_TRELOAD_VAL_LO: u16 = 0x631d;
 const PN53X_REG_CIU_TCOUNTER_VAL_HI: u16 = 0x631e;
 const PN53X_REG_CIU_TCOUNTER_VAL_LO: u16 = 0x631f;
+const PN53X_REG_CIU_TEST_PIN_VALUE: u16 = 0x6324;
+const PN53X_REG_CIU_TEST_BUS: u16 = 0x6325;
+const PN53X_REG_CIU_TEST_ADC: u16 = 0x632b;
+const PN53X_REG_CIU_RF_LEVEL_DET: u16 = 0x632f;
 const PN53X_REG_CIU_COMMAND: u16 = 0x6331;
+const PN53X_REG_CIU_COMM_IRQ: u16 = 0x6334;
+const PN53X_REG_CIU_STATUS2: u16 = 0x6338;
 const PN53X_REG_CIU_FIFO_DATA: u16 = 0x6339;
 const PN53X_REG_CIU_FIFO_LEVEL: u16 = 0x633a;
 const PN53X_REG_CIU_CONTROL: u16 = 0x633c;
 const PN53X_REG_CIU_BIT_FRAMING: u16 = 0x633d;
+const PN53X_REG_CIU_COLL: u16 = 0x633e;
+const PN53X_REG_CIU_LAST: u16 = 0x633f;
 const SYMBOL_TX_CRC_ENABLE: u8 = 0x80;
 const SYMBOL_TX_FRAMING: u8 = 0x03;
 const SYMBOL_TAUTO: u8 = 0x80;
@@ -101,15 +122,29 @@ const SYMBOL_TPRESCALERLO: u8 = 0xff;
 const SYMBOL_COMMAND: u8 = 0x0f;
 const SYMBOL_COMMAND_TRANSCEIVE: u8 = 0x0c;
 const SYMBOL_FLUSH_BUFFER: u8 = 0x80;
+const SYMBOL_RX_IRQ: u8 = 0x20;
+const SYMBOL_ERR_IRQ: u8 = 0x02;
+const SYMBOL_IRQ_CLEAR_ALL: u8 = 0x7f;
 const SYMBOL_FIFO_LEVEL: u8 = 0x7f;
 const SYMBOL_START_SEND: u8 = 0x80;
 const SYMBOL_RX_LAST_BITS: u8 = 0x07;
 const SYMBOL_TX_LAST_BITS: u8 = 0x07;
 
 pub(crate) const PN53X_ACK_FRAME: [u8; 6] = [0x00, 0x00, 0xff, 0x00, 0xff, 0x00];
+// MaxTg limit of InListPassiveTarget.
+const PN53X_MAX_PASSIVE_TARGETS: usize = 2;
+const PN532_AUTO_POLL_MAX_TARGET_TYPES: usize = 15;
+const PN53X_NORMAL_FRAME_DATA_MAX_LEN: usize = 254;
 const PN53X_EXTENDED_FRAME_DATA_MAX_LEN: usize = 264;
 const PN53X_EXTENDED_FRAME_OVERHEAD: usize = 11;
-const PN532_BUFFER_LEN: usize = PN53X_EXTENDED_FRAME_DATA_MAX_LEN + PN53X_EXTENDED_FRAME_OVERHEAD;
+pub(crate) const PN532_BUFFER_LEN: usize =
+    PN53X_EXTENDED_FRAME_DATA_MAX_LEN + PN53X_EXTENDED_FRAME_OVERHEAD;
+// Serial rates SetSerialBaudRate accepts, in the order of their BR codes.
+const PN532_SERIAL_SPEEDS: [u32; 9] = [
+    9_600, 19_200, 38_400, 57_600, 115_200, 230_400, 460_800, 921_600, 1_288_000,
+];
+// Time the chip takes to reprogram its HSU after the confirming ACK.
+const PN532_SERIAL_SPEED_SETTLE: Duration = Duration::from_millis(5);
 
 pub(crate) fn scan_caps(profile: Pn53xProfile) -> DeviceCaps {
     let mut caps = DeviceCaps::INFO
@@ -119,6 +154,7 @@ pub(crate) fn scan_caps(profile: Pn53xProfile) -> DeviceCaps {
         | DeviceCaps::SUPPORTED_BAUD_RATES
         | DeviceCaps::INITIATOR_INIT
         | DeviceCaps::SELECT_PASSIVE_TARGET
+        | DeviceCaps::LIST_PASSIVE_TARGETS
         | DeviceCaps::POLL_TARGET
         | DeviceCaps::SELECT_DEP_TARGET
         | DeviceCaps::DESELECT_TARGET
@@ -150,6 +186,14 @@ use self::crc_bits::{
     bits_to_bytes_len, even_parity_bit, pn53x_unwrap_frame, pn53x_wrap_frame, raw_frame_bits_len,
     timer_last_command_byte,
 };
+#[cfg(feature = "bench_support")]
+pub use self::crc_bits::{
+    pn53x_unwrap_frame as unwrap_parity_frame,
+    pn53x_unwrap_frame_bitwise as unwrap_parity_frame_bitwise,
+    pn53x_wrap_frame as wrap_parity_frame, pn53x_wrap_frame_bitwise as wrap_parity_frame_bitwise,
+};
+#[cfg(test)]
+use self::crc_bits::{pn53x_unwrap_frame_bitwise, pn53x_wrap_frame_bitwise};
 #[allow(unused_imports)]
 pub(crate) use self::device::Pn53xDevice;
 #[allow(unused_imports)]
@@ -157,14 +201,21 @@ pub(crate) use self::frame::{
     build_frame, build_response_frame, command_from_host_frame, is_ack_frame,
     payload_from_host_frame,
 };
-use self::frame::{parse_response_frame, split_status_response};
+use self::frame::{encode_frame_into, parse_response_frame, split_status_response};
+#[allow(unused_imports)]
+pub(crate) use self::identity::ChipIdentityKey;
+#[cfg(feature = "bench_support")]
+pub use self::simulator::{SimulatedLink, simulated_pn532};
 use self::target_decode::{
     build_injump_for_dep_command, build_target_init_command, cascade_iso14443a_uid,
-    decode_activation_mode, decode_target_data, default_initiator_payload, is_iso14443_4_target,
-    nm_to_pm, parse_dep_target,
+    decode_activation_mode, decode_auto_poll_targets, decode_target_list,
+    default_initiator_payload, is_iso14443_4_target, iso_dep_bit_rate, nm_to_pm, nm_to_ptt,
+    parse_dep_target,
+};
+use self::transport::{
+    BitTransceiveRequest, is_transport_failure, pn53x_translate_status, status_code, status_error,
 };
-pub(crate) use self::transport::Pn53xTransport;
-use self::transport::{BitTransceiveRequest, pn53x_translate_status, status_code, status_error};
+pub(crate) use self::transport::{Pn53xTransport, switch_serial_speed};
 use self::types::{Pn53xFirmwareVersion, Pn53xPowerMode, Pn53xType, Pn532SamMode, PropertyState};
 #[allow(unused_imports)]
 pub(crate) use self::types::{Pn53xProfile, Pn53xUsbModel};
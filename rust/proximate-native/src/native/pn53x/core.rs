@@ -1,4 +1,6 @@
 use super::*;
+use std::ops::Range;
+use std::time::Instant;
 
 pub(crate) struct Pn53xCore {
     pub(super) chip_type: Pn53xType,
@@ -6,13 +8,28 @@ pub(crate) struct Pn53xCore {
     pub(super) power_mode: Pn53xPowerMode,
     pub(super) last_command: Option<u8>,
     pub(super) last_status_byte: u8,
-    pub(super) tx_bits: u8,
+    // TxLastBits the chip holds, or None once a failed register flush has
+    // left it unknown.
+    pub(super) tx_bits: Option<u8>,
     pub(super) timer_prescaler: u16,
+    // Values whose register updates still wait in `pending_writes`; they
+    // replace the two above only once the flush carrying them succeeds.
+    pub(super) staged_tx_bits: Option<u8>,
+    pub(super) staged_timer_prescaler: Option<u16>,
     pub(super) timeout_command_ms: i32,
     pub(super) timeout_atr_ms: i32,
     pub(super) timeout_communication_ms: i32,
     pub(super) properties: PropertyState,
     pub(super) current_target: Option<Target>,
+    // Last time the current target answered, and how long such an answer
+    // stands in for a presence probe (NP_PRESENCE_WINDOW; 0 never).
+    pub(super) target_seen_at: Option<Instant>,
+    pub(super) presence_window_ms: i32,
+    pub(super) registers: RegisterShadow,
+    pub(super) pending_writes: PendingWrites,
+    // Every command frame is encoded into, and its response received into,
+    // this one buffer; exchanges return the payload's place within it.
+    pub(super) frame: Box<[u8; PN532_BUFFER_LEN]>,
 }
 
 impl Default for Pn53xCore {
@@ -23,31 +40,176 @@ impl Default for Pn53xCore {
             power_mode: Pn53xPowerMode::LowVbat,
             last_command: None,
             last_status_byte: 0,
-            tx_bits: 0,
+            tx_bits: Some(0),
             timer_prescaler: 0,
+            staged_tx_bits: None,
+            staged_timer_prescaler: None,
             timeout_command_ms: 500,
             timeout_atr_ms: 103,
             timeout_communication_ms: 52,
             properties: PropertyState::default(),
             current_target: None,
+            target_seen_at: None,
+            presence_window_ms: 0,
+            registers: RegisterShadow::default(),
+            pending_writes: PendingWrites::default(),
+            frame: Box::new([0; PN532_BUFFER_LEN]),
         }
     }
 }
 
+/// Host-side copy of CIU configuration registers, so that read-modify-write
+/// sequences need no ReadRegister round trip. Registers the CIU updates on
+/// its own (command, IRQ and status, FIFO, CRC result, timer counter, ...)
+/// are never kept.
+#[derive(Clone, Debug)]
+pub(crate) struct RegisterShadow {
+    values: [Option<u8>; CIU_REGISTER_COUNT],
+}
+
+const CIU_REGISTER_COUNT: usize = (PN53X_REG_CIU_LAST - PN53X_REG_CIU_FIRST + 1) as usize;
+
+impl Default for RegisterShadow {
+    fn default() -> Self {
+        Self {
+            values: [None; CIU_REGISTER_COUNT],
+        }
+    }
+}
+
+impl RegisterShadow {
+    // Bits of `register` that keep the value last written to them, or None
+    // when the register is not shadowed at all.
+    fn persistent_bits(register: u16) -> Option<u8> {
+        match register {
+            PN53X_REG_CIU_CRC_RESULT_MSB
+            | PN53X_REG_CIU_CRC_RESULT_LSB
+            | PN53X_REG_CIU_TCOUNTER_VAL_HI
+            | PN53X_REG_CIU_TCOUNTER_VAL_LO
+            | PN53X_REG_CIU_TEST_PIN_VALUE
+            | PN53X_REG_CIU_TEST_BUS
+            | PN53X_REG_CIU_TEST_ADC
+            | PN53X_REG_CIU_RF_LEVEL_DET
+            | PN53X_REG_CIU_COMMAND
+            | PN53X_REG_CIU_COMM_IRQ..=PN53X_REG_CIU_FIFO_LEVEL
+            | PN53X_REG_CIU_CONTROL
+            | PN53X_REG_CIU_COLL => None,
+            // StartSend clears itself once the transmission has started.
+            PN53X_REG_CIU_BIT_FRAMING => Some(!SYMBOL_START_SEND),
+            PN53X_REG_CIU_FIRST..=PN53X_REG_CIU_LAST => Some(0xff),
+            _ => None,
+        }
+    }
+
+    fn slot(register: u16) -> usize {
+        usize::from(register - PN53X_REG_CIU_FIRST)
+    }
+
+    pub(super) fn get(&self, register: u16) -> Option<u8> {
+        Self::persistent_bits(register)?;
+        self.values[Self::slot(register)]
+    }
+
+    pub(super) fn record(&mut self, register: u16, value: u8) {
+        if let Some(bits) = Self::persistent_bits(register) {
+            self.values[Self::slot(register)] = Some(value & bits);
+        }
+    }
+
+    pub(super) fn clear(&mut self) {
+        self.values = [None; CIU_REGISTER_COUNT];
+    }
+}
+
+/// Register updates held back until the next command, so that they reach
+/// the chip in the same WriteRegister frame. Updates to one register merge,
+/// the later value winning for the bits both touch.
+#[derive(Clone, Debug, Default)]
+pub(crate) struct PendingWrites {
+    entries: Vec<PendingWrite>,
+}
+
+#[derive(Clone, Copy, Debug)]
+pub(crate) struct PendingWrite {
+    pub(super) register: u16,
+    pub(super) mask: u8,
+    pub(super) value: u8,
+}
+
+impl PendingWrites {
+    pub(super) fn queue(&mut self, register: u16, mask: u8, value: u8) {
+        match self
+            .entries
+            .iter_mut()
+            .find(|entry| entry.register == register)
+        {
+            Some(entry) => {
+                entry.value = (entry.value & !mask) | (value & mask);
+                entry.mask |= mask;
+            }
+            None => self.entries.push(PendingWrite {
+                register,
+                mask,
+                value: value & mask,
+            }),
+        }
+    }
+
+    pub(super) fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    pub(super) fn contains(&self, register: u16) -> bool {
+        self.entries.iter().any(|entry| entry.register == register)
+    }
+
+    pub(super) fn take(&mut self) -> Vec<PendingWrite> {
+        std::mem::take(&mut self.entries)
+    }
+}
+
+// Commands that leave the CIU configuration alone. Any other firmware
+// command (target selection, RF configuration, ...) may rewrite it.
+fn preserves_ciu_registers(command: u8) -> bool {
+    matches!(
+        command,
+        PN53X_READ_REGISTER
+            | PN53X_WRITE_REGISTER
+            | PN53X_GET_FIRMWARE_VERSION
+            | PN53X_IN_DATA_EXCHANGE
+            | PN53X_IN_COMMUNICATE_THRU
+            | PN53X_TG_GET_DATA
+            | PN53X_TG_SET_DATA
+            | PN53X_TG_GET_INITIATOR_COMMAND
+            | PN53X_TG_RESPONSE_TO_INITIATOR
+    )
+}
+
 impl Pn53xCore {
     fn exchange_prepared_command<T: Pn53xTransport>(
         &mut self,
         transport: &mut T,
         command: u8,
-        payload: &[u8],
+        payload: &[&[u8]],
         timeout_ms: i32,
-    ) -> Result<Vec<u8>, Error> {
-        let mut command_payload = Vec::with_capacity(payload.len() + 1);
-        command_payload.push(command);
-        command_payload.extend_from_slice(payload);
+    ) -> Result<Range<usize>, Error> {
+        let result = self.exchange_frame(transport, command, payload, timeout_ms);
+        if result.is_err() || !preserves_ciu_registers(command) {
+            self.registers.clear();
+        }
+        result
+    }
 
-        let frame = build_frame(&command_payload)?;
-        transport.send(&frame, timeout_ms)?;
+    fn exchange_frame<T: Pn53xTransport>(
+        &mut self,
+        transport: &mut T,
+        command: u8,
+        payload: &[&[u8]],
+        timeout_ms: i32,
+    ) -> Result<Range<usize>, Error> {
+        let frame = &mut self.frame[..];
+        let frame_len = encode_frame_into(frame, command, payload)?;
+        transport.send(&frame[..frame_len], timeout_ms)?;
 
         let mut ack = [0u8; PN53X_ACK_FRAME.len()];
         let ack_len = transport.receive(&mut ack, timeout_ms)?;
@@ -55,9 +217,15 @@ impl Pn53xCore {
             return Err(status_error("pn53x_wait_for_ack", NFC_EIO));
         }
 
-        let mut response = [0u8; PN532_BUFFER_LEN];
-        let response_len = transport.receive(&mut response, timeout_ms)?;
-        let payload = parse_response_frame(&response[..response_len], command)?;
+        let response_len = match transport.receive(frame, timeout_ms) {
+            // The chip is still running the command; an ACK frame cancels it.
+            Err(error) if status_code(&error) == NFC_EOPABORTED => {
+                let _ = transport.send_ack(timeout_ms);
+                return Err(error);
+            }
+            result => result?,
+        };
+        let payload = parse_response_frame(&frame[..response_len], command)?;
         self.last_command = Some(command);
         Ok(payload)
     }
@@ -73,6 +241,7 @@ impl Pn53xCore {
         }
 
         let previous_mode = self.power_mode;
+        self.registers.clear();
         transport.wake_up()?;
         self.power_mode = Pn53xPowerMode::Normal;
 
@@ -88,7 +257,7 @@ impl Pn53xCore {
             let _ = self.exchange_prepared_command(
                 transport,
                 PN532_SAM_CONFIGURATION,
-                &payload,
+                &[&payload],
                 timeout_ms,
             )?;
         }
@@ -122,10 +291,31 @@ impl Pn53xCore {
 
     pub(super) fn remember_target(&mut self, target: Target) {
         self.current_target = Some(target);
+        self.target_seen_at = Some(Instant::now());
     }
 
     pub(super) fn clear_target(&mut self) {
         self.current_target = None;
+        self.target_seen_at = None;
+    }
+
+    pub(super) fn note_target_answer(&mut self) {
+        if self.current_target.is_some() {
+            self.target_seen_at = Some(Instant::now());
+        }
+    }
+
+    pub(super) fn forget_target_answer(&mut self) {
+        self.target_seen_at = None;
+    }
+
+    // Whether the current target answered recently enough to count as
+    // present without a probe.
+    pub(super) fn target_recently_seen(&self) -> bool {
+        self.presence_window_ms > 0
+            && self.target_seen_at.is_some_and(|seen| {
+                seen.elapsed() < Duration::from_millis(self.presence_window_ms as u64)
+            })
     }
 
     pub(crate) fn set_property_bool(
@@ -133,6 +323,9 @@ impl Pn53xCore {
         property: Property,
         enable: bool,
     ) -> Result<(), Error> {
+        if property == Property::ActivateField && !enable {
+            self.forget_target_answer();
+        }
         self.properties.set(property, enable)
     }
 
@@ -141,19 +334,22 @@ impl Pn53xCore {
             Property::TimeoutCommand => self.timeout_command_ms = value,
             Property::TimeoutAtr => self.timeout_atr_ms = value,
             Property::TimeoutCom => self.timeout_communication_ms = value,
+            Property::PresenceWindow if value >= 0 => self.presence_window_ms = value,
             _ => return Err(Error::InvalidArgument("property")),
         }
         Ok(())
     }
 
+    /// Sends `command` with the concatenation of `payload` and returns where
+    /// the response payload lies in `self.frame`.
     pub(crate) fn exchange_command<T: Pn53xTransport>(
         &mut self,
         profile: Pn53xProfile,
         transport: &mut T,
         command: u8,
-        payload: &[u8],
+        payload: &[&[u8]],
         timeout_ms: i32,
-    ) -> Result<Vec<u8>, Error> {
+    ) -> Result<Range<usize>, Error> {
         self.ensure_ready(profile, transport, timeout_ms)?;
         self.exchange_prepared_command(transport, command, payload, timeout_ms)
     }
@@ -164,13 +360,14 @@ impl Pn53xCore {
         transport: &mut T,
         timeout_ms: i32,
     ) -> Result<Pn53xFirmwareVersion, Error> {
-        let payload = self.exchange_command(
+        let range = self.exchange_command(
             profile,
             transport,
             PN53X_GET_FIRMWARE_VERSION,
             &[],
             timeout_ms,
         )?;
+        let payload = &self.frame[range];
         if payload.len() < 4 {
             return Err(status_error("pn53x_get_firmware_version", NFC_EIO));
         }
@@ -1,4 +1,5 @@
 use super::*;
+use crate::crc::{iso14443a_crc, iso14443b_crc};
 
 pub(super) fn bits_to_bytes_len(bits_len: usize) -> usize {
     bits_len.div_ceil(8)
@@ -18,7 +19,138 @@ fn mirror(byte: u8) -> u8 {
     byte.reverse_bits()
 }
 
-pub(super) fn pn53x_wrap_frame(
+// On the air every data byte is followed by its parity bit, so eight data
+// bytes always fill exactly nine frame bytes. Both directions move such a
+// group at once: data byte j and its parity bit take bits 9j to 9j + 8 of a
+// little-endian 64-bit word, and only the last byte spills into a ninth.
+const GROUP_DATA_BYTES: usize = 8;
+const GROUP_FRAME_BYTES: usize = 9;
+
+fn pack_group(data: &[u8], parity: &[u8]) -> [u8; GROUP_FRAME_BYTES] {
+    let mut word = 0u64;
+    let mut spill = 0u8;
+    for (index, byte) in data.iter().enumerate() {
+        let bit = parity.get(index).map_or(0, |bit| bit & 0x01);
+        let symbol = u64::from(*byte) | u64::from(bit) << 8;
+        word |= symbol << (9 * index);
+        if index == GROUP_DATA_BYTES - 1 {
+            spill = (symbol >> 1) as u8;
+        }
+    }
+    let mut group = [0u8; GROUP_FRAME_BYTES];
+    group[..8].copy_from_slice(&word.to_le_bytes());
+    group[8] = spill;
+    group
+}
+
+fn unpack_group(group: &[u8], data: &mut [u8], parity: &mut [u8]) {
+    let mut bytes = [0u8; GROUP_FRAME_BYTES];
+    let len = group.len().min(GROUP_FRAME_BYTES);
+    bytes[..len].copy_from_slice(&group[..len]);
+    let mut word = [0u8; 8];
+    word.copy_from_slice(&bytes[..8]);
+    let word = u64::from_le_bytes(word);
+    let spill = bytes[8];
+    for (index, byte) in data.iter_mut().enumerate() {
+        *byte = if index == GROUP_DATA_BYTES - 1 {
+            (word >> 63) as u8 | spill << 1
+        } else {
+            (word >> (9 * index)) as u8
+        };
+    }
+    for (index, bit) in parity.iter_mut().take(data.len()).enumerate() {
+        *bit = if index == GROUP_DATA_BYTES - 1 {
+            spill >> 7
+        } else {
+            (word >> (9 * index + 8)) as u8 & 0x01
+        };
+    }
+}
+
+pub fn pn53x_wrap_frame(
+    tx: &[u8],
+    tx_bits_len: usize,
+    tx_parity: Option<&[u8]>,
+) -> Result<Vec<u8>, Error> {
+    if tx_bits_len == 0 {
+        return Ok(Vec::new());
+    }
+    let tx_bytes_len = bits_to_bytes_len(tx_bits_len);
+    if tx.len() < tx_bytes_len {
+        return Err(status_error("pn53x_wrap_frame", NFC_EINVARG));
+    }
+    if tx_bits_len < 9 {
+        return Ok(vec![tx[0]]);
+    }
+
+    let parity = tx_parity.ok_or(Error::InvalidArgument("tx_parity"))?;
+    let full_bytes = tx_bits_len / 8;
+    if parity.len() < full_bytes {
+        return Err(status_error("pn53x_wrap_frame", NFC_EINVARG));
+    }
+
+    let frame_bytes_len = bits_to_bytes_len(tx_bits_len + full_bytes);
+    let mut frame = vec![0u8; frame_bytes_len];
+    for ((group, data), frame_group) in tx[..tx_bytes_len]
+        .chunks(GROUP_DATA_BYTES)
+        .enumerate()
+        .zip(frame.chunks_mut(GROUP_FRAME_BYTES))
+    {
+        let parity = parity.get(group * GROUP_DATA_BYTES..).unwrap_or_default();
+        frame_group.copy_from_slice(&pack_group(data, parity)[..frame_group.len()]);
+    }
+    Ok(frame)
+}
+
+pub fn pn53x_unwrap_frame(
+    frame: &[u8],
+    frame_bits_len: usize,
+    rx: &mut [u8],
+    mut rx_parity: Option<&mut [u8]>,
+) -> Result<usize, Error> {
+    if frame_bits_len == 0 {
+        return Ok(0);
+    }
+    let frame_bytes_len = bits_to_bytes_len(frame_bits_len);
+    if frame.len() < frame_bytes_len {
+        return Err(status_error("pn53x_unwrap_frame", NFC_EIO));
+    }
+    if frame_bits_len < 9 {
+        if rx.is_empty() {
+            return Err(status_error("pn53x_unwrap_frame", NFC_EOVFLOW));
+        }
+        rx[0] = frame[0];
+        return Ok(frame_bits_len);
+    }
+
+    let rx_bits_len = frame_bits_len - (frame_bits_len / 9);
+    let rx_bytes_len = bits_to_bytes_len(rx_bits_len);
+    if rx.len() < rx_bytes_len {
+        return Err(status_error("pn53x_unwrap_frame", NFC_EOVFLOW));
+    }
+    if let Some(parity) = rx_parity.as_ref()
+        && parity.len() < rx_bits_len / 8
+    {
+        return Err(status_error("pn53x_unwrap_frame", NFC_EOVFLOW));
+    }
+
+    for (group, data) in rx[..rx_bytes_len].chunks_mut(GROUP_DATA_BYTES).enumerate() {
+        // A frame cut short after the last data bits reads as zeros.
+        let frame_group = frame.get(group * GROUP_FRAME_BYTES..).unwrap_or_default();
+        let parity = match rx_parity.as_deref_mut() {
+            Some(parity) => parity
+                .get_mut(group * GROUP_DATA_BYTES..)
+                .unwrap_or_default(),
+            None => &mut [],
+        };
+        unpack_group(frame_group, data, parity);
+    }
+    Ok(rx_bits_len)
+}
+
+// Bit-at-a-time codec the grouped one replaced, kept as its reference.
+#[cfg(any(test, feature = "bench_support"))]
+pub fn pn53x_wrap_frame_bitwise(
     tx: &[u8],
     tx_bits_len: usize,
     tx_parity: Option<&[u8]>,
@@ -72,7 +204,8 @@ pub(super) fn pn53x_wrap_frame(
     }
 }
 
-pub(super) fn pn53x_unwrap_frame(
+#[cfg(any(test, feature = "bench_support"))]
+pub fn pn53x_unwrap_frame_bitwise(
     frame: &[u8],
     frame_bits_len: usize,
     rx: &mut [u8],
@@ -131,33 +264,6 @@ pub(super) fn even_parity_bit(byte: u8) -> u8 {
     u8::from(byte.count_ones().is_multiple_of(2))
 }
 
-fn iso14443a_crc_append(data: &[u8]) -> [u8; 2] {
-    let mut crc = 0x6363u16;
-    for byte in data {
-        let mut value = *byte ^ (crc as u8);
-        value ^= value << 4;
-        crc = (crc >> 8)
-            ^ (u16::from(value) << 8)
-            ^ (u16::from(value) << 3)
-            ^ (u16::from(value) >> 4);
-    }
-    [crc as u8, (crc >> 8) as u8]
-}
-
-fn iso14443b_crc_append(data: &[u8]) -> [u8; 2] {
-    let mut crc = 0xFFFFu16;
-    for byte in data {
-        let mut value = *byte ^ (crc as u8);
-        value ^= value << 4;
-        crc = (crc >> 8)
-            ^ (u16::from(value) << 8)
-            ^ (u16::from(value) << 3)
-            ^ (u16::from(value) >> 4);
-    }
-    crc = !crc;
-    [crc as u8, (crc >> 8) as u8]
-}
-
 pub(super) fn timer_last_command_byte(tx: &[u8], txmode: Option<u8>) -> Result<u8, Error> {
     let Some(&last) = tx.last() else {
         return Err(status_error("pn53x_timer_last_byte", NFC_EINVARG));
@@ -169,8 +275,8 @@ pub(super) fn timer_last_command_byte(tx: &[u8], txmode: Option<u8>) -> Result<u
         return Ok(last);
     }
     let crc = match txmode & SYMBOL_TX_FRAMING {
-        0x00 => iso14443a_crc_append(tx),
-        0x03 => iso14443b_crc_append(tx),
+        0x00 => iso14443a_crc(tx),
+        0x03 => iso14443b_crc(tx),
         _ => return Ok(last),
     };
     Ok(crc[1])
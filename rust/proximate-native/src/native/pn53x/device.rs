@@ -1,4 +1,5 @@
 use super::*;
+use std::ops::Range;
 
 pub(crate) struct Pn53xDevice<T> {
     name: String,
@@ -7,31 +8,101 @@ pub(crate) struct Pn53xDevice<T> {
     pub(super) transport: T,
     pub(super) core: Pn53xCore,
     last_error: i32,
+    identity: Option<ChipIdentityKey>,
+    // Rate of a serial link raised by `negotiate_serial_speed`.
+    serial_speed: Option<u32>,
+    session_defaults: SessionDefaults,
+}
+
+// Host-side settings a device is opened with, put back when a pooled
+// device is reused.
+#[derive(Clone, Copy)]
+struct SessionDefaults {
+    properties: PropertyState,
+    timeout_command_ms: i32,
+    timeout_atr_ms: i32,
+    timeout_communication_ms: i32,
+    presence_window_ms: i32,
+}
+
+impl SessionDefaults {
+    fn of(core: &Pn53xCore) -> Self {
+        Self {
+            properties: core.properties,
+            timeout_command_ms: core.timeout_command_ms,
+            timeout_atr_ms: core.timeout_atr_ms,
+            timeout_communication_ms: core.timeout_communication_ms,
+            presence_window_ms: core.presence_window_ms,
+        }
+    }
+}
+
+// What a timed exchange left in the FIFO, with the RxLastBits and timer
+// counter sampled once its reception was over.
+struct TimedReception {
+    len: usize,
+    last_bits: u8,
+    counter: u16,
 }
 
 impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
     pub(crate) fn probe_with_profile(
+        name: impl Into<String>,
+        connstring: ConnectionString,
+        profile: Pn53xProfile,
+        transport: T,
+        timeout_ms: i32,
+    ) -> Result<Self, Error> {
+        Self::open_with_profile(name, connstring, profile, transport, timeout_ms, None)
+    }
+
+    /// Like `probe_with_profile`, but a chip already identified under
+    /// `identity` is restored from the cache instead of being asked for its
+    /// firmware version again.
+    pub(crate) fn open_with_profile(
         name: impl Into<String>,
         connstring: ConnectionString,
         profile: Pn53xProfile,
         mut transport: T,
         timeout_ms: i32,
+        identity: Option<ChipIdentityKey>,
     ) -> Result<Self, Error> {
         let mut core = Pn53xCore {
             power_mode: profile.initial_power_mode,
             ..Pn53xCore::default()
         };
-        core.get_firmware_version(profile, &mut transport, timeout_ms)?;
+        match identity.as_ref().and_then(identity::lookup) {
+            Some(firmware) => {
+                core.chip_type = firmware.chip_type();
+                core.firmware = Some(firmware);
+            }
+            None => {
+                let firmware = core.get_firmware_version(profile, &mut transport, timeout_ms)?;
+                if let Some(key) = &identity {
+                    identity::record(key.clone(), firmware);
+                }
+            }
+        }
         Ok(Self {
             name: name.into(),
             connstring,
             profile,
             transport,
+            session_defaults: SessionDefaults::of(&core),
             core,
             last_error: 0,
+            identity,
+            serial_speed: None,
         })
     }
 
+    /// Sets the command timeout a driver opens this device with, which a
+    /// pooled device is also reset to.
+    pub(crate) fn set_default_timeout_command(&mut self, timeout_ms: i32) {
+        self.core.timeout_command_ms = timeout_ms;
+        self.session_defaults.timeout_command_ms = timeout_ms;
+    }
+
     pub(crate) fn probe_pn532(
         name: impl Into<String>,
         connstring: ConnectionString,
@@ -47,6 +118,58 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
         )
     }
 
+    /// Raises the serial link of a PN532 opened at `speed` baud to the
+    /// fastest rate SetSerialBaudRate offers up to `max_speed`. A link that
+    /// does not answer at the new rate is taken back to `speed`; only when
+    /// the chip answers at neither rate is an error returned.
+    #[cfg_attr(not(any(test, libnfc_driver_pn532_uart)), allow(dead_code))]
+    pub(crate) fn negotiate_serial_speed(
+        &mut self,
+        speed: u32,
+        max_speed: u32,
+    ) -> Result<(), Error> {
+        if self.core.chip_type() != Pn53xType::Pn532 {
+            return Ok(());
+        }
+        let Some(&fast) = PN532_SERIAL_SPEEDS
+            .iter()
+            .rev()
+            .find(|candidate| **candidate <= max_speed && **candidate > speed)
+        else {
+            return Ok(());
+        };
+        let timeout = self.core.timeout_command_ms;
+        if switch_serial_speed(&mut self.transport, fast, timeout).is_ok()
+            && self.answers_firmware_probe(timeout)
+        {
+            self.serial_speed = Some(fast);
+            return Ok(());
+        }
+
+        // The chip switches on the host's ACK, so after a failure it may be
+        // at either rate. Look for it at the old one first, then try to send
+        // it back there from the new one.
+        if self.transport.set_line_speed(speed).is_ok() && self.answers_firmware_probe(timeout) {
+            return Ok(());
+        }
+        let result = self
+            .transport
+            .set_line_speed(fast)
+            .and_then(|()| switch_serial_speed(&mut self.transport, speed, timeout))
+            .and_then(|()| {
+                self.core
+                    .get_firmware_version(self.profile, &mut self.transport, timeout)
+                    .map(|_| ())
+            });
+        self.remember(result)
+    }
+
+    fn answers_firmware_probe(&mut self, timeout_ms: i32) -> bool {
+        self.core
+            .get_firmware_version(self.profile, &mut self.transport, timeout_ms)
+            .is_ok()
+    }
+
     #[allow(dead_code)]
     pub(crate) fn core(&self) -> &Pn53xCore {
         &self.core
@@ -55,7 +178,14 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
     fn remember<TValue>(&mut self, result: Result<TValue, Error>) -> Result<TValue, Error> {
         match &result {
             Ok(_) => self.last_error = 0,
-            Err(error) => self.last_error = status_code(error),
+            Err(error) => {
+                self.last_error = status_code(error);
+                if is_transport_failure(self.last_error)
+                    && let Some(key) = &self.identity
+                {
+                    identity::forget(key);
+                }
+            }
         }
         result
     }
@@ -83,19 +213,26 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
                 self.profile,
                 &mut self.transport,
                 PN532_SAM_CONFIGURATION,
-                &payload,
+                &[&payload],
                 timeout_ms,
             )
             .map(|_| 0);
         self.remember(result)
     }
 
-    fn exchange_raw(
+    // Runs one command and returns where its response payload lies in the
+    // core's frame buffer.
+    fn exchange_range(
         &mut self,
         command: u8,
-        payload: &[u8],
+        payload: &[&[u8]],
         timeout_ms: i32,
-    ) -> Result<Vec<u8>, Error> {
+    ) -> Result<Range<usize>, Error> {
+        if !matches!(command, PN53X_READ_REGISTER | PN53X_WRITE_REGISTER)
+            && !self.core.pending_writes.is_empty()
+        {
+            self.write_registers(&[])?;
+        }
         let result = self.core.exchange_command(
             self.profile,
             &mut self.transport,
@@ -106,23 +243,107 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
         self.remember(result)
     }
 
-    fn exchange_with_status(
+    fn exchange_raw(
         &mut self,
-        operation: &'static str,
         command: u8,
         payload: &[u8],
         timeout_ms: i32,
     ) -> Result<Vec<u8>, Error> {
-        let response = self.exchange_raw(command, payload, timeout_ms)?;
-        let (status, data) = split_status_response(command, &response)?;
+        let range = self.exchange_range(command, &[payload], timeout_ms)?;
+        Ok(self.core.frame[range].to_vec())
+    }
+
+    // Like `exchange_with_status`, but the data is borrowed from the frame
+    // buffer and stays valid until the next exchange.
+    fn exchange_with_status_in_place(
+        &mut self,
+        operation: &'static str,
+        command: u8,
+        payload: &[&[u8]],
+        timeout_ms: i32,
+    ) -> Result<&[u8], Error> {
+        self.exchange_with_status_flags(operation, command, payload, timeout_ms)
+            .map(|(_, data)| data)
+    }
+
+    // Also reports whether the status byte carried the MI bit, i.e. whether
+    // the target has more data to send.
+    fn exchange_with_status_flags(
+        &mut self,
+        operation: &'static str,
+        command: u8,
+        payload: &[&[u8]],
+        timeout_ms: i32,
+    ) -> Result<(bool, &[u8]), Error> {
+        let range = self.exchange_range(command, payload, timeout_ms)?;
+        let response = &self.core.frame[range];
+        let more = response
+            .first()
+            .is_some_and(|flags| flags & PN53X_MORE_INFORMATION != 0);
+        let (status, data) = split_status_response(command, response)?;
         self.core.last_status_byte = status;
         let mapped = pn53x_translate_status(status);
         if mapped < 0 {
+            self.core.registers.clear();
             self.last_error = mapped;
             return Err(status_error(operation, mapped));
         }
         self.last_error = 0;
-        Ok(data)
+        Ok((more, data))
+    }
+
+    fn exchange_with_status(
+        &mut self,
+        operation: &'static str,
+        command: u8,
+        payload: &[u8],
+        timeout_ms: i32,
+    ) -> Result<Vec<u8>, Error> {
+        self.exchange_with_status_in_place(operation, command, &[payload], timeout_ms)
+            .map(<[u8]>::to_vec)
+    }
+
+    // InDataExchange with ISO-DEP chaining done by the chip: `tx` goes out in
+    // the largest chunks one frame holds, every chunk but the last flagged
+    // MI, and response chunks flagged MI are fetched until the last one.
+    fn in_data_exchange_chained(
+        &mut self,
+        tx: &[u8],
+        rx: &mut [u8],
+        timeout: i32,
+    ) -> Result<usize, Error> {
+        const OPERATION: &str = "transceive_bytes";
+        const TG: u8 = 0x01;
+        // The command byte and Tg share the frame with the data.
+        let chunk_len = self.core.chip_type().max_frame_payload_len() - 2;
+        let mut chunks = tx.chunks(chunk_len);
+        let mut chunk = chunks.next().unwrap_or_default();
+        for next in chunks {
+            let tg = TG | PN53X_MORE_INFORMATION;
+            self.exchange_with_status_flags(
+                OPERATION,
+                PN53X_IN_DATA_EXCHANGE,
+                &[&[tg], chunk],
+                timeout,
+            )?;
+            chunk = next;
+        }
+
+        let mut written = 0;
+        let mut payload: [&[u8]; 2] = [&[TG], chunk];
+        loop {
+            let (more, data) = self.exchange_with_status_flags(
+                OPERATION,
+                PN53X_IN_DATA_EXCHANGE,
+                &payload,
+                timeout,
+            )?;
+            written += Self::copy_into(OPERATION, data, &mut rx[written..])?;
+            if !more {
+                return Ok(written);
+            }
+            payload = [&[TG], &[]];
+        }
     }
 
     fn copy_into(
@@ -156,6 +377,19 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
         if registers.is_empty() {
             return Ok(Vec::new());
         }
+        if registers
+            .iter()
+            .any(|register| self.core.pending_writes.contains(*register))
+        {
+            self.write_registers(&[])?;
+        }
+        if let Some(values) = registers
+            .iter()
+            .map(|register| self.core.registers.get(*register))
+            .collect::<Option<Vec<u8>>>()
+        {
+            return Ok(values);
+        }
         let mut payload = Vec::with_capacity(registers.len() * 2);
         for register in registers {
             payload.push((register >> 8) as u8);
@@ -168,22 +402,55 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
             self.core.last_status_byte = status;
             let mapped = pn53x_translate_status(status);
             if mapped < 0 {
+                self.core.registers.clear();
                 return self.remember(Err(status_error("read_register", mapped)));
             }
             data
         } else {
-            response
+            &response
         };
         if values.len() < registers.len() {
+            self.core.registers.clear();
             return self.remember(Err(status_error("read_register", NFC_EIO)));
         }
+        for (register, value) in registers.iter().zip(values) {
+            self.core.registers.record(*register, *value);
+        }
         Ok(values[..registers.len()].to_vec())
     }
 
+    // Sends `writes` together with every pending register update in a single
+    // WriteRegister frame; an empty `writes` just flushes the pending ones.
+    // The pending updates are gone either way, so a failure leaves the
+    // registers they touched, and the values staged with them, unknown.
     fn write_registers(&mut self, writes: &[(u16, u8)]) -> Result<(), Error> {
-        if writes.is_empty() {
+        let result = self.flush_register_writes(writes);
+        let staged_tx_bits = self.core.staged_tx_bits.take();
+        let staged_timer_prescaler = self.core.staged_timer_prescaler.take();
+        match result {
+            Ok(()) => {
+                if staged_tx_bits.is_some() {
+                    self.core.tx_bits = staged_tx_bits;
+                }
+                if let Some(prescaler) = staged_timer_prescaler {
+                    self.core.timer_prescaler = prescaler;
+                }
+            }
+            Err(_) => {
+                self.core.tx_bits = None;
+                self.core.registers.clear();
+            }
+        }
+        result
+    }
+
+    fn flush_register_writes(&mut self, writes: &[(u16, u8)]) -> Result<(), Error> {
+        let mut merged = self.resolve_pending_writes()?;
+        merged.extend_from_slice(writes);
+        if merged.is_empty() {
             return Ok(());
         }
+        let writes = merged.as_slice();
         let mut payload = Vec::with_capacity(writes.len() * 3);
         for (register, value) in writes {
             payload.push((register >> 8) as u8);
@@ -191,13 +458,63 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
             payload.push(*value);
         }
         let _ = self.exchange_raw(PN53X_WRITE_REGISTER, &payload, self.core.timeout_command_ms)?;
+        for (register, value) in writes {
+            self.core.registers.record(*register, *value);
+        }
         Ok(())
     }
 
+    // Turns the pending updates into full register values. Registers only
+    // partly covered and missing from the shadow are read in one frame;
+    // updates that leave a shadowed register unchanged are dropped.
+    fn resolve_pending_writes(&mut self) -> Result<Vec<(u16, u8)>, Error> {
+        let pending = self.core.pending_writes.take();
+        let unknown = pending
+            .iter()
+            .filter(|write| write.mask != 0xff && self.core.registers.get(write.register).is_none())
+            .map(|write| write.register)
+            .collect::<Vec<_>>();
+        let read = self.read_registers(&unknown)?;
+
+        let mut writes = Vec::with_capacity(pending.len());
+        for write in pending {
+            let shadowed = self.core.registers.get(write.register);
+            let current = if write.mask == 0xff {
+                None
+            } else {
+                shadowed.or_else(|| {
+                    unknown
+                        .iter()
+                        .position(|register| *register == write.register)
+                        .map(|index| read[index])
+                })
+            };
+            let next = current.map_or(write.value, |current| {
+                (current & !write.mask) | (write.value & write.mask)
+            });
+            if shadowed != Some(next) {
+                writes.push((write.register, next));
+            }
+        }
+        Ok(writes)
+    }
+
+    // Queues a masked update for the next flush instead of writing it now.
+    fn queue_register_bits(&mut self, register: u16, mask: u8, value: u8) {
+        self.core.pending_writes.queue(register, mask, value);
+    }
+
+    // Served from the register shadow once the register has been read or
+    // written, which turns the usual read-modify-write into a single write.
     fn update_register_bits(&mut self, register: u16, mask: u8, value: u8) -> Result<(), Error> {
-        let current = self.read_register(register)?;
-        let next = (current & !mask) | (value & mask);
-        if current != next {
+        // A full-mask update does not depend on the current value.
+        let current = if mask == 0xff {
+            self.core.registers.get(register)
+        } else {
+            Some(self.read_register(register)?)
+        };
+        let next = current.map_or(value, |current| (current & !mask) | (value & mask));
+        if current != Some(next) {
             self.write_register(register, next)?;
         }
         Ok(())
@@ -205,11 +522,11 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
 
     fn set_tx_bits(&mut self, bits: u8) -> Result<(), Error> {
         let bits = bits & SYMBOL_TX_LAST_BITS;
-        if self.core.tx_bits == bits {
+        if self.core.staged_tx_bits.or(self.core.tx_bits) == Some(bits) {
             return Ok(());
         }
-        self.update_register_bits(PN53X_REG_CIU_BIT_FRAMING, SYMBOL_TX_LAST_BITS, bits)?;
-        self.core.tx_bits = bits;
+        self.queue_register_bits(PN53X_REG_CIU_BIT_FRAMING, SYMBOL_TX_LAST_BITS, bits);
+        self.core.staged_tx_bits = Some(bits);
         Ok(())
     }
 
@@ -218,31 +535,32 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
     }
 
     fn init_timer(&mut self, max_cycles: u32) -> Result<(), Error> {
-        self.core.timer_prescaler = if max_cycles > 0xFFFF {
+        let prescaler = if max_cycles > 0xFFFF {
             (((max_cycles / 0xFFFF).saturating_sub(1)) / 2) as u16
         } else {
             0
         };
-        self.write_registers(&[
+        for (register, value) in [
             (
                 PN53X_REG_CIU_TMODE,
-                SYMBOL_TAUTO | (((self.core.timer_prescaler >> 8) as u8) & SYMBOL_TPRESCALERHI),
+                SYMBOL_TAUTO | (((prescaler >> 8) as u8) & SYMBOL_TPRESCALERHI),
             ),
             (
                 PN53X_REG_CIU_TPRESCALER,
-                (self.core.timer_prescaler as u8) & SYMBOL_TPRESCALERLO,
+                (prescaler as u8) & SYMBOL_TPRESCALERLO,
             ),
             (PN53X_REG_CIU_TRELOAD_VAL_HI, 0xff),
             (PN53X_REG_CIU_TRELOAD_VAL_LO, 0xff),
-        ])
+        ] {
+            self.queue_register_bits(register, 0xff, value);
+        }
+        self.core.staged_timer_prescaler = Some(prescaler);
+        Ok(())
     }
 
-    fn timer_cycles(&mut self, last_cmd_byte: u8) -> Result<u32, Error> {
-        let values =
-            self.read_registers(&[PN53X_REG_CIU_TCOUNTER_VAL_HI, PN53X_REG_CIU_TCOUNTER_VAL_LO])?;
-        let counter = u16::from(values[0]) << 8 | u16::from(values[1]);
+    fn timer_cycles(&self, counter: u16, last_cmd_byte: u8) -> u32 {
         if counter == 0 {
-            return Ok(u32::MAX);
+            return u32::MAX;
         }
 
         let mut cycles = u32::from(0xFFFFu16 - counter);
@@ -257,7 +575,7 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
         if even_parity_bit(last_cmd_byte) == 1 {
             cycles = cycles.saturating_add(64);
         }
-        Ok(cycles.saturating_add(self.profile.timer_correction))
+        cycles.saturating_add(self.profile.timer_correction)
     }
 
     fn timed_send_fifo(&mut self, tx: &[u8], tx_last_bits: u8) -> Result<(), Error> {
@@ -267,6 +585,8 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
             SYMBOL_COMMAND & SYMBOL_COMMAND_TRANSCEIVE,
         ));
         writes.push((PN53X_REG_CIU_FIFO_LEVEL, SYMBOL_FLUSH_BUFFER));
+        // RxIRq and ErrIRq then tell when this exchange's reception is over.
+        writes.push((PN53X_REG_CIU_COMM_IRQ, SYMBOL_IRQ_CLEAR_ALL));
         for byte in tx {
             writes.push((PN53X_REG_CIU_FIFO_DATA, *byte));
         }
@@ -275,47 +595,67 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
             SYMBOL_START_SEND | (tx_last_bits & SYMBOL_TX_LAST_BITS),
         ));
         self.write_registers(&writes)?;
-        self.core.tx_bits = tx_last_bits & SYMBOL_TX_LAST_BITS;
+        self.core.tx_bits = Some(tx_last_bits & SYMBOL_TX_LAST_BITS);
         Ok(())
     }
 
-    fn timed_wait_fifo_level(&mut self) -> Result<u8, Error> {
-        let attempts = usize::from(3u16.saturating_mul(self.core.timer_prescaler * 2 + 1)).max(1);
-        let mut level = 0u8;
-        for _ in 0..attempts {
-            level = self.read_register(PN53X_REG_CIU_FIFO_LEVEL)?;
-            if level & SYMBOL_FIFO_LEVEL != 0 {
-                return Ok(level);
-            }
-        }
-        Ok(level)
-    }
-
-    fn timed_receive_fifo(
-        &mut self,
-        rx: &mut [u8],
-        read_last_bits: bool,
-    ) -> Result<(usize, u8), Error> {
-        let mut fifo_level = self.timed_wait_fifo_level()?;
+    // Drains the FIFO of a timed exchange. Each ReadRegister frame first
+    // takes the bytes the previous frame found in the FIFO, then samples
+    // ComIrq, FIFOLevel, RxLastBits and the timer, so waiting and draining
+    // share frames. Once RxIRq or ErrIRq shows the reception over, the last
+    // frame takes exactly what is left and samples nothing. No frame reads
+    // FIFOData past the level it has seen, since that could swallow a byte
+    // still arriving.
+    fn timed_receive_fifo(&mut self, rx: &mut [u8]) -> Result<TimedReception, Error> {
+        const SAMPLE: [u16; 5] = [
+            PN53X_REG_CIU_COMM_IRQ,
+            PN53X_REG_CIU_FIFO_LEVEL,
+            PN53X_REG_CIU_CONTROL,
+            PN53X_REG_CIU_TCOUNTER_VAL_HI,
+            PN53X_REG_CIU_TCOUNTER_VAL_LO,
+        ];
+        let mut idle_samples =
+            usize::from(3u16.saturating_mul(self.core.timer_prescaler * 2 + 1)).max(1);
+        let mut registers = Vec::with_capacity(usize::from(SYMBOL_FIFO_LEVEL) + SAMPLE.len());
+        let mut sample = [0u8; SAMPLE.len()];
+        let mut ended = false;
+        let mut queued = 0usize;
         let mut total = 0usize;
-        while fifo_level & SYMBOL_FIFO_LEVEL != 0 {
-            let chunk_len = usize::from(fifo_level & SYMBOL_FIFO_LEVEL);
-            let mut registers = vec![PN53X_REG_CIU_FIFO_DATA; chunk_len];
-            registers.push(PN53X_REG_CIU_FIFO_LEVEL);
-            let values = self.read_registers(&registers)?;
-            if total + chunk_len > rx.len() {
+        loop {
+            let sampling = !ended && idle_samples > 0;
+            if queued == 0 && !sampling {
+                break;
+            }
+            if total + queued > rx.len() {
                 return Err(status_error("transceive_timed", NFC_EOVFLOW));
             }
-            rx[total..total + chunk_len].copy_from_slice(&values[..chunk_len]);
-            total += chunk_len;
-            fifo_level = values[chunk_len];
+            registers.clear();
+            registers.resize(queued, PN53X_REG_CIU_FIFO_DATA);
+            if sampling {
+                registers.extend_from_slice(&SAMPLE);
+            }
+            let values = self.read_registers(&registers)?;
+            rx[total..total + queued].copy_from_slice(&values[..queued]);
+            total += queued;
+            if !sampling {
+                break;
+            }
+            sample.copy_from_slice(&values[queued..]);
+            ended = sample[0] & (SYMBOL_RX_IRQ | SYMBOL_ERR_IRQ) != 0;
+            queued = usize::from(sample[1] & SYMBOL_FIFO_LEVEL);
+            if queued == 0 && !ended {
+                idle_samples -= 1;
+            }
         }
-        let last_bits = if read_last_bits && total != 0 {
-            self.rx_last_bits()?
-        } else {
-            0
-        };
-        Ok((total, last_bits))
+        Ok(TimedReception {
+            len: total,
+            last_bits: if total == 0 {
+                0
+            } else {
+                sample[2] & SYMBOL_RX_LAST_BITS
+            },
+            counter: u16::from(sample[3]) << 8 | u16::from(sample[4]),
+        })
     }
 
     fn transceive_bytes_timed_shared(
@@ -341,11 +681,11 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
         };
         self.init_timer(0)?;
         self.timed_send_fifo(tx, 0)?;
-        let (written, _) = self.timed_receive_fifo(rx, false)?;
+        let reception = self.timed_receive_fifo(rx)?;
         let last_cmd_byte = timer_last_command_byte(tx, txmode)?;
-        let cycles = self.timer_cycles(last_cmd_byte)?;
+        let cycles = self.timer_cycles(reception.counter, last_cmd_byte);
         self.last_error = 0;
-        Ok((written, cycles))
+        Ok((reception.len, cycles))
     }
 
     fn transceive_bits_timed_shared(
@@ -385,8 +725,9 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
         self.init_timer(0)?;
         self.timed_send_fifo(&payload, (payload_bits_len % 8) as u8)?;
         let mut raw_rx = vec![0u8; rx.len().max(1)];
-        let (raw_len, last_bits) = self.timed_receive_fifo(&mut raw_rx, true)?;
-        let response_bits_len = raw_frame_bits_len(raw_len, last_bits);
+        let reception = self.timed_receive_fifo(&mut raw_rx)?;
+        let raw_len = reception.len;
+        let response_bits_len = raw_frame_bits_len(raw_len, reception.last_bits);
         let written = if self.core.properties.handle_parity {
             let byte_len = bits_to_bytes_len(response_bits_len);
             Self::copy_into(operation, &raw_rx[..byte_len], rx)?;
@@ -395,7 +736,7 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
             pn53x_unwrap_frame(&raw_rx[..raw_len], response_bits_len, rx, rx_parity)?
         };
         let last_cmd_byte = payload.last().copied().unwrap_or(0);
-        let cycles = self.timer_cycles(last_cmd_byte)?;
+        let cycles = self.timer_cycles(reception.counter, last_cmd_byte);
         self.last_error = 0;
         Ok((written, cycles))
     }
@@ -446,6 +787,131 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
         Ok(result_bits)
     }
 
+    // The chip keeps every listed target activated; the first one becomes
+    // the target of the following data exchanges.
+    fn in_list_passive_target(
+        &mut self,
+        operation: &'static str,
+        nm: Modulation,
+        init_data: &[u8],
+        max_tg: u8,
+    ) -> Result<Vec<Target>, Error> {
+        let Some(pm) = nm_to_pm(nm) else {
+            return self.remember(Err(Error::UnsupportedOperation(operation)));
+        };
+        let mut payload = Vec::with_capacity(init_data.len() + 3);
+        payload.push(max_tg);
+        payload.push(pm);
+        payload.extend_from_slice(init_data);
+
+        let response = self.exchange_raw(
+            PN53X_IN_LIST_PASSIVE_TARGET,
+            &payload,
+            self.core.timeout_command_ms,
+        )?;
+        let targets = decode_target_list(self.core.chip_type(), nm, &response)?;
+        match targets.first() {
+            Some(target) => self.core.remember_target(target.clone()),
+            None => self.core.clear_target(),
+        }
+        self.last_error = 0;
+        Ok(targets)
+    }
+
+    // Switches a freshly activated ISO14443-4 target to the fastest rate both
+    // sides support with InPSL, the chip sending the PPS request. A target
+    // that refuses stays at 106 kbps, which its nbr keeps reporting.
+    // `tg` is the chip's number for the target, 1 for the first one listed.
+    fn apply_auto_bit_rate(&mut self, target: &mut Target, tg: u8) -> Result<(), Error> {
+        if self.core.properties.auto_bit_rate && !self.core.properties.force_speed_106 {
+            self.upgrade_bit_rate(target, tg)?;
+        }
+        Ok(())
+    }
+
+    fn upgrade_bit_rate(&mut self, target: &mut Target, tg: u8) -> Result<(), Error> {
+        if target.modulation.baud_rate != BaudRate::Br106 {
+            return Ok(());
+        }
+        let rate = iso_dep_bit_rate(target, self.core.chip_type().iso_dep_bit_rates());
+        let code = match rate {
+            BaudRate::Br212 => 0x01,
+            BaudRate::Br424 => 0x02,
+            BaudRate::Br847 => 0x03,
+            BaudRate::Br106 | BaudRate::Undefined => return Ok(()),
+        };
+        // Only a refusal reported in the status byte, by the chip or by the
+        // card over RF, leaves the target at 106 kbps; a link that fails is
+        // reported like any other exchange.
+        let range = self.exchange_range(
+            PN53X_IN_PSL,
+            &[&[tg, code, code]],
+            self.core.timeout_command_ms,
+        )?;
+        let (status, _) = split_status_response(PN53X_IN_PSL, &self.core.frame[range])?;
+        self.core.last_status_byte = status;
+        if pn53x_translate_status(status) == 0 {
+            target.modulation.baud_rate = rate;
+            if tg == 1 {
+                self.core.remember_target(target.clone());
+            }
+        } else {
+            self.core.registers.clear();
+        }
+        self.last_error = 0;
+        Ok(())
+    }
+
+    // InAutoPoll exists on the PN532 only and takes up to 15 target types
+    // and a period of 1 to 15 units; anything else is polled in software.
+    fn auto_poll_target_types(&self, modulations: &[Modulation], period: u8) -> Option<Vec<u8>> {
+        if self.core.chip_type() != Pn53xType::Pn532
+            || modulations.len() > PN532_AUTO_POLL_MAX_TARGET_TYPES
+            || !(1..=0x0f).contains(&period)
+        {
+            return None;
+        }
+        modulations.iter().map(|nm| nm_to_ptt(*nm)).collect()
+    }
+
+    fn in_auto_poll(
+        &mut self,
+        target_types: &[u8],
+        poll_nr: u8,
+        period: u8,
+    ) -> Result<Option<Target>, Error> {
+        let poll_nr = poll_nr.max(1);
+        // The chip answers once a target shows up or every round is spent.
+        let timeout_ms = if poll_nr == 0xff {
+            -1
+        } else {
+            let rounds = i32::from(poll_nr) * target_types.len() as i32;
+            rounds * i32::from(period) * 150 + self.core.timeout_command_ms
+        };
+        let mut payload = Vec::with_capacity(target_types.len() + 2);
+        payload.push(poll_nr);
+        payload.push(period);
+        payload.extend_from_slice(target_types);
+
+        let response = self.exchange_raw(PN532_IN_AUTO_POLL, &payload, timeout_ms)?;
+        let targets = match decode_auto_poll_targets(self.core.chip_type(), &response) {
+            Ok(targets) => targets,
+            Err(error) => return self.remember(Err(error)),
+        };
+        // Both reported targets stay activated, but a poll yields one: the
+        // first, found first just as in the software loop, and the one that
+        // later exchanges address as Tg 1.
+        let Some(mut target) = targets.into_iter().next() else {
+            self.core.clear_target();
+            self.last_error = 0;
+            return Ok(None);
+        };
+        self.core.remember_target(target.clone());
+        self.apply_auto_bit_rate(&mut target, 1)?;
+        self.last_error = 0;
+        Ok(Some(target))
+    }
+
     fn with_temporary_bool_property<R>(
         &mut self,
         property: Property,
@@ -487,7 +953,7 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
 
     fn diagnose_card_presence(&mut self) -> Result<bool, Error> {
         const PN53X_DIAGNOSE: u8 = 0x00;
-        let response = self.exchange_raw(PN53X_DIAGNOSE, &[0x06], 1000)?;
+        let response = self.exchange_raw(PN53X_DIAGNOSE, &[0x06], self.core.timeout_command_ms)?;
         let Some(&status) = response.first() else {
             return Err(status_error("target_is_present", NFC_EIO));
         };
@@ -507,6 +973,10 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
             TargetInfo::Iso14443A { atqa, sak, .. } if *sak == 0x00 && *atqa == [0x00, 0x44] => {
                 self.presence_transceive_bytes(&[0x30, 0x00], 300, true)
             }
+            // A Classic card has no frame that is safe to send blindly: once
+            // a sector is authenticated, anything but a correctly encrypted
+            // command halts it, and an active card ignores WUPA. Only a
+            // reselect of its UID tells whether it is still in the field.
             TargetInfo::Iso14443A { sak, uid, .. } if *sak & SAK_MIFARE_CLASSIC_MASK != 0 => {
                 let init_data = cascade_iso14443a_uid(uid);
                 self.with_temporary_bool_property(Property::InfiniteSelect, false, |device| {
@@ -520,6 +990,16 @@ impl<T: Pn53xTransport + Send + 'static> Pn53xDevice<T> {
     }
 
     fn check_current_target_presence(&mut self, target: &Target) -> Result<bool, Error> {
+        // With NP_PRESENCE_WINDOW set, ISO14443-4 targets are probed with
+        // Diagnose, which leaves the R(NAK) exchange to the chip and needs
+        // no framing properties flipped around it.
+        if self.core.presence_window_ms > 0
+            && matches!(self.core.chip_type(), Pn53xType::Pn532 | Pn53xType::Pn533)
+            && (is_iso14443_4_target(target)
+                || target.modulation.modulation_type == ModulationType::Iso14443B)
+        {
+            return self.diagnose_card_presence();
+        }
         match target.modulation.modulation_type {
             ModulationType::Iso14443A => self.check_iso14443a_presence(target),
             ModulationType::Iso14443B => self.presence_transceive_bytes(&[0xba, 0x01], 300, false),
@@ -559,7 +1039,10 @@ impl<T: Pn53xTransport + Send + 'static> DeviceMeta for Pn53xDevice<T> {
 
 impl<T: Pn53xTransport + Send + 'static> InfoBackend for Pn53xDevice<T> {
     fn information_about(&mut self) -> Result<String, Error> {
-        let message = format!("{} via {}", self.firmware_text(), self.connstring);
+        let mut message = format!("{} via {}", self.firmware_text(), self.connstring);
+        if let Some(speed) = self.serial_speed {
+            message.push_str(&format!(", serial link at {speed} baud"));
+        }
         self.last_error = 0;
         Ok(message)
     }
@@ -622,35 +1105,27 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
         nm: Modulation,
         init_data: &[u8],
     ) -> Result<Option<Target>, Error> {
-        let Some(pm) = nm_to_pm(nm) else {
-            return self.remember(Err(Error::UnsupportedOperation("select_passive_target")));
+        let targets = self.in_list_passive_target("select_passive_target", nm, init_data, 1)?;
+        let Some(mut target) = targets.into_iter().next() else {
+            return Ok(None);
         };
-        let mut payload = Vec::with_capacity(init_data.len() + 3);
-        payload.push(0x01);
-        payload.push(pm);
-        payload.extend_from_slice(init_data);
+        self.apply_auto_bit_rate(&mut target, 1)?;
+        Ok(Some(target))
+    }
 
-        let response = self.exchange_raw(
-            PN53X_IN_LIST_PASSIVE_TARGET,
-            &payload,
-            self.core.timeout_command_ms,
-        )?;
-        let target = if response.first().copied().unwrap_or(0) == 0 {
-            None
-        } else {
-            Some(decode_target_data(
-                self.core.chip_type(),
-                nm,
-                &response[1..],
-            )?)
-        };
-        if let Some(target) = &target {
-            self.core.remember_target(target.clone());
-        } else {
-            self.core.clear_target();
+    fn list_passive_targets_driver(
+        &mut self,
+        nm: Modulation,
+        init_data: &[u8],
+        max_targets: usize,
+    ) -> Result<Vec<Target>, Error> {
+        let max_tg = max_targets.clamp(1, PN53X_MAX_PASSIVE_TARGETS) as u8;
+        let mut targets =
+            self.in_list_passive_target("list_passive_targets", nm, init_data, max_tg)?;
+        for (tg, target) in (1..).zip(targets.iter_mut()) {
+            self.apply_auto_bit_rate(target, tg)?;
         }
-        self.last_error = 0;
-        Ok(target)
+        Ok(targets)
     }
 
     fn poll_target_driver(
@@ -662,6 +1137,9 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
         if modulations.is_empty() {
             return self.remember(Err(Error::InvalidArgument("modulations")));
         }
+        if let Some(target_types) = self.auto_poll_target_types(modulations, period) {
+            return self.in_auto_poll(&target_types, poll_nr, period);
+        }
 
         let delay = Duration::from_micros(u64::from(period) * 150_000);
         let mut remaining = if poll_nr == 0xff {
@@ -739,9 +1217,15 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
             self.core.clear_target();
             return self.remember(Err(status_error("target_is_present", NFC_ETGRELEASED)));
         }
+        if self.core.target_recently_seen() {
+            self.last_error = 0;
+            return Ok(true);
+        }
         match self.check_current_target_presence(&current) {
             Ok(found) => {
-                if !found {
+                if found {
+                    self.core.note_target_answer();
+                } else {
                     self.core.clear_target();
                 }
                 self.last_error = 0;
@@ -769,20 +1253,20 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
             self.core.timeout_communication_ms
         };
         self.set_tx_bits(0)?;
-        let response = if self.core.properties.easy_framing {
-            let mut payload = Vec::with_capacity(tx.len() + 1);
-            payload.push(0x01);
-            payload.extend_from_slice(tx);
-            self.exchange_with_status(
+        let written = if self.core.properties.easy_framing {
+            self.in_data_exchange_chained(tx, rx, timeout)?
+        } else {
+            let response = self.exchange_with_status_in_place(
                 "transceive_bytes",
-                PN53X_IN_DATA_EXCHANGE,
-                &payload,
+                PN53X_IN_COMMUNICATE_THRU,
+                &[tx],
                 timeout,
-            )?
-        } else {
-            self.exchange_with_status("transceive_bytes", PN53X_IN_COMMUNICATE_THRU, tx, timeout)?
+            )?;
+            Self::copy_into("transceive_bytes", response, rx)?
         };
-        let written = Self::copy_into("transceive_bytes", &response, rx)?;
+        if written > 0 {
+            self.core.note_target_answer();
+        }
         self.last_error = 0;
         Ok(written)
     }
@@ -795,7 +1279,7 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
         rx: &mut [u8],
         rx_parity: Option<&mut [u8]>,
     ) -> Result<usize, Error> {
-        self.transceive_bits_shared(BitTransceiveRequest {
+        let result = self.transceive_bits_shared(BitTransceiveRequest {
             operation: "transceive_bits",
             command: PN53X_IN_COMMUNICATE_THRU,
             tx,
@@ -804,7 +1288,11 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
             rx,
             rx_parity,
             timeout_ms: self.core.timeout_communication_ms,
-        })
+        });
+        if matches!(result, Ok(bits) if bits > 0) {
+            self.core.note_target_answer();
+        }
+        result
     }
 
     fn transceive_bytes_timed_driver(
@@ -812,7 +1300,11 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
         tx: &[u8],
         rx: &mut [u8],
     ) -> Result<(usize, u32), Error> {
-        self.transceive_bytes_timed_shared("transceive_bytes_timed", tx, rx)
+        let result = self.transceive_bytes_timed_shared("transceive_bytes_timed", tx, rx);
+        if matches!(result, Ok((len, _)) if len > 0) {
+            self.core.note_target_answer();
+        }
+        result
     }
 
     fn transceive_bits_timed_driver(
@@ -823,19 +1315,25 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
         rx: &mut [u8],
         rx_parity: Option<&mut [u8]>,
     ) -> Result<(usize, u32), Error> {
-        self.transceive_bits_timed_shared(
+        let result = self.transceive_bits_timed_shared(
             "transceive_bits_timed",
             tx,
             tx_bits_len,
             tx_parity,
             rx,
             rx_parity,
-        )
+        );
+        if matches!(result, Ok((bits, _)) if bits > 0) {
+            self.core.note_target_answer();
+        }
+        result
     }
 
+    // Called from another thread while the owner may be blocked in an
+    // exchange, so this only signals the transport; the interrupted exchange
+    // fails and invalidates the register shadow itself.
     fn abort_command_driver(&mut self) -> Result<(), Error> {
-        let result = self.transport.abort_command();
-        self.remember(result)
+        self.transport.abort_command()
     }
 
     fn idle_driver(&mut self) -> Result<(), Error> {
@@ -843,8 +1341,25 @@ impl<T: Pn53xTransport + Send + 'static> InitiatorBackend for Pn53xDevice<T> {
         Ok(())
     }
 
+    // Properties and timeouts only live on the host; what they programmed
+    // into the chip is rewritten by the next exchange that depends on it.
+    fn reset_session_driver(&mut self) -> Result<(), Error> {
+        let defaults = self.session_defaults;
+        self.core.properties = defaults.properties;
+        self.core.timeout_command_ms = defaults.timeout_command_ms;
+        self.core.timeout_atr_ms = defaults.timeout_atr_ms;
+        self.core.timeout_communication_ms = defaults.timeout_communication_ms;
+        self.core.presence_window_ms = defaults.presence_window_ms;
+        self.core.current_target = None;
+        self.core.forget_target_answer();
+        self.last_error = 0;
+        Ok(())
+    }
+
     fn powerdown_driver(&mut self) -> Result<(), Error> {
         self.core.power_mode = Pn53xPowerMode::PowerDown;
+        self.core.forget_target_answer();
+        self.core.registers.clear();
         self.last_error = 0;
         Ok(())
     }
@@ -1,4 +1,5 @@
 use super::*;
+use std::ops::Range;
 
 fn command_uses_status_byte(command: u8) -> bool {
     matches!(
@@ -7,6 +8,7 @@ fn command_uses_status_byte(command: u8) -> bool {
             | PN53X_IN_DATA_EXCHANGE
             | PN53X_IN_COMMUNICATE_THRU
             | PN53X_IN_JUMP_FOR_DEP
+            | PN53X_IN_PSL
             | PN53X_TG_GET_DATA
             | PN53X_TG_SET_DATA
             | PN53X_TG_GET_INITIATOR_COMMAND
@@ -15,35 +17,58 @@ fn command_uses_status_byte(command: u8) -> bool {
     )
 }
 
-pub(super) fn split_status_response(command: u8, response: &[u8]) -> Result<(u8, Vec<u8>), Error> {
+pub(super) fn split_status_response(command: u8, response: &[u8]) -> Result<(u8, &[u8]), Error> {
     if !command_uses_status_byte(command) {
-        return Ok((0, response.to_vec()));
+        return Ok((0, response));
     }
     let Some((&status_flags, data)) = response.split_first() else {
         return Err(status_error("pn53x_status_response", NFC_EIO));
     };
     if status_flags & 0x80 != 0 {
-        return Ok((PN53X_STATUS_NAD, data.to_vec()));
+        return Ok((PN53X_STATUS_NAD, data));
     }
-    Ok((status_flags & 0x3f, data.to_vec()))
+    Ok((status_flags & 0x3f, data))
 }
 
 pub(crate) fn build_frame(payload: &[u8]) -> Result<Vec<u8>, Error> {
-    if payload.is_empty() {
+    let Some((&command, data)) = payload.split_first() else {
         return Err(Error::InvalidArgument("payload"));
-    }
+    };
+    let mut frame = vec![0u8; payload.len() + PN53X_EXTENDED_FRAME_OVERHEAD];
+    let len = encode_frame_into(&mut frame, command, &[data])?;
+    frame.truncate(len);
+    Ok(frame)
+}
 
-    if payload.len() > PN53X_EXTENDED_FRAME_DATA_MAX_LEN {
+/// Encodes a host-to-chip frame for `command` into `frame` and returns its
+/// length. The command data is the concatenation of `parts`, so a prefix
+/// can precede caller data without first being copied together with it.
+pub(super) fn encode_frame_into(
+    frame: &mut [u8],
+    command: u8,
+    parts: &[&[u8]],
+) -> Result<usize, Error> {
+    let payload_len = 1 + parts.iter().map(|part| part.len()).sum::<usize>();
+
+    if payload_len > PN53X_EXTENDED_FRAME_DATA_MAX_LEN {
         return Err(Error::BufferTooSmall {
-            needed: payload.len(),
+            needed: payload_len,
             available: PN53X_EXTENDED_FRAME_DATA_MAX_LEN,
         });
     }
 
-    let mut frame = Vec::with_capacity(PN532_BUFFER_LEN);
-    if payload.len() <= 254 {
-        let len = payload.len() as u8 + 1;
-        frame.extend_from_slice(&[
+    let header_len = if payload_len <= 254 { 6 } else { 9 };
+    let frame_len = header_len + payload_len + 2;
+    if frame.len() < frame_len {
+        return Err(Error::BufferTooSmall {
+            needed: frame_len,
+            available: frame.len(),
+        });
+    }
+
+    if payload_len <= 254 {
+        let len = payload_len as u8 + 1;
+        frame[..header_len].copy_from_slice(&[
             0x00,
             0x00,
             0xff,
@@ -51,11 +76,10 @@ pub(crate) fn build_frame(payload: &[u8]) -> Result<Vec<u8>, Error> {
             (!len).wrapping_add(1),
             HOST_TO_PN53X_TFI,
         ]);
-        frame.extend_from_slice(payload);
     } else {
-        let high = ((payload.len() + 1) >> 8) as u8;
-        let low = ((payload.len() + 1) & 0xff) as u8;
-        frame.extend_from_slice(&[
+        let high = ((payload_len + 1) >> 8) as u8;
+        let low = ((payload_len + 1) & 0xff) as u8;
+        frame[..header_len].copy_from_slice(&[
             0x00,
             0x00,
             0xff,
@@ -66,17 +90,19 @@ pub(crate) fn build_frame(payload: &[u8]) -> Result<Vec<u8>, Error> {
             (0u8).wrapping_sub(high.wrapping_add(low)),
             HOST_TO_PN53X_TFI,
         ]);
-        frame.extend_from_slice(payload);
     }
 
-    let dcs = payload
-        .iter()
-        .fold(0u8.wrapping_sub(HOST_TO_PN53X_TFI), |acc, byte| {
-            acc.wrapping_sub(*byte)
-        });
-    frame.push(dcs);
-    frame.push(0x00);
-    Ok(frame)
+    frame[header_len] = command;
+    let mut offset = header_len + 1;
+    let mut dcs = 0u8.wrapping_sub(HOST_TO_PN53X_TFI).wrapping_sub(command);
+    for part in parts {
+        frame[offset..offset + part.len()].copy_from_slice(part);
+        offset += part.len();
+        dcs = part.iter().fold(dcs, |acc, byte| acc.wrapping_sub(*byte));
+    }
+    frame[offset] = dcs;
+    frame[offset + 1] = 0x00;
+    Ok(frame_len)
 }
 
 pub(crate) fn is_ack_frame(frame: &[u8]) -> bool {
@@ -166,7 +192,12 @@ pub(crate) fn payload_from_host_frame(frame: &[u8]) -> Result<Vec<u8>, Error> {
     Ok(body[1..].to_vec())
 }
 
-pub(super) fn parse_response_frame(frame: &[u8], expected_command: u8) -> Result<Vec<u8>, Error> {
+/// Validates a chip-to-host frame and returns where its payload (after the
+/// TFI and response code) lies within `frame`.
+pub(super) fn parse_response_frame(
+    frame: &[u8],
+    expected_command: u8,
+) -> Result<Range<usize>, Error> {
     if frame.len() < 8 {
         return Err(status_error("pn53x_parse_response_frame", NFC_EIO));
     }
@@ -214,5 +245,5 @@ pub(super) fn parse_response_frame(frame: &[u8], expected_command: u8) -> Result
         return Err(status_error("pn53x_parse_response_frame", NFC_EIO));
     }
 
-    Ok(body[2..].to_vec())
+    Ok(body_offset + 2..trailer_offset)
 }
@@ -0,0 +1,90 @@
+use super::*;
+use proximate_driver::Context;
+use std::collections::HashMap;
+use std::sync::{Mutex, MutexGuard, OnceLock};
+
+/// What the connection string resolved to when the chip was last probed.
+/// A replugged reader gets a new USB address or a new device node inode, so
+/// a stale entry can never match it.
+#[derive(Clone, Debug, Eq, Hash, PartialEq)]
+pub(crate) enum NodeIdentity {
+    Inode { dev: u64, ino: u64 },
+    Usb { bus: u8, address: u8 },
+}
+
+#[derive(Clone, Debug, Eq, Hash, PartialEq)]
+pub(crate) struct ChipIdentityKey {
+    connstring: String,
+    node: NodeIdentity,
+}
+
+impl ChipIdentityKey {
+    pub(crate) fn new(connstring: &ConnectionString, node: NodeIdentity) -> Self {
+        Self {
+            connstring: connstring.as_str().to_string(),
+            node,
+        }
+    }
+
+    /// Key for a device reached through a filesystem node, or `None` when
+    /// the cache is disabled or the node cannot be stat'ed.
+    pub(crate) fn for_path(
+        context: &Context,
+        connstring: &ConnectionString,
+        path: &str,
+    ) -> Option<Self> {
+        if !context.config.chip_identity_cache {
+            return None;
+        }
+        node_inode(path).map(|node| Self::new(connstring, node))
+    }
+
+    pub(crate) fn for_usb(
+        context: &Context,
+        connstring: &ConnectionString,
+        bus: u8,
+        address: u8,
+    ) -> Option<Self> {
+        context
+            .config
+            .chip_identity_cache
+            .then(|| Self::new(connstring, NodeIdentity::Usb { bus, address }))
+    }
+}
+
+#[cfg(unix)]
+fn node_inode(path: &str) -> Option<NodeIdentity> {
+    use std::os::unix::fs::MetadataExt;
+
+    let metadata = std::fs::metadata(path).ok()?;
+    Some(NodeIdentity::Inode {
+        dev: metadata.dev(),
+        ino: metadata.ino(),
+    })
+}
+
+#[cfg(not(unix))]
+fn node_inode(_path: &str) -> Option<NodeIdentity> {
+    None
+}
+
+fn identities() -> MutexGuard<'static, HashMap<ChipIdentityKey, Pn53xFirmwareVersion>> {
+    static IDENTITIES: OnceLock<Mutex<HashMap<ChipIdentityKey, Pn53xFirmwareVersion>>> =
+        OnceLock::new();
+    IDENTITIES
+        .get_or_init(|| Mutex::new(HashMap::new()))
+        .lock()
+        .unwrap_or_else(|poisoned| poisoned.into_inner())
+}
+
+pub(super) fn lookup(key: &ChipIdentityKey) -> Option<Pn53xFirmwareVersion> {
+    identities().get(key).cloned()
+}
+
+pub(super) fn record(key: ChipIdentityKey, firmware: Pn53xFirmwareVersion) {
+    identities().insert(key, firmware);
+}
+
+pub(super) fn forget(key: &ChipIdentityKey) {
+    identities().remove(key);
+}
@@ -0,0 +1,145 @@
+use super::*;
+use proximate_driver::DeviceHandle;
+use std::collections::VecDeque;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+
+/// Timing model of a simulated PN532 link.
+#[derive(Clone, Copy, Debug)]
+pub struct SimulatedLink {
+    /// Host-side cost of one command frame, its ACK and the response.
+    pub exchange_latency: Duration,
+    /// RF time the chip spends on one activation attempt for one target type.
+    pub activation_time: Duration,
+}
+
+// ISO14443A record of the simulated card: Tg, ATQA, SAK, NFCID1.
+const CARD_RECORD: [u8; 9] = [0x01, 0x00, 0x04, 0x08, 0x04, 0xde, 0xad, 0xbe, 0xef];
+const CARD_TARGET_TYPE: u8 = 0x10;
+const AUTO_POLL_PERIOD_UNIT: Duration = Duration::from_millis(150);
+
+// Answers commands the way a PN532 would once an ISO14443A card enters the
+// field at `card_at`; every frame exchange and activation costs real time.
+struct SimulatedPn532 {
+    link: SimulatedLink,
+    card_at: Instant,
+    responses: VecDeque<Vec<u8>>,
+    exchanges: Arc<AtomicUsize>,
+}
+
+impl SimulatedPn532 {
+    fn card_present(&self) -> bool {
+        Instant::now() >= self.card_at
+    }
+
+    fn activate(&self, target_type: u8) -> bool {
+        std::thread::sleep(self.link.activation_time);
+        target_type == CARD_TARGET_TYPE && self.card_present()
+    }
+
+    fn in_list_passive_target(&self, data: &[u8]) -> Vec<u8> {
+        if data.get(1) == Some(&0x00) && self.activate(CARD_TARGET_TYPE) {
+            let mut response = vec![0x01];
+            response.extend_from_slice(&CARD_RECORD);
+            response
+        } else {
+            vec![0x00]
+        }
+    }
+
+    fn in_auto_poll(&self, data: &[u8]) -> Vec<u8> {
+        let [poll_nr, period, target_types @ ..] = data else {
+            return vec![0x00];
+        };
+        let mut round = 0u8;
+        while *poll_nr == 0xff || round < *poll_nr {
+            for target_type in target_types {
+                if self.activate(*target_type) {
+                    let mut response = vec![0x01, *target_type, CARD_RECORD.len() as u8];
+                    response.extend_from_slice(&CARD_RECORD);
+                    return response;
+                }
+            }
+            std::thread::sleep(AUTO_POLL_PERIOD_UNIT * u32::from(*period));
+            round = round.saturating_add(1);
+        }
+        vec![0x00]
+    }
+
+    fn respond(&mut self, command: u8, payload: &[u8]) {
+        let mut frame = vec![0x00, 0x00, 0xff, 0x00, 0x00, PN53X_TO_HOST_TFI, command + 1];
+        frame.extend_from_slice(payload);
+        let len = (frame.len() - 5) as u8;
+        frame[3] = len;
+        frame[4] = len.wrapping_neg();
+        let dcs = frame[5..]
+            .iter()
+            .fold(0u8, |sum, byte| sum.wrapping_add(*byte))
+            .wrapping_neg();
+        frame.extend_from_slice(&[dcs, 0x00]);
+        self.responses.push_back(PN53X_ACK_FRAME.to_vec());
+        self.responses.push_back(frame);
+    }
+}
+
+impl Pn53xTransport for SimulatedPn532 {
+    fn send(&mut self, payload: &[u8], _timeout_ms: i32) -> Result<(), Error> {
+        std::thread::sleep(self.link.exchange_latency);
+        self.exchanges.fetch_add(1, Ordering::Relaxed);
+        let (Some(&command), Some(data)) = (payload.get(6), payload.get(7..payload.len() - 2))
+        else {
+            return Err(status_error("simulated_send", NFC_EIO));
+        };
+        let response = match command {
+            PN53X_GET_FIRMWARE_VERSION => vec![0x32, 0x01, 0x06, 0x07],
+            PN53X_IN_LIST_PASSIVE_TARGET => self.in_list_passive_target(data),
+            PN532_IN_AUTO_POLL => self.in_auto_poll(data),
+            _ => Vec::new(),
+        };
+        self.respond(command, &response);
+        Ok(())
+    }
+
+    fn receive(&mut self, buffer: &mut [u8], _timeout_ms: i32) -> Result<usize, Error> {
+        let frame = self
+            .responses
+            .pop_front()
+            .ok_or_else(|| status_error("simulated_receive", NFC_ETIMEOUT))?;
+        buffer[..frame.len()].copy_from_slice(&frame);
+        Ok(frame.len())
+    }
+
+    fn abort_command(&mut self) -> Result<(), Error> {
+        Ok(())
+    }
+}
+
+/// Opens a PN532 over a simulated link; an ISO14443A card enters the field
+/// at `card_at`. Without `auto_poll` the chip reports itself as a PN533, so
+/// poll_target falls back to polling from the host. Every command frame the
+/// host sends is counted in `exchanges`.
+pub fn simulated_pn532(
+    link: SimulatedLink,
+    card_at: Instant,
+    auto_poll: bool,
+    exchanges: Arc<AtomicUsize>,
+) -> Result<Box<dyn DeviceHandle>, Error> {
+    let transport = SimulatedPn532 {
+        link,
+        card_at,
+        responses: VecDeque::new(),
+        exchanges,
+    };
+    let mut device = Pn53xDevice::probe_with_profile(
+        "simulated PN532",
+        ConnectionString::new("pn532_simulated:bench")?,
+        Pn53xProfile::pn532("pn532_simulated"),
+        transport,
+        1000,
+    )?;
+    if !auto_poll {
+        device.core.chip_type = Pn53xType::Pn533;
+    }
+    Ok(Box::new(device))
+}
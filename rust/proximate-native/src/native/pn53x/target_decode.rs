@@ -50,8 +50,7 @@ pub(super) fn nm_to_ptt(modulation: Modulation) -> Option<u8> {
     }
 }
 
-#[allow(dead_code)]
-fn ptt_to_modulation(value: u8) -> Modulation {
+pub(super) fn ptt_to_modulation(value: u8) -> Modulation {
     match value {
         0x03 | 0x23 => Modulation {
             modulation_type: ModulationType::Iso14443B,
@@ -119,6 +118,80 @@ pub(super) fn decode_target_data(
     Ok(Target { modulation, info })
 }
 
+/// Decodes an InListPassiveTarget response: NbTg followed by one record per
+/// target. Every record but the last is sized from its own length fields;
+/// the last one takes the rest of the response.
+pub(super) fn decode_target_list(
+    chip_type: Pn53xType,
+    modulation: Modulation,
+    response: &[u8],
+) -> Result<Vec<Target>, Error> {
+    let count = usize::from(response.first().copied().unwrap_or(0));
+    let mut raw = response.get(1..).unwrap_or_default();
+    let mut targets = Vec::with_capacity(count);
+    for index in 0..count {
+        let record_len = if index + 1 == count {
+            raw.len()
+        } else {
+            target_record_len(modulation, raw)
+                .ok_or_else(|| status_error("decode_target_data", NFC_EIO))?
+        };
+        targets.push(decode_target_data(
+            chip_type,
+            modulation,
+            &raw[..record_len],
+        )?);
+        raw = &raw[record_len..];
+    }
+    Ok(targets)
+}
+
+/// Decodes an InAutoPoll response: NbTg followed by one record per target,
+/// each its target type, the length of its data and the data itself, laid
+/// out as in an InListPassiveTarget record.
+pub(super) fn decode_auto_poll_targets(
+    chip_type: Pn53xType,
+    response: &[u8],
+) -> Result<Vec<Target>, Error> {
+    let count = usize::from(response.first().copied().unwrap_or(0));
+    let mut raw = response.get(1..).unwrap_or_default();
+    let mut targets = Vec::with_capacity(count);
+    for _ in 0..count {
+        let (Some(&target_type), Some(&data_len)) = (raw.first(), raw.get(1)) else {
+            return Err(status_error("poll_target", NFC_EIO));
+        };
+        let data = raw
+            .get(2..2 + usize::from(data_len))
+            .ok_or_else(|| status_error("poll_target", NFC_EIO))?;
+        targets.push(decode_target_data(
+            chip_type,
+            ptt_to_modulation(target_type),
+            data,
+        )?);
+        raw = &raw[2 + data.len()..];
+    }
+    Ok(targets)
+}
+
+fn target_record_len(modulation: Modulation, raw: &[u8]) -> Option<usize> {
+    let len = match modulation.modulation_type {
+        ModulationType::Iso14443A => {
+            let sak = *raw.get(3)?;
+            let mut len = 5 + usize::from(*raw.get(4)?);
+            // The ATS length byte counts itself.
+            if sak & SAK_ISO14443_4_COMPLIANT != 0 {
+                len += usize::from(*raw.get(len)?).max(1);
+            }
+            len
+        }
+        ModulationType::Iso14443B => 14 + usize::from(*raw.get(13)?),
+        ModulationType::Felica => 1 + usize::from(*raw.get(1)?),
+        ModulationType::Jewel => 7,
+        _ => return None,
+    };
+    (len <= raw.len()).then_some(len)
+}
+
 fn decode_iso14443a_target(chip_type: Pn53xType, raw: &[u8]) -> Result<TargetInfo, Error> {
     if raw.len() < 5 {
         return Err(status_error("decode_iso14443a_target", NFC_EIO));
@@ -301,6 +374,34 @@ pub(super) fn parse_dep_target(
     }))
 }
 
+/// Fastest data rate out of `rates` that an activated ISO14443-4 target
+/// supports in both directions, from TA(1) of its ATS (type A) or the bit
+/// rate byte of its ATQB protocol info (type B). Both lay out DS (target to
+/// reader) in b7-b5 and DR (reader to target) in b3-b1, one bit per rate
+/// from 848 down to 212 kbps.
+pub(super) fn iso_dep_bit_rate(target: &Target, rates: u8) -> BaudRate {
+    let capability = match &target.info {
+        TargetInfo::Iso14443A { sak, ats, .. } if sak & SAK_ISO14443_4_COMPLIANT != 0 => {
+            match ats.as_slice() {
+                [t0, ta1, ..] if t0 & 0x10 != 0 => *ta1,
+                _ => 0,
+            }
+        }
+        TargetInfo::Iso14443B { protocol_info, .. } => protocol_info[0],
+        _ => 0,
+    };
+    let common = (capability >> 4) & capability & rates & 0x07;
+    if common & 0x04 != 0 {
+        BaudRate::Br847
+    } else if common & 0x02 != 0 {
+        BaudRate::Br424
+    } else if common & 0x01 != 0 {
+        BaudRate::Br212
+    } else {
+        BaudRate::Br106
+    }
+}
+
 pub(super) fn is_iso14443_4_target(target: &Target) -> bool {
     matches!(
         target.info,
@@ -1,4 +1,7 @@
 use super::*;
+use crate::test_rng::TestRng;
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::cell::Cell;
 use std::collections::VecDeque;
 
 fn cascade_iso14443a_uid(uid: &[u8]) -> Vec<u8> {
@@ -194,6 +197,10 @@ struct FakeTransport {
     received: VecDeque<Vec<u8>>,
     wake_up_calls: usize,
     abort_calls: usize,
+    // An abort ends the next receive that would otherwise wait.
+    abort_pending: bool,
+    line_speeds: Vec<u32>,
+    receive_timeouts: Vec<i32>,
 }
 
 impl Pn53xTransport for FakeTransport {
@@ -202,7 +209,11 @@ impl Pn53xTransport for FakeTransport {
         Ok(())
     }
 
-    fn receive(&mut self, buffer: &mut [u8], _timeout_ms: i32) -> Result<usize, Error> {
+    fn receive(&mut self, buffer: &mut [u8], timeout_ms: i32) -> Result<usize, Error> {
+        self.receive_timeouts.push(timeout_ms);
+        if self.received.is_empty() && std::mem::take(&mut self.abort_pending) {
+            return Err(status_error("receive", NFC_EOPABORTED));
+        }
         let payload = self
             .received
             .pop_front()
@@ -219,6 +230,7 @@ impl Pn53xTransport for FakeTransport {
 
     fn abort_command(&mut self) -> Result<(), Error> {
         self.abort_calls += 1;
+        self.abort_pending = true;
         Ok(())
     }
 
@@ -226,6 +238,11 @@ impl Pn53xTransport for FakeTransport {
         self.wake_up_calls += 1;
         Ok(())
     }
+
+    fn set_line_speed(&mut self, speed: u32) -> Result<(), Error> {
+        self.line_speeds.push(speed);
+        Ok(())
+    }
 }
 
 fn response_frame(command: u8, payload: &[u8]) -> Vec<u8> {
@@ -282,13 +299,135 @@ fn probed_device() -> Pn53xDevice<FakeTransport> {
     .unwrap()
 }
 
+// Counts heap allocations made by the current thread while a closure runs,
+// so allocation-free paths can be asserted without other tests interfering.
+struct CountingAllocator;
+
+thread_local! {
+    static ALLOCATIONS: Cell<Option<usize>> = const { Cell::new(None) };
+}
+
+fn count_allocation() {
+    let _ = ALLOCATIONS.try_with(|count| count.set(count.get().map(|count| count + 1)));
+}
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        count_allocation();
+        unsafe { System.alloc(layout) }
+    }
+
+    unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
+        count_allocation();
+        unsafe { System.alloc_zeroed(layout) }
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        count_allocation();
+        unsafe { System.realloc(ptr, layout, new_size) }
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        unsafe { System.dealloc(ptr, layout) }
+    }
+}
+
+#[global_allocator]
+static ALLOCATOR: CountingAllocator = CountingAllocator;
+
+fn allocations_during<R>(f: impl FnOnce() -> R) -> (R, usize) {
+    ALLOCATIONS.with(|count| count.set(Some(0)));
+    let result = f();
+    let count = ALLOCATIONS.with(|count| count.take()).unwrap_or(0);
+    (result, count)
+}
+
+// Answers every command with a response frame prepared up front, so that
+// neither sending nor receiving touches the heap.
+struct CannedTransport {
+    responses: Vec<(u8, Vec<u8>)>,
+    command: u8,
+    ack_pending: bool,
+}
+
+impl CannedTransport {
+    fn new(responses: &[(u8, &[u8])]) -> Self {
+        Self {
+            responses: responses
+                .iter()
+                .map(|(command, payload)| (*command, response_frame(*command, payload)))
+                .collect(),
+            command: 0,
+            ack_pending: false,
+        }
+    }
+}
+
+impl Pn53xTransport for CannedTransport {
+    fn send(&mut self, payload: &[u8], _timeout_ms: i32) -> Result<(), Error> {
+        self.command = payload[6];
+        self.ack_pending = true;
+        Ok(())
+    }
+
+    fn receive(&mut self, buffer: &mut [u8], _timeout_ms: i32) -> Result<usize, Error> {
+        let frame: &[u8] = if std::mem::take(&mut self.ack_pending) {
+            &PN53X_ACK_FRAME
+        } else {
+            self.responses
+                .iter()
+                .find(|(command, _)| *command == self.command)
+                .map(|(_, frame)| frame.as_slice())
+                .ok_or_else(|| status_error("receive", NFC_ETIMEOUT))?
+        };
+        buffer[..frame.len()].copy_from_slice(frame);
+        Ok(frame.len())
+    }
+
+    fn abort_command(&mut self) -> Result<(), Error> {
+        Ok(())
+    }
+}
+
+#[test]
+fn transceive_bytes_does_not_allocate() {
+    let transport = CannedTransport::new(&[
+        (PN532_SAM_CONFIGURATION, &[]),
+        (PN53X_GET_FIRMWARE_VERSION, &[0x32, 0x01, 0x06, 0x07]),
+        (PN53X_IN_DATA_EXCHANGE, &[0x00, 0x90, 0x00]),
+        (PN53X_IN_COMMUNICATE_THRU, &[0x00, 0x04, 0x00]),
+    ]);
+    let mut device = Pn53xDevice::probe_with_profile(
+        "PN532",
+        ConnectionString::new("pn532_uart:/dev/null:115200").unwrap(),
+        Pn53xProfile::pn532("pn532_uart"),
+        transport,
+        25,
+    )
+    .unwrap();
+    let mut rx = [0u8; 8];
+
+    let (written, allocations) =
+        allocations_during(|| device.transceive_bytes(&[0x30, 0x04], &mut rx, 250));
+    assert_eq!(written.unwrap(), 2);
+    assert_eq!(&rx[..2], &[0x90, 0x00]);
+    assert_eq!(allocations, 0);
+
+    device.core.properties.easy_framing = false;
+    let (written, allocations) =
+        allocations_during(|| device.transceive_bytes(&[0x26], &mut rx, 250));
+    assert_eq!(written.unwrap(), 2);
+    assert_eq!(&rx[..2], &[0x04, 0x00]);
+    assert_eq!(allocations, 0);
+}
+
 #[test]
 fn hidden_pn53x_helpers_route_through_shared_core() {
     let mut device = probed_device();
     queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x12]);
     assert_eq!(device.pn53x_read_register(0x6302).unwrap(), 0x12);
 
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x12]);
+    // The read above seeded the register shadow, so no second read is sent.
     queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
     device.pn53x_write_register(0x6302, 0x0f, 0x05).unwrap();
 
@@ -356,10 +495,8 @@ fn ack_frame_helper_matches_prefix() {
 #[test]
 fn parse_response_frame_validates_payload_and_command() {
     let frame = response_frame(0x02, &[0x32, 0x01, 0x06, 0x07]);
-    assert_eq!(
-        parse_response_frame(&frame, 0x02).unwrap(),
-        vec![0x32, 0x01, 0x06, 0x07]
-    );
+    let payload = parse_response_frame(&frame, 0x02).unwrap();
+    assert_eq!(&frame[payload], &[0x32, 0x01, 0x06, 0x07]);
 }
 
 #[test]
@@ -403,6 +540,68 @@ fn probe_builds_pure_rust_device_and_reports_information() {
     );
 }
 
+#[test]
+fn negotiate_serial_speed_raises_both_ends_and_reports_the_rate() {
+    let mut device = probed_device();
+    device.transport.sent.clear();
+    queue_command_response(&mut device.transport, PN532_SET_SERIAL_BAUD_RATE, &[]);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_GET_FIRMWARE_VERSION,
+        &[0x32, 0x01, 0x06, 0x07],
+    );
+
+    device.negotiate_serial_speed(115_200, 1_000_000).unwrap();
+
+    // 921600 baud is BR code 0x07; the host confirms the answer with an ACK.
+    assert_eq!(
+        device.transport.sent[0][6..8],
+        [PN532_SET_SERIAL_BAUD_RATE, 0x07]
+    );
+    assert_eq!(device.transport.sent[1], PN53X_ACK_FRAME);
+    assert_eq!(device.transport.line_speeds, [921_600]);
+    assert_eq!(
+        device.information_about().unwrap(),
+        "PN532 firmware v1.6 support=0x07 via pn532_uart:/dev/null:115200, \
+         serial link at 921600 baud"
+    );
+}
+
+#[test]
+fn negotiate_serial_speed_falls_back_when_the_chip_goes_silent() {
+    let mut device = probed_device();
+    queue_command_response(&mut device.transport, PN532_SET_SERIAL_BAUD_RATE, &[]);
+    // Nothing answers at 921600 baud; the chip still answers at 115200.
+    device
+        .transport
+        .received
+        .push_back(PN53X_ACK_FRAME[..3].to_vec());
+    queue_command_response(
+        &mut device.transport,
+        PN53X_GET_FIRMWARE_VERSION,
+        &[0x32, 0x01, 0x06, 0x07],
+    );
+
+    device.negotiate_serial_speed(115_200, 921_600).unwrap();
+
+    assert_eq!(device.transport.line_speeds, [921_600, 115_200]);
+    assert_eq!(
+        device.information_about().unwrap(),
+        "PN532 firmware v1.6 support=0x07 via pn532_uart:/dev/null:115200"
+    );
+}
+
+#[test]
+fn negotiate_serial_speed_leaves_slower_limits_alone() {
+    let mut device = probed_device();
+    device.transport.sent.clear();
+
+    device.negotiate_serial_speed(115_200, 200_000).unwrap();
+
+    assert!(device.transport.sent.is_empty());
+    assert!(device.transport.line_speeds.is_empty());
+}
+
 #[test]
 fn device_property_state_and_initiator_defaults_are_pure_rust() {
     let mut transport = FakeTransport::default();
@@ -459,9 +658,37 @@ fn abort_command_delegates_to_transport() {
         25,
     )
     .unwrap();
+    device.core.registers.record(PN53X_REG_CIU_TMODE, 0x80);
     device.abort_command().unwrap();
 
     assert_eq!(device.transport.abort_calls, 1);
+    assert_eq!(device.core.registers.get(PN53X_REG_CIU_TMODE), Some(0x80));
+}
+
+#[test]
+fn aborted_response_wait_cancels_the_command_on_the_chip() {
+    let mut device = probed_device();
+    device
+        .transport
+        .received
+        .push_back(PN53X_ACK_FRAME.to_vec());
+    device.abort_command().unwrap();
+
+    let error = device
+        .select_passive_target(
+            Modulation {
+                modulation_type: ModulationType::Iso14443A,
+                baud_rate: BaudRate::Br106,
+            },
+            None,
+        )
+        .unwrap_err();
+
+    assert_eq!(status_code(&error), NFC_EOPABORTED);
+    assert_eq!(
+        device.transport.sent.last().map(Vec::as_slice),
+        Some(&PN53X_ACK_FRAME[..])
+    );
 }
 
 #[test]
@@ -526,6 +753,156 @@ fn select_passive_target_decodes_iso14443a_and_tracks_current_target() {
     assert_eq!(device.core.current_target(), Some(&target));
 }
 
+// ISO14443-4 target (SAK 0x20) whose ATS announces TA(1) = 0x33: 212 and 424
+// kbps in both directions.
+const ISO_DEP_TARGET_RECORD: [u8; 15] = [
+    0x01, 0x01, 0x04, 0x00, 0x20, 0x04, 0xde, 0xad, 0xbe, 0xef, 0x05, 0x78, 0x33, 0x81, 0x02,
+];
+
+fn select_iso_dep_target(device: &mut Pn53xDevice<FakeTransport>) -> Target {
+    device
+        .select_passive_target(
+            Modulation {
+                modulation_type: ModulationType::Iso14443A,
+                baud_rate: BaudRate::Br106,
+            },
+            None,
+        )
+        .unwrap()
+        .unwrap()
+}
+
+fn sent_commands(device: &Pn53xDevice<FakeTransport>) -> Vec<u8> {
+    device.transport.sent.iter().map(|frame| frame[6]).collect()
+}
+
+#[test]
+fn auto_bit_rate_switches_iso_dep_targets_with_in_psl() {
+    let mut device = probed_device();
+    device
+        .set_property_bool(Property::AutoBitRate, true)
+        .unwrap();
+    device.transport.sent.clear();
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &ISO_DEP_TARGET_RECORD,
+    );
+    queue_command_response(&mut device.transport, PN53X_IN_PSL, &[0x00]);
+
+    let target = select_iso_dep_target(&mut device);
+
+    assert_eq!(
+        sent_commands(&device),
+        [PN53X_IN_LIST_PASSIVE_TARGET, PN53X_IN_PSL]
+    );
+    // PN532 tops out at 424 kbps.
+    assert_eq!(
+        device.transport.sent[1][6..10],
+        [PN53X_IN_PSL, 0x01, 0x02, 0x02]
+    );
+    assert_eq!(target.modulation.baud_rate, BaudRate::Br424);
+    assert_eq!(device.core.current_target(), Some(&target));
+}
+
+#[test]
+fn auto_bit_rate_keeps_106_kbps_when_in_psl_fails() {
+    let mut device = probed_device();
+    device
+        .set_property_bool(Property::AutoBitRate, true)
+        .unwrap();
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &ISO_DEP_TARGET_RECORD,
+    );
+    queue_command_response(&mut device.transport, PN53X_IN_PSL, &[0x01]);
+
+    let target = select_iso_dep_target(&mut device);
+
+    assert_eq!(target.modulation.baud_rate, BaudRate::Br106);
+    assert_eq!(device.core.current_target(), Some(&target));
+    assert_eq!(device.last_error(), 0);
+}
+
+#[test]
+fn auto_bit_rate_reports_a_transport_failure_during_in_psl() {
+    let mut device = probed_device();
+    device
+        .set_property_bool(Property::AutoBitRate, true)
+        .unwrap();
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &ISO_DEP_TARGET_RECORD,
+    );
+    // No InPSL response queued: the link times out.
+
+    let result = device.select_passive_target(
+        Modulation {
+            modulation_type: ModulationType::Iso14443A,
+            baud_rate: BaudRate::Br106,
+        },
+        None,
+    );
+
+    assert!(result.is_err());
+    assert_eq!(device.last_error(), NFC_ETIMEOUT);
+}
+
+#[test]
+fn auto_bit_rate_upgrades_iso_dep_targets_of_a_batch_by_their_number() {
+    let mut device = probed_device();
+    device
+        .set_property_bool(Property::AutoBitRate, true)
+        .unwrap();
+    device.transport.sent.clear();
+    // A MIFARE Classic as Tg 1, then the ISO-DEP card as Tg 2.
+    let mut response = vec![0x02, 0x01, 0x00, 0x04, 0x08, 0x04, 0xde, 0xad, 0xbe, 0xef];
+    response.push(0x02);
+    response.extend_from_slice(&ISO_DEP_TARGET_RECORD[2..]);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &response,
+    );
+    queue_command_response(&mut device.transport, PN53X_IN_PSL, &[0x00]);
+
+    let nm = Modulation {
+        modulation_type: ModulationType::Iso14443A,
+        baud_rate: BaudRate::Br106,
+    };
+    let targets = device.list_passive_targets_driver(nm, &[], 2).unwrap();
+
+    assert_eq!(
+        sent_commands(&device),
+        [PN53X_IN_LIST_PASSIVE_TARGET, PN53X_IN_PSL]
+    );
+    assert_eq!(
+        device.transport.sent[1][6..10],
+        [PN53X_IN_PSL, 0x02, 0x02, 0x02]
+    );
+    assert_eq!(targets[0].modulation.baud_rate, BaudRate::Br106);
+    assert_eq!(targets[1].modulation.baud_rate, BaudRate::Br424);
+    assert_eq!(device.core.current_target(), Some(&targets[0]));
+}
+
+#[test]
+fn iso_dep_targets_stay_at_106_kbps_without_auto_bit_rate() {
+    let mut device = probed_device();
+    device.transport.sent.clear();
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &ISO_DEP_TARGET_RECORD,
+    );
+
+    let target = select_iso_dep_target(&mut device);
+
+    assert_eq!(sent_commands(&device), [PN53X_IN_LIST_PASSIVE_TARGET]);
+    assert_eq!(target.modulation.baud_rate, BaudRate::Br106);
+}
+
 #[test]
 fn select_dep_target_and_deselect_share_runtime_logic() {
     let mut device = probed_device();
@@ -563,6 +940,75 @@ fn select_dep_target_and_deselect_share_runtime_logic() {
     assert!(device.core.current_target().is_none());
 }
 
+#[test]
+fn transceive_bytes_chains_large_commands_in_extended_frames() {
+    let mut device = probed_device();
+    let sent_before = device.transport.sent.len();
+    let apdu: Vec<u8> = (0..300u16).map(|index| index as u8).collect();
+    queue_command_response(&mut device.transport, PN53X_IN_DATA_EXCHANGE, &[0x00]);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_DATA_EXCHANGE,
+        &[0x00, 0x90, 0x00],
+    );
+
+    let mut rx = [0u8; 8];
+    let written = device.transceive_bytes(&apdu, &mut rx, 250).unwrap();
+    assert_eq!(&rx[..written], &[0x90, 0x00]);
+
+    let frames = &device.transport.sent[sent_before..];
+    assert_eq!(frames.len(), 2);
+    // Extended frame: 00 00 ff ff ff LENm LENl LCS D4 40 Tg data...
+    assert_eq!(&frames[0][3..5], &[0xff, 0xff]);
+    assert_eq!(&frames[0][9..11], &[PN53X_IN_DATA_EXCHANGE, 0x41]);
+    assert_eq!(&frames[0][11..frames[0].len() - 2], &apdu[..262]);
+    assert_eq!(&frames[1][6..8], &[PN53X_IN_DATA_EXCHANGE, 0x01]);
+    assert_eq!(&frames[1][8..frames[1].len() - 2], &apdu[262..]);
+}
+
+#[test]
+fn transceive_bytes_fetches_chained_responses() {
+    let mut device = probed_device();
+    let sent_before = device.transport.sent.len();
+    let mut first = vec![PN53X_MORE_INFORMATION];
+    first.extend(0..200u8);
+    let mut last = vec![0x00];
+    last.extend(200..255u8);
+    queue_command_response(&mut device.transport, PN53X_IN_DATA_EXCHANGE, &first);
+    queue_command_response(&mut device.transport, PN53X_IN_DATA_EXCHANGE, &last);
+
+    let mut rx = [0u8; 300];
+    let written = device
+        .transceive_bytes(&[0x00, 0xb0, 0x00, 0x00, 0x00], &mut rx, 250)
+        .unwrap();
+    assert_eq!(written, 255);
+    assert!(rx[..written].iter().copied().eq(0..255u8));
+
+    let frames = &device.transport.sent[sent_before..];
+    assert_eq!(frames.len(), 2);
+    assert_eq!(
+        &frames[1][6..frames[1].len() - 2],
+        &[PN53X_IN_DATA_EXCHANGE, 0x01]
+    );
+}
+
+#[test]
+fn chained_responses_larger_than_rx_overflow() {
+    let mut device = probed_device();
+    let mut first = vec![PN53X_MORE_INFORMATION];
+    first.extend([0xaa; 7]);
+    queue_command_response(&mut device.transport, PN53X_IN_DATA_EXCHANGE, &first);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_DATA_EXCHANGE,
+        &[0x00, 0xbb, 0xbb],
+    );
+
+    let mut rx = [0u8; 8];
+    let error = device.transceive_bytes(&[0x00], &mut rx, 250).unwrap_err();
+    assert_eq!(status_code(&error), NFC_EOVFLOW);
+}
+
 #[test]
 fn transceive_bytes_and_timed_variant_use_shared_timer_register_flow() {
     let mut device = probed_device();
@@ -588,29 +1034,101 @@ fn transceive_bytes_and_timed_variant_use_shared_timer_register_flow() {
     device
         .set_property_bool(Property::HandleCrc, false)
         .unwrap();
+    // The timer setup rides in the same WriteRegister frame as the FIFO.
     queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
-    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x01]);
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0xaa, 0x00]);
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0xf0, 0x00]);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_READ_REGISTER,
+        &[SYMBOL_RX_IRQ, 0x01, 0x00, 0xf0, 0x00],
+    );
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0xaa]);
+    let sent_before = device.transport.sent.len();
 
     let (timed_written, elapsed) = device.transceive_bytes_timed(&[0x50], &mut rx).unwrap();
     assert_eq!(timed_written, 1);
     assert_eq!(&rx[..timed_written], &[0xaa]);
     assert_eq!(elapsed, 3568);
+    assert_eq!(device.transport.sent.len() - sent_before, 3);
+}
+
+fn read_register_addresses(frame: &[u8]) -> Vec<u16> {
+    assert_eq!(frame[6], PN53X_READ_REGISTER);
+    frame[7..frame.len() - 2]
+        .chunks_exact(2)
+        .map(|address| u16::from(address[0]) << 8 | u16::from(address[1]))
+        .collect()
 }
 
 #[test]
-fn target_init_and_target_byte_io_are_shared() {
+fn timed_receive_drains_what_each_sample_saw_until_reception_ends() {
     let mut device = probed_device();
     device
-        .transport
-        .received
-        .push_back(PN53X_ACK_FRAME.to_vec());
-    device
-        .transport
-        .received
-        .push_back(response_frame(PN53X_TG_INIT_AS_TARGET, &[0x04, 0xca, 0xfe]));
+        .set_property_bool(Property::EasyFraming, false)
+        .unwrap();
+    device
+        .set_property_bool(Property::HandleCrc, false)
+        .unwrap();
+    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    // Nothing yet, then two bytes while the frame is still arriving, then
+    // the rest once RxIRq is up.
+    queue_command_response(
+        &mut device.transport,
+        PN53X_READ_REGISTER,
+        &[0x00, 0x00, 0x00, 0xff, 0xff],
+    );
+    queue_command_response(
+        &mut device.transport,
+        PN53X_READ_REGISTER,
+        &[0x00, 0x02, 0x00, 0xf0, 0x00],
+    );
+    queue_command_response(
+        &mut device.transport,
+        PN53X_READ_REGISTER,
+        &[0x01, 0x02, SYMBOL_RX_IRQ, 0x01, 0x00, 0xf0, 0x00],
+    );
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x03]);
+    let sent_before = device.transport.sent.len();
+
+    let mut rx = [0u8; 8];
+    let (written, elapsed) = device.transceive_bytes_timed(&[0x50], &mut rx).unwrap();
+
+    assert_eq!(&rx[..written], &[0x01, 0x02, 0x03]);
+    assert_eq!(elapsed, 3568);
+    let sample = [
+        PN53X_REG_CIU_COMM_IRQ,
+        PN53X_REG_CIU_FIFO_LEVEL,
+        PN53X_REG_CIU_CONTROL,
+        PN53X_REG_CIU_TCOUNTER_VAL_HI,
+        PN53X_REG_CIU_TCOUNTER_VAL_LO,
+    ];
+    let reads = device.transport.sent[sent_before + 1..]
+        .iter()
+        .map(|frame| read_register_addresses(frame))
+        .collect::<Vec<_>>();
+    let mut drain_and_sample = vec![PN53X_REG_CIU_FIFO_DATA; 2];
+    drain_and_sample.extend_from_slice(&sample);
+    assert_eq!(
+        reads,
+        [
+            sample.to_vec(),
+            sample.to_vec(),
+            drain_and_sample,
+            vec![PN53X_REG_CIU_FIFO_DATA],
+        ]
+    );
+}
+
+#[test]
+fn target_init_and_target_byte_io_are_shared() {
+    let mut device = probed_device();
+    device
+        .transport
+        .received
+        .push_back(PN53X_ACK_FRAME.to_vec());
+    device
+        .transport
+        .received
+        .push_back(response_frame(PN53X_TG_INIT_AS_TARGET, &[0x04, 0xca, 0xfe]));
     device
         .transport
         .received
@@ -668,6 +1186,70 @@ fn wrap_and_unwrap_frame_preserve_parity_bits() {
     assert_eq!(&parity[..2], &[1, 0]);
 }
 
+#[test]
+fn grouped_wrap_frame_matches_the_bitwise_reference() {
+    let mut rng = TestRng(0x51_7cc1_b727_220a);
+    for tx_bits_len in 0..=8 * 40 {
+        let tx_bytes_len = bits_to_bytes_len(tx_bits_len);
+        for _ in 0..8 {
+            let mut tx = vec![0u8; tx_bytes_len];
+            let mut parity = vec![0u8; tx_bytes_len];
+            rng.fill(&mut tx);
+            rng.fill(&mut parity);
+            assert_eq!(
+                pn53x_wrap_frame(&tx, tx_bits_len, Some(&parity)),
+                pn53x_wrap_frame_bitwise(&tx, tx_bits_len, Some(&parity)),
+                "{tx_bits_len} bits: {tx:02x?} {parity:02x?}"
+            );
+        }
+    }
+}
+
+#[test]
+fn grouped_unwrap_frame_matches_the_bitwise_reference() {
+    let mut rng = TestRng(0x2b99_2ddf_a232_49d6);
+    for frame_bits_len in 0..=9 * 40 {
+        // The reference may read one byte past the frame bits.
+        let mut frame = vec![0u8; bits_to_bytes_len(frame_bits_len) + 1];
+        let rx_bytes_len = bits_to_bytes_len(frame_bits_len - frame_bits_len / 9).max(1);
+        for _ in 0..8 {
+            rng.fill(&mut frame);
+            let mut rx = vec![0u8; rx_bytes_len];
+            let mut parity = vec![0u8; rx_bytes_len];
+            let mut expected_rx = vec![0u8; rx_bytes_len];
+            let mut expected_parity = vec![0u8; rx_bytes_len];
+            assert_eq!(
+                pn53x_unwrap_frame(&frame, frame_bits_len, &mut rx, Some(&mut parity)),
+                pn53x_unwrap_frame_bitwise(
+                    &frame,
+                    frame_bits_len,
+                    &mut expected_rx,
+                    Some(&mut expected_parity)
+                ),
+                "{frame_bits_len} bits: {frame:02x?}"
+            );
+            assert_eq!(rx, expected_rx, "{frame_bits_len} bits: {frame:02x?}");
+            assert_eq!(
+                parity, expected_parity,
+                "{frame_bits_len} bits: {frame:02x?}"
+            );
+        }
+    }
+}
+
+#[test]
+fn grouped_unwrap_frame_tolerates_short_parity_buffers() {
+    let wrapped = pn53x_wrap_frame(&[0x93, 0x20, 0x0f], 20, Some(&[1, 0, 1])).unwrap();
+    let mut rx = [0u8; 3];
+    let mut parity = [0u8; 2];
+    let bits = pn53x_unwrap_frame(&wrapped, 22, &mut rx, Some(&mut parity)).unwrap();
+
+    assert_eq!(bits, 20);
+    assert_eq!(&rx[..2], &[0x93, 0x20]);
+    assert_eq!(rx[2] & 0x0f, 0x0f);
+    assert_eq!(parity, [1, 0]);
+}
+
 #[test]
 fn transceive_bits_supports_short_frames_with_register_backed_last_bits() {
     let mut device = probed_device();
@@ -735,18 +1317,14 @@ fn transceive_bits_timed_uses_shared_register_timer_flow() {
         .set_property_bool(Property::HandleCrc, false)
         .unwrap();
     let wrapped = pn53x_wrap_frame(&[0x93, 0x20], 16, Some(&[1, 0])).unwrap();
-    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    // The timer setup rides in the same WriteRegister frame as the FIFO.
     queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
     queue_command_response(
         &mut device.transport,
         PN53X_READ_REGISTER,
-        &[wrapped.len() as u8],
+        &[SYMBOL_RX_IRQ, wrapped.len() as u8, 0x02, 0xf0, 0x00],
     );
-    let mut fifo_payload = wrapped.clone();
-    fifo_payload.push(0x00);
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &fifo_payload);
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x02]);
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0xf0, 0x00]);
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &wrapped);
 
     let mut rx = [0u8; 8];
     let mut parity = [0u8; 8];
@@ -792,15 +1370,14 @@ fn timed_bytes_reads_tx_mode_before_register_timed_exchange() {
         PN53X_READ_REGISTER,
         &[SYMBOL_TX_CRC_ENABLE],
     );
+    // The timer setup rides in the same WriteRegister frame as the FIFO.
     queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
-    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x02]);
     queue_command_response(
         &mut device.transport,
         PN53X_READ_REGISTER,
-        &[0x90, 0x00, 0x00],
+        &[SYMBOL_RX_IRQ, 0x02, 0x00, 0xf0, 0x00],
     );
-    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0xf0, 0x00]);
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x90, 0x00]);
 
     let mut rx = [0u8; 4];
     let (written, elapsed) = device.transceive_bytes_timed(&[0x00], &mut rx).unwrap();
@@ -866,3 +1443,588 @@ fn target_is_present_for_mifare_classic_reselects_saved_uid() {
 
     assert!(device.target_is_present(Some(&target)).unwrap());
 }
+
+fn mifare_classic_target() -> Target {
+    Target {
+        modulation: Modulation {
+            modulation_type: ModulationType::Iso14443A,
+            baud_rate: BaudRate::Br106,
+        },
+        info: TargetInfo::Iso14443A {
+            atqa: [0x00, 0x04],
+            sak: 0x08,
+            uid: vec![0xde, 0xad, 0xbe, 0xef],
+            ats: Vec::new(),
+        },
+    }
+}
+
+#[test]
+fn presence_window_trusts_a_recent_answer_until_the_field_drops() {
+    let mut device = probed_device();
+    device
+        .set_property_int(Property::PresenceWindow, 60_000)
+        .unwrap();
+    let target = mifare_classic_target();
+    device.core.remember_target(target.clone());
+    let sent_before = device.transport.sent.len();
+
+    for _ in 0..3 {
+        assert!(device.target_is_present(Some(&target)).unwrap());
+    }
+    assert_eq!(device.transport.sent.len(), sent_before);
+
+    // Without the field the last answer proves nothing: reselect.
+    device
+        .set_property_bool(Property::ActivateField, false)
+        .unwrap();
+    queue_command_response(&mut device.transport, PN53X_IN_LIST_PASSIVE_TARGET, &[0x00]);
+    assert!(!device.target_is_present(Some(&target)).unwrap());
+    assert_eq!(
+        device.transport.sent[sent_before][6],
+        PN53X_IN_LIST_PASSIVE_TARGET
+    );
+}
+
+#[test]
+fn presence_window_probes_once_an_answer_is_too_old() {
+    let mut device = probed_device();
+    device
+        .set_property_int(Property::PresenceWindow, 5)
+        .unwrap();
+    let target = mifare_classic_target();
+    device.core.remember_target(target.clone());
+    std::thread::sleep(Duration::from_millis(10));
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &[0x01, 0x01, 0x00, 0x04, 0x08, 0x04, 0xde, 0xad, 0xbe, 0xef],
+    );
+    let sent_before = device.transport.sent.len();
+
+    assert!(device.target_is_present(Some(&target)).unwrap());
+    assert_eq!(device.transport.sent.len(), sent_before + 1);
+    // The reselect counts as an answer again.
+    assert!(device.target_is_present(Some(&target)).unwrap());
+    assert_eq!(device.transport.sent.len(), sent_before + 1);
+}
+
+#[test]
+fn presence_window_probes_iso_dep_targets_with_diagnose() {
+    let mut device = probed_device();
+    device
+        .set_property_int(Property::PresenceWindow, 5)
+        .unwrap();
+    let target = Target {
+        modulation: Modulation {
+            modulation_type: ModulationType::Iso14443A,
+            baud_rate: BaudRate::Br106,
+        },
+        info: TargetInfo::Iso14443A {
+            atqa: [0x00, 0x04],
+            sak: 0x20,
+            uid: vec![0xde, 0xad, 0xbe, 0xef],
+            ats: vec![0x78, 0x33, 0x81, 0x02],
+        },
+    };
+    device.core.remember_target(target.clone());
+    device.core.forget_target_answer();
+    queue_command_response(&mut device.transport, 0x00, &[0x00]);
+    let sent_before = device.transport.sent.len();
+
+    assert!(device.target_is_present(Some(&target)).unwrap());
+    assert_eq!(device.transport.sent.len(), sent_before + 1);
+    assert_eq!(device.transport.sent[sent_before][6..8], [0x00, 0x06]);
+    assert_eq!(
+        device.transport.receive_timeouts.last(),
+        Some(&device.core.timeout_command_ms)
+    );
+    assert_eq!(device.core.properties, PropertyState::default());
+}
+
+#[test]
+fn presence_window_rejects_negative_values() {
+    let mut device = probed_device();
+    let error = device
+        .set_property_int(Property::PresenceWindow, -1)
+        .unwrap_err();
+    assert!(matches!(error, Error::InvalidArgument(_)));
+}
+
+fn open_identified(
+    transport: FakeTransport,
+    identity: &ChipIdentityKey,
+) -> Pn53xDevice<FakeTransport> {
+    Pn53xDevice::open_with_profile(
+        "PN532",
+        ConnectionString::new("pn532_uart:/dev/null:115200").unwrap(),
+        Pn53xProfile::pn532("pn532_uart"),
+        transport,
+        25,
+        Some(identity.clone()),
+    )
+    .unwrap()
+}
+
+#[test]
+fn session_reset_restores_open_time_settings() {
+    let mut device = probed_device();
+    device.set_default_timeout_command(1_000);
+    device
+        .set_property_bool(Property::EasyFraming, false)
+        .unwrap();
+    device
+        .set_property_int(Property::TimeoutCommand, 20)
+        .unwrap();
+    device
+        .set_property_int(Property::PresenceWindow, 300)
+        .unwrap();
+    device.core.current_target = Some(mifare_classic_target());
+
+    device.reset_session_driver().unwrap();
+    assert_eq!(device.core.properties, PropertyState::default());
+    assert_eq!(device.core.timeout_command_ms, 1_000);
+    assert_eq!(device.core.presence_window_ms, 0);
+    assert!(device.core.current_target.is_none());
+}
+
+#[test]
+fn reopening_an_identified_chip_skips_the_firmware_probe() {
+    let identity = ChipIdentityKey::new(
+        &ConnectionString::new("pn532_uart:/dev/null:115200").unwrap(),
+        identity::NodeIdentity::Usb {
+            bus: 0xfe,
+            address: 0x01,
+        },
+    );
+    let mut transport = FakeTransport::default();
+    queue_probe_responses(&mut transport);
+    let first = open_identified(transport, &identity);
+    assert_eq!(first.transport.sent.len(), 2);
+
+    let mut reopened = open_identified(FakeTransport::default(), &identity);
+    assert!(reopened.transport.sent.is_empty());
+    assert_eq!(reopened.core.chip_type(), Pn53xType::Pn532);
+    assert_eq!(
+        reopened.information_about().unwrap(),
+        "PN532 firmware v1.6 support=0x07 via pn532_uart:/dev/null:115200"
+    );
+}
+
+#[test]
+fn io_error_forgets_the_cached_chip_identity() {
+    let identity = ChipIdentityKey::new(
+        &ConnectionString::new("pn532_uart:/dev/null:115200").unwrap(),
+        identity::NodeIdentity::Usb {
+            bus: 0xfe,
+            address: 0x02,
+        },
+    );
+    let mut transport = FakeTransport::default();
+    queue_probe_responses(&mut transport);
+    let mut device = open_identified(transport, &identity);
+    assert!(identity::lookup(&identity).is_some());
+
+    device
+        .transport
+        .received
+        .push_back(PN53X_ACK_FRAME.to_vec());
+    device.transport.received.push_back(vec![0x00, 0x00, 0xff]);
+    assert!(device.pn53x_read_register(0x6302).is_err());
+    assert_eq!(device.last_error(), NFC_EIO);
+    assert!(identity::lookup(&identity).is_none());
+}
+
+#[test]
+fn timeout_forgets_the_cached_chip_identity() {
+    let identity = ChipIdentityKey::new(
+        &ConnectionString::new("pn532_uart:/dev/null:115200").unwrap(),
+        identity::NodeIdentity::Usb {
+            bus: 0xfe,
+            address: 0x03,
+        },
+    );
+    let mut transport = FakeTransport::default();
+    queue_probe_responses(&mut transport);
+    let mut device = open_identified(transport, &identity);
+    assert!(identity::lookup(&identity).is_some());
+
+    assert!(device.pn53x_read_register(0x6302).is_err());
+    assert_eq!(device.last_error(), NFC_ETIMEOUT);
+    assert!(identity::lookup(&identity).is_none());
+}
+
+#[test]
+fn shadowed_register_updates_skip_the_read_back() {
+    let mut device = probed_device();
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x80]);
+    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    device
+        .pn53x_write_register(PN53X_REG_CIU_TX_MODE, 0x0f, 0x03)
+        .unwrap();
+
+    let sent_before = device.transport.sent.len();
+    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    device
+        .pn53x_write_register(PN53X_REG_CIU_TX_MODE, 0x80, 0x00)
+        .unwrap();
+    assert_eq!(device.transport.sent.len(), sent_before + 1);
+    assert_eq!(
+        &device.transport.sent[sent_before][6..10],
+        &[PN53X_WRITE_REGISTER, 0x63, 0x02, 0x03]
+    );
+
+    // Unchanged bits need no exchange at all.
+    device
+        .pn53x_write_register(PN53X_REG_CIU_TX_MODE, 0x0f, 0x03)
+        .unwrap();
+    assert_eq!(
+        device.pn53x_read_register(PN53X_REG_CIU_TX_MODE).unwrap(),
+        0x03
+    );
+    assert_eq!(device.transport.sent.len(), sent_before + 1);
+}
+
+#[test]
+fn volatile_registers_are_always_read_from_the_chip() {
+    let mut device = probed_device();
+    for level in [0x02, 0x05] {
+        queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[level]);
+        assert_eq!(
+            device
+                .pn53x_read_register(PN53X_REG_CIU_FIFO_LEVEL)
+                .unwrap(),
+            level
+        );
+    }
+
+    // StartSend is not kept in the shadowed BitFraming value.
+    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    device
+        .pn53x_write_register(PN53X_REG_CIU_BIT_FRAMING, 0xff, SYMBOL_START_SEND | 0x07)
+        .unwrap();
+    assert_eq!(
+        device
+            .pn53x_read_register(PN53X_REG_CIU_BIT_FRAMING)
+            .unwrap(),
+        0x07
+    );
+}
+
+#[test]
+fn power_down_and_errors_invalidate_the_register_shadow() {
+    let mut device = probed_device();
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x11]);
+    assert_eq!(
+        device.pn53x_read_register(PN53X_REG_CIU_TX_MODE).unwrap(),
+        0x11
+    );
+    device.core.registers.record(PN53X_REG_CIU_TMODE, 0x80);
+
+    device.powerdown_driver().unwrap();
+    assert_eq!(device.core.registers.get(PN53X_REG_CIU_TX_MODE), None);
+    assert_eq!(device.core.registers.get(PN53X_REG_CIU_TMODE), None);
+
+    device.core.power_mode = Pn53xPowerMode::Normal;
+    device.core.registers.record(PN53X_REG_CIU_TX_MODE, 0x11);
+    assert!(
+        device
+            .pn53x_read_register(PN53X_REG_CIU_FIFO_LEVEL)
+            .is_err()
+    );
+    assert_eq!(device.core.registers.get(PN53X_REG_CIU_TX_MODE), None);
+}
+
+#[test]
+fn deferred_register_writes_share_one_frame_before_the_next_command() {
+    let mut device = probed_device();
+    device
+        .set_property_bool(Property::EasyFraming, false)
+        .unwrap();
+    // What init_timer(0) and set_tx_bits(7) leave behind.
+    let queue_timer_and_tx_bits = |core: &mut Pn53xCore| {
+        core.pending_writes
+            .queue(PN53X_REG_CIU_TMODE, 0xff, SYMBOL_TAUTO);
+        core.pending_writes
+            .queue(PN53X_REG_CIU_TPRESCALER, 0xff, 0x00);
+        core.pending_writes
+            .queue(PN53X_REG_CIU_TRELOAD_VAL_HI, 0xff, 0xff);
+        core.pending_writes
+            .queue(PN53X_REG_CIU_TRELOAD_VAL_LO, 0xff, 0xff);
+        core.pending_writes
+            .queue(PN53X_REG_CIU_BIT_FRAMING, SYMBOL_TX_LAST_BITS, 0x07);
+        core.staged_tx_bits = Some(0x07);
+    };
+    queue_timer_and_tx_bits(&mut device.core);
+    let sent_before = device.transport.sent.len();
+
+    // The masked BitFraming update needs the register's current value; the
+    // full-width timer registers and the explicit write do not.
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x40]);
+    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    device
+        .pn53x_write_register(PN53X_REG_CIU_TX_MODE, 0xff, 0x00)
+        .unwrap();
+    assert_eq!(device.transport.sent.len(), sent_before + 2);
+    let write = &device.transport.sent[sent_before + 1];
+    assert_eq!(write[6], PN53X_WRITE_REGISTER);
+    assert_eq!(
+        &write[7..25],
+        &[
+            0x63,
+            0x1a,
+            SYMBOL_TAUTO,
+            0x63,
+            0x1b,
+            0x00,
+            0x63,
+            0x1c,
+            0xff,
+            0x63,
+            0x1d,
+            0xff,
+            0x63,
+            0x3d,
+            0x47,
+            0x63,
+            0x02,
+            0x00,
+        ]
+    );
+
+    // Clearing the last-bits field is written just ahead of the data command.
+    let sent_before = device.transport.sent.len();
+    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_COMMUNICATE_THRU,
+        &[0x00, 0x04],
+    );
+    device.transceive_bytes(&[0x26], &mut [0u8; 4], 25).unwrap();
+    assert_eq!(device.transport.sent.len(), sent_before + 2);
+    assert_eq!(
+        &device.transport.sent[sent_before][6..10],
+        &[PN53X_WRITE_REGISTER, 0x63, 0x3d, 0x40]
+    );
+    assert_eq!(
+        device.transport.sent[sent_before + 1][6],
+        PN53X_IN_COMMUNICATE_THRU
+    );
+
+    // Updates matching the shadow are dropped without an exchange.
+    queue_timer_and_tx_bits(&mut device.core);
+    device
+        .core
+        .pending_writes
+        .queue(PN53X_REG_CIU_BIT_FRAMING, SYMBOL_TX_LAST_BITS, 0x00);
+    assert_eq!(
+        device.pn53x_read_register(PN53X_REG_CIU_TMODE).unwrap(),
+        SYMBOL_TAUTO
+    );
+    assert!(device.core.pending_writes.is_empty());
+    assert_eq!(device.transport.sent.len(), sent_before + 2);
+}
+
+#[test]
+fn failed_register_flush_does_not_leave_tx_bits_cached() {
+    let mut device = probed_device();
+    let mut rx = [0u8; 4];
+
+    // The flush ahead of the data command gets no answer, so the queued
+    // TxLastBits update never reaches the chip.
+    assert!(
+        device
+            .transceive_bits(&[0x26], 7, None, &mut rx, None)
+            .is_err()
+    );
+    assert_eq!(device.core.tx_bits, None);
+    assert!(device.core.pending_writes.is_empty());
+
+    let sent_before = device.transport.sent.len();
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x00]);
+    queue_command_response(&mut device.transport, PN53X_WRITE_REGISTER, &[]);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_COMMUNICATE_THRU,
+        &[0x00, 0x04],
+    );
+    queue_command_response(&mut device.transport, PN53X_READ_REGISTER, &[0x00]);
+    device
+        .transceive_bits(&[0x26], 7, None, &mut rx, None)
+        .unwrap();
+    assert_eq!(
+        &device.transport.sent[sent_before + 1][6..10],
+        &[PN53X_WRITE_REGISTER, 0x63, 0x3d, 0x07]
+    );
+    assert_eq!(device.core.tx_bits, Some(0x07));
+}
+
+#[test]
+fn list_passive_targets_decodes_both_records_of_one_command() {
+    let mut device = probed_device();
+    let mut response = vec![0x02];
+    // An ISO14443-4 card with a 7-byte UID and an ATS ...
+    response.extend_from_slice(&[
+        0x01, 0x00, 0x44, 0x20, 0x07, 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x05, 0x75, 0x77,
+        0x81, 0x02,
+    ]);
+    // ... and a MIFARE Classic 1K.
+    response.extend_from_slice(&[0x02, 0x00, 0x04, 0x08, 0x04, 0xde, 0xad, 0xbe, 0xef]);
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &response,
+    );
+
+    let nm = Modulation {
+        modulation_type: ModulationType::Iso14443A,
+        baud_rate: BaudRate::Br106,
+    };
+    let targets = device.list_passive_targets_driver(nm, &[], 8).unwrap();
+    let sent = device.transport.sent.last().unwrap();
+    assert_eq!(&sent[6..9], &[PN53X_IN_LIST_PASSIVE_TARGET, 0x02, 0x00]);
+
+    assert_eq!(targets.len(), 2);
+    assert_eq!(
+        targets[0].info,
+        TargetInfo::Iso14443A {
+            atqa: [0x00, 0x44],
+            sak: 0x20,
+            uid: vec![0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66],
+            ats: vec![0x75, 0x77, 0x81, 0x02],
+        }
+    );
+    assert_eq!(
+        targets[1].info,
+        TargetInfo::Iso14443A {
+            atqa: [0x00, 0x04],
+            sak: 0x08,
+            uid: vec![0xde, 0xad, 0xbe, 0xef],
+            ats: Vec::new(),
+        }
+    );
+    assert_eq!(device.core.current_target(), Some(&targets[0]));
+}
+
+#[test]
+fn truncated_first_target_record_is_an_io_error() {
+    let mut device = probed_device();
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &[0x02, 0x01, 0x00, 0x04, 0x08, 0x07, 0xde, 0xad],
+    );
+    let nm = Modulation {
+        modulation_type: ModulationType::Iso14443A,
+        baud_rate: BaudRate::Br106,
+    };
+    let error = device.list_passive_targets_driver(nm, &[], 2).unwrap_err();
+    assert_eq!(status_code(&error), NFC_EIO);
+}
+
+#[test]
+fn pn532_poll_target_runs_in_firmware_with_in_auto_poll() {
+    let mut device = probed_device();
+    let modulations = [
+        Modulation {
+            modulation_type: ModulationType::Iso14443A,
+            baud_rate: BaudRate::Br106,
+        },
+        Modulation {
+            modulation_type: ModulationType::Felica,
+            baud_rate: BaudRate::Br212,
+        },
+    ];
+    let sent_before = device.transport.sent.len();
+    queue_command_response(
+        &mut device.transport,
+        PN532_IN_AUTO_POLL,
+        &[
+            0x01, 0x10, 0x09, 0x01, 0x00, 0x04, 0x08, 0x04, 0xde, 0xad, 0xbe, 0xef,
+        ],
+    );
+
+    let target = device.poll_target_driver(&modulations, 3, 2).unwrap();
+    assert_eq!(device.transport.sent.len(), sent_before + 1);
+    assert_eq!(
+        &device.transport.sent[sent_before][6..11],
+        &[PN532_IN_AUTO_POLL, 0x03, 0x02, 0x10, 0x11]
+    );
+    let target = target.unwrap();
+    assert_eq!(target.modulation, modulations[0]);
+    assert_eq!(
+        target.info,
+        TargetInfo::Iso14443A {
+            atqa: [0x00, 0x04],
+            sak: 0x08,
+            uid: vec![0xde, 0xad, 0xbe, 0xef],
+            ats: Vec::new(),
+        }
+    );
+    assert_eq!(device.core.current_target(), Some(&target));
+
+    queue_command_response(&mut device.transport, PN532_IN_AUTO_POLL, &[0x00]);
+    assert_eq!(device.poll_target_driver(&modulations, 1, 1).unwrap(), None);
+}
+
+#[test]
+fn in_auto_poll_decodes_both_targets_and_upgrades_the_first() {
+    let mut device = probed_device();
+    device
+        .set_property_bool(Property::AutoBitRate, true)
+        .unwrap();
+    let modulations = [Modulation {
+        modulation_type: ModulationType::Iso14443A,
+        baud_rate: BaudRate::Br106,
+    }];
+    // The ISO14443-4 target as Tg 1 ...
+    let mut response = vec![0x02, 0x20, (ISO_DEP_TARGET_RECORD.len() - 1) as u8];
+    response.extend_from_slice(&ISO_DEP_TARGET_RECORD[1..]);
+    // ... and a MIFARE Classic 1K as Tg 2.
+    response.extend_from_slice(&[
+        0x10, 0x09, 0x02, 0x00, 0x04, 0x08, 0x04, 0xde, 0xad, 0xbe, 0xef,
+    ]);
+    queue_command_response(&mut device.transport, PN532_IN_AUTO_POLL, &response);
+    queue_command_response(&mut device.transport, PN53X_IN_PSL, &[0x00]);
+    device.transport.sent.clear();
+
+    let target = device
+        .poll_target_driver(&modulations, 1, 1)
+        .unwrap()
+        .unwrap();
+    assert_eq!(sent_commands(&device), [PN532_IN_AUTO_POLL, PN53X_IN_PSL]);
+    assert_eq!(target.modulation.baud_rate, BaudRate::Br424);
+    assert_eq!(device.core.current_target(), Some(&target));
+
+    // A second record cut short fails the poll instead of being ignored.
+    response.truncate(response.len() - 2);
+    queue_command_response(&mut device.transport, PN532_IN_AUTO_POLL, &response);
+    let error = device.poll_target_driver(&modulations, 1, 1).unwrap_err();
+    assert_eq!(status_code(&error), NFC_EIO);
+}
+
+#[test]
+fn poll_target_falls_back_to_software_polling_without_in_auto_poll() {
+    let mut device = probed_device();
+    device.core.chip_type = Pn53xType::Pn533;
+    let modulation = Modulation {
+        modulation_type: ModulationType::Iso14443A,
+        baud_rate: BaudRate::Br106,
+    };
+    let sent_before = device.transport.sent.len();
+    queue_command_response(
+        &mut device.transport,
+        PN53X_IN_LIST_PASSIVE_TARGET,
+        &[0x00, 0x00],
+    );
+
+    assert_eq!(
+        device.poll_target_driver(&[modulation], 1, 1).unwrap(),
+        None
+    );
+    assert_eq!(device.transport.sent.len(), sent_before + 1);
+    assert_eq!(
+        device.transport.sent[sent_before][6],
+        PN53X_IN_LIST_PASSIVE_TARGET
+    );
+}
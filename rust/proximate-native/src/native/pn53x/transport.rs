@@ -1,12 +1,15 @@
+use super::frame::{encode_frame_into, is_ack_frame, parse_response_frame};
 use super::{
-    NFC_EDEVNOTSUPP, NFC_EINVARG, NFC_EIO, NFC_ENOTIMPL, NFC_ERFTRANS, NFC_ETGRELEASED,
-    PN53X_STATUS_BCC, PN53X_STATUS_BITCOLL, PN53X_STATUS_BITCOUNT, PN53X_STATUS_BUFOVF,
-    PN53X_STATUS_CDISCARDED, PN53X_STATUS_CID, PN53X_STATUS_CMD, PN53X_STATUS_CRC,
-    PN53X_STATUS_DEPINVSTATE, PN53X_STATUS_DEPUNKCMD, PN53X_STATUS_FRAMING, PN53X_STATUS_INBUFOVF,
-    PN53X_STATUS_INVPARAM, PN53X_STATUS_INVRXFRAM, PN53X_STATUS_MFAUTH, PN53X_STATUS_NAD,
-    PN53X_STATUS_NFCID3, PN53X_STATUS_OPNOTALL, PN53X_STATUS_OVCURRENT, PN53X_STATUS_OVHEAT,
-    PN53X_STATUS_PARITY, PN53X_STATUS_RFPROTO, PN53X_STATUS_RFTIMEOUT, PN53X_STATUS_SECNOTSUPP,
-    PN53X_STATUS_SMALLBUF, PN53X_STATUS_TGREL, PN53X_STATUS_TIMEOUT,
+    NFC_EDEVNOTSUPP, NFC_EINVARG, NFC_EIO, NFC_ENOTIMPL, NFC_ENOTSUCHDEV, NFC_ERFTRANS,
+    NFC_ETGRELEASED, NFC_ETIMEOUT, PN53X_ACK_FRAME, PN53X_STATUS_BCC, PN53X_STATUS_BITCOLL,
+    PN53X_STATUS_BITCOUNT, PN53X_STATUS_BUFOVF, PN53X_STATUS_CDISCARDED, PN53X_STATUS_CID,
+    PN53X_STATUS_CMD, PN53X_STATUS_CRC, PN53X_STATUS_DEPINVSTATE, PN53X_STATUS_DEPUNKCMD,
+    PN53X_STATUS_FRAMING, PN53X_STATUS_INBUFOVF, PN53X_STATUS_INVPARAM, PN53X_STATUS_INVRXFRAM,
+    PN53X_STATUS_MFAUTH, PN53X_STATUS_NAD, PN53X_STATUS_NFCID3, PN53X_STATUS_OPNOTALL,
+    PN53X_STATUS_OVCURRENT, PN53X_STATUS_OVHEAT, PN53X_STATUS_PARITY, PN53X_STATUS_RFPROTO,
+    PN53X_STATUS_RFTIMEOUT, PN53X_STATUS_SECNOTSUPP, PN53X_STATUS_SMALLBUF, PN53X_STATUS_TGREL,
+    PN53X_STATUS_TIMEOUT, PN532_SERIAL_SPEED_SETTLE, PN532_SERIAL_SPEEDS,
+    PN532_SET_SERIAL_BAUD_RATE,
 };
 use proximate_driver::Error;
 
@@ -39,14 +42,62 @@ pub(super) fn status_code(error: &Error) -> i32 {
     }
 }
 
+/// Whether `code` says the link to the chip failed rather than the chip or
+/// the RF field: the reader may have been unplugged or replaced.
+pub(super) fn is_transport_failure(code: i32) -> bool {
+    matches!(code, NFC_EIO | NFC_ENOTSUCHDEV | NFC_ETIMEOUT)
+}
+
 pub(crate) trait Pn53xTransport {
     fn send(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error>;
     fn receive(&mut self, buffer: &mut [u8], timeout_ms: i32) -> Result<usize, Error>;
     fn abort_command(&mut self) -> Result<(), Error>;
 
+    /// Writes an ACK frame and returns without reading: the chip never
+    /// answers one, whether it cancels a running command or confirms an
+    /// answer. Transports whose `send` waits for a reply override this.
+    fn send_ack(&mut self, timeout_ms: i32) -> Result<(), Error> {
+        self.send(&PN53X_ACK_FRAME, timeout_ms)
+    }
+
     fn wake_up(&mut self) -> Result<(), Error> {
         Ok(())
     }
+
+    /// Moves the host end of a serial link to `speed` baud, once everything
+    /// already written has gone out at the old rate.
+    fn set_line_speed(&mut self, _speed: u32) -> Result<(), Error> {
+        Err(Error::UnsupportedOperation("set_line_speed"))
+    }
+}
+
+/// Switches a PN532 serial link to `speed` baud with SetSerialBaudRate. The
+/// chip answers at the old rate and changes over once the host confirms the
+/// answer with an ACK frame, after which the host end follows. When this
+/// fails before the ACK is sent, both ends are still at the old rate.
+pub(crate) fn switch_serial_speed<T: Pn53xTransport + ?Sized>(
+    transport: &mut T,
+    speed: u32,
+    timeout_ms: i32,
+) -> Result<(), Error> {
+    let code = PN532_SERIAL_SPEEDS
+        .iter()
+        .position(|candidate| *candidate == speed)
+        .ok_or(Error::InvalidArgument("speed"))? as u8;
+    let mut frame = [0u8; 16];
+    let frame_len = encode_frame_into(&mut frame, PN532_SET_SERIAL_BAUD_RATE, &[&[code]])?;
+    transport.send(&frame[..frame_len], timeout_ms)?;
+    let ack_len = transport.receive(&mut frame, timeout_ms)?;
+    if !is_ack_frame(&frame[..ack_len]) {
+        return Err(status_error("pn532_SetSerialBaudRate", NFC_EIO));
+    }
+    let response_len = transport.receive(&mut frame, timeout_ms)?;
+    parse_response_frame(&frame[..response_len], PN532_SET_SERIAL_BAUD_RATE)?;
+
+    transport.send_ack(timeout_ms)?;
+    transport.set_line_speed(speed)?;
+    std::thread::sleep(PN532_SERIAL_SPEED_SETTLE);
+    Ok(())
 }
 
 pub(super) fn pn53x_translate_status(status: u8) -> i32 {
@@ -20,6 +20,25 @@ impl Pn53xType {
         }
     }
 
+    // Largest frame payload, command byte included, the chip takes from the
+    // host: the PN532 and PN533 understand extended frames.
+    pub(super) fn max_frame_payload_len(self) -> usize {
+        match self {
+            Self::Pn532 | Self::Pn533 => PN53X_EXTENDED_FRAME_DATA_MAX_LEN,
+            Self::Unknown | Self::Pn531 | Self::Rcs360 => PN53X_NORMAL_FRAME_DATA_MAX_LEN,
+        }
+    }
+
+    // ISO14443-4 data rates above 106 kbps InPSL can switch to, one bit per
+    // rate as in TA(1): b1 212, b2 424 and b3 848 kbps.
+    pub(super) fn iso_dep_bit_rates(self) -> u8 {
+        match self {
+            Self::Pn532 => 0x03,
+            Self::Pn533 => 0x07,
+            Self::Unknown | Self::Pn531 | Self::Rcs360 => 0x00,
+        }
+    }
+
     pub(super) fn label(self) -> &'static str {
         match self {
             Self::Unknown => "PN53x",
@@ -211,6 +230,7 @@ pub(super) struct PropertyState {
     pub(super) force_iso14443_a: bool,
     pub(super) force_iso14443_b: bool,
     pub(super) force_speed_106: bool,
+    pub(super) auto_bit_rate: bool,
 }
 
 impl Default for PropertyState {
@@ -228,6 +248,7 @@ impl Default for PropertyState {
             force_iso14443_a: false,
             force_iso14443_b: false,
             force_speed_106: false,
+            auto_bit_rate: false,
         }
     }
 }
@@ -247,7 +268,11 @@ impl PropertyState {
             Property::ForceIso14443A => self.force_iso14443_a,
             Property::ForceIso14443B => self.force_iso14443_b,
             Property::ForceSpeed106 => self.force_speed_106,
-            Property::TimeoutCommand | Property::TimeoutAtr | Property::TimeoutCom => return None,
+            Property::AutoBitRate => self.auto_bit_rate,
+            Property::TimeoutCommand
+            | Property::TimeoutAtr
+            | Property::TimeoutCom
+            | Property::PresenceWindow => return None,
         })
     }
 
@@ -265,7 +290,11 @@ impl PropertyState {
             Property::ForceIso14443A => self.force_iso14443_a = value,
             Property::ForceIso14443B => self.force_iso14443_b = value,
             Property::ForceSpeed106 => self.force_speed_106 = value,
-            Property::TimeoutCommand | Property::TimeoutAtr | Property::TimeoutCom => {
+            Property::AutoBitRate => self.auto_bit_rate = value,
+            Property::TimeoutCommand
+            | Property::TimeoutAtr
+            | Property::TimeoutCom
+            | Property::PresenceWindow => {
                 return Err(Error::InvalidArgument("property"));
             }
         }
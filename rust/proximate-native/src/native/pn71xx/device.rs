@@ -190,6 +190,11 @@ impl InitiatorBackend for Pn71xxDevice {
         self.succeed(())
     }
 
+    // Nothing about a session is kept on the host side.
+    fn reset_session_driver(&mut self) -> Result<(), Error> {
+        self.succeed(())
+    }
+
     fn powerdown_driver(&mut self) -> Result<(), Error> {
         self.succeed(())
     }
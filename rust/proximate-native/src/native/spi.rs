@@ -1,13 +1,13 @@
 use super::connstring::{build_path_speed_connstring, decode_path_speed_descriptor};
 use super::pn53x::{
-    Pn53xDevice, Pn53xProfile, Pn53xTransport, command_from_host_frame, is_ack_frame,
+    ChipIdentityKey, Pn53xDevice, Pn53xProfile, Pn53xTransport, command_from_host_frame,
+    is_ack_frame,
 };
+use crate::cancel::{CancelToken, Wake};
+use crate::gpio::{GpioIrqLine, GpioLineSpec, IrqLine};
 use crate::spi::{SpiHandle, SpiOpenError};
 use proximate_driver::{ConnectionString, Context, DeviceHandle, Driver, Error, ScanType};
-use std::sync::{
-    Arc,
-    atomic::{AtomicBool, Ordering},
-};
+use rustix::event::PollFlags;
 use std::thread;
 use std::time::{Duration, Instant};
 
@@ -22,7 +22,12 @@ const DATAREAD: u8 = 0x03;
 const DATAWRITE: u8 = 0x01;
 const STATREAD: u8 = 0x02;
 const ACK_FRAME: [u8; 6] = [0x00, 0x00, 0xff, 0x00, 0xff, 0x00];
-const STATUS_POLL_INTERVAL_MS: u64 = 10;
+// Without an IRQ line the status byte is polled, first often and then less
+// so: quick replies are picked up within a millisecond and slow ones, such as
+// a target search, cost a few SPI transfers instead of dozens.
+const STATUS_POLL_MIN_INTERVAL: Duration = Duration::from_millis(1);
+const STATUS_POLL_MAX_INTERVAL: Duration = Duration::from_millis(10);
+const IRQ_CONSUMER: &str = "libnfc pn532_spi";
 
 pub(crate) struct Pn532SpiDriver;
 
@@ -72,17 +77,25 @@ impl Driver for Pn532SpiDriver {
 
     fn open(
         &self,
-        _context: &Context,
+        context: &Context,
         connstring: &ConnectionString,
     ) -> Result<Box<dyn DeviceHandle>, Error> {
-        let descriptor = decode_path_speed_descriptor(connstring, DRIVER_NAME, DEFAULT_SPEED)?;
-        let transport = SpiTransport::open(&descriptor.path, descriptor.speed)?;
-        let device = Pn53xDevice::probe_with_profile(
+        let descriptor = decode_spi_descriptor(connstring)?;
+        let mut transport = SpiTransport::open(&descriptor.path, descriptor.speed)?;
+        if let Some(irq) = &descriptor.irq {
+            let line = GpioIrqLine::request(irq, IRQ_CONSUMER, true).map_err(|error| {
+                Error::DriverOpenFailed(format!("failed to request IRQ line {irq}: {error}"))
+            })?;
+            transport.set_irq_line(Box::new(line));
+        }
+        let identity = ChipIdentityKey::for_path(context, connstring, &descriptor.path);
+        let device = Pn53xDevice::open_with_profile(
             format!("PN532 SPI ({})", descriptor.path),
             connstring.clone(),
             Pn53xProfile::pn532(DRIVER_NAME),
             transport,
             PROBE_TIMEOUT_MS,
+            identity,
         )?;
         Ok(Box::new(device))
     }
@@ -92,9 +105,34 @@ fn list_candidate_paths() -> Vec<String> {
     crate::spi::list_ports()
 }
 
+#[derive(Clone, Debug, Eq, PartialEq)]
+struct SpiDescriptor {
+    path: String,
+    speed: u32,
+    irq: Option<GpioLineSpec>,
+}
+
+// `pn532_spi:<spidev>[:<speed>[:<gpiochip>/<line>]]`; the optional fourth
+// field names the GPIO wired to the PN532's IRQ pin.
+fn decode_spi_descriptor(connstring: &ConnectionString) -> Result<SpiDescriptor, Error> {
+    let descriptor = decode_path_speed_descriptor(connstring, DRIVER_NAME, DEFAULT_SPEED)?;
+    let irq = match connstring.as_str().split(':').nth(3) {
+        Some(value) if !value.is_empty() => Some(GpioLineSpec::parse(value).ok_or_else(|| {
+            Error::InvalidConnectionString(format!("invalid IRQ line '{value}'"))
+        })?),
+        _ => None,
+    };
+    Ok(SpiDescriptor {
+        path: descriptor.path,
+        speed: descriptor.speed,
+        irq,
+    })
+}
+
 pub struct SpiTransport {
     handle: SpiHandle,
-    abort_requested: Arc<AtomicBool>,
+    cancel: CancelToken,
+    irq: Option<Box<dyn IrqLine>>,
 }
 
 impl SpiTransport {
@@ -112,43 +150,102 @@ impl SpiTransport {
             .set_speed(speed)
             .map_err(|_| Error::DriverOpenFailed(format!("failed to set SPI speed on {path}")))?;
 
+        let cancel = CancelToken::new().map_err(|_| {
+            Error::DriverOpenFailed(format!("failed to create abort event for {path}"))
+        })?;
+
         Ok(Self {
             handle,
-            abort_requested: Arc::new(AtomicBool::new(false)),
+            cancel,
+            irq: None,
         })
     }
 
-    fn read_status(&self) -> Result<u8, Error> {
-        let mut status = [0u8; 1];
-        self.handle
-            .send_receive(&[STATREAD], &mut status, true)
-            .map_err(|_| device_error("spi_transfer", NFC_EIO))?;
-        Ok(status[0])
+    /// Waits for responses on `line`, the PN532's IRQ output, instead of
+    /// polling the status byte.
+    pub fn set_irq_line(&mut self, line: Box<dyn IrqLine>) {
+        self.irq = Some(line);
     }
 
     fn wait_ready(&mut self, timeout_ms: i32) -> Result<(), Error> {
-        let start = Instant::now();
-        loop {
-            if self.abort_requested.swap(false, Ordering::SeqCst) {
-                return Err(device_error("spi_abort", NFC_EOPABORTED));
-            }
+        let handle = &self.handle;
+        let irq = self
+            .irq
+            .as_mut()
+            .map(|line| &mut **line as &mut dyn IrqLine);
+        wait_ready(irq, &self.cancel, timeout_ms, || {
+            read_status(handle).map(|status| status == 0x01)
+        })
+    }
+}
 
-            if self.read_status()? == 0x01 {
-                return Ok(());
-            }
+fn read_status(handle: &SpiHandle) -> Result<u8, Error> {
+    let mut status = [0u8; 1];
+    handle
+        .send_receive(&[STATREAD], &mut status, true)
+        .map_err(|_| device_error("spi_transfer", NFC_EIO))?;
+    Ok(status[0])
+}
 
-            if timeout_ms >= 0 && start.elapsed() > Duration::from_millis(timeout_ms as u64) {
-                return Err(device_error("spi_wait_ready", NFC_ETIMEOUT));
-            }
+// Returns once `is_ready` reports a response. With an IRQ line the status is
+// only read while the line is active, and the wait in between sleeps until it
+// turns active; the line can still read active for a moment after the last
+// response was read out, which falls back to the backoff below.
+fn wait_ready(
+    mut irq: Option<&mut dyn IrqLine>,
+    cancel: &CancelToken,
+    timeout_ms: i32,
+    mut is_ready: impl FnMut() -> Result<bool, Error>,
+) -> Result<(), Error> {
+    let deadline = u64::try_from(timeout_ms)
+        .ok()
+        .map(|ms| Instant::now() + Duration::from_millis(ms));
+    let mut interval = STATUS_POLL_MIN_INTERVAL;
+    loop {
+        cancel
+            .check()
+            .map_err(|_| device_error("spi_abort", NFC_EOPABORTED))?;
+
+        let line_active = match irq.as_deref_mut() {
+            Some(line) => line
+                .clear_events()
+                .and_then(|()| line.is_active())
+                .map_err(|_| device_error("spi_irq", NFC_EIO))?,
+            None => true,
+        };
+        if line_active && is_ready()? {
+            return Ok(());
+        }
+
+        let remaining = deadline.map(|deadline| deadline.saturating_duration_since(Instant::now()));
+        if remaining.is_some_and(|remaining| remaining.is_zero()) {
+            return Err(device_error("spi_wait_ready", NFC_ETIMEOUT));
+        }
 
-            thread::sleep(Duration::from_millis(STATUS_POLL_INTERVAL_MS));
+        match irq.as_deref() {
+            Some(line) if !line_active => {
+                match cancel
+                    .wait_fd(line.as_fd(), PollFlags::IN, remaining)
+                    .map_err(|_| device_error("spi_irq", NFC_EIO))?
+                {
+                    Wake::Cancelled => return Err(device_error("spi_abort", NFC_EOPABORTED)),
+                    Wake::Ready(_) | Wake::TimedOut => {}
+                }
+            }
+            _ => {
+                let delay = remaining.map_or(interval, |remaining| remaining.min(interval));
+                cancel
+                    .sleep(delay)
+                    .map_err(|_| device_error("spi_abort", NFC_EOPABORTED))?;
+                interval = (interval * 2).min(STATUS_POLL_MAX_INTERVAL);
+            }
         }
     }
 }
 
 impl Pn53xTransport for SpiTransport {
     fn send(&mut self, payload: &[u8], _timeout_ms: i32) -> Result<(), Error> {
-        self.abort_requested.store(false, Ordering::SeqCst);
+        self.cancel.reset();
         let _ = command_from_host_frame(payload);
         let mut tx = Vec::with_capacity(payload.len() + 1);
         tx.push(DATAWRITE);
@@ -189,7 +286,7 @@ impl Pn53xTransport for SpiTransport {
     }
 
     fn abort_command(&mut self) -> Result<(), Error> {
-        self.abort_requested.store(true, Ordering::SeqCst);
+        self.cancel.cancel();
         Ok(())
     }
 
@@ -246,7 +343,9 @@ fn device_error(operation: &'static str, code: i32) -> Error {
 mod tests {
     use super::super::pn53x::build_response_frame;
     use super::*;
+    use crate::gpio::fake;
     use proximate_driver::Context;
+    use std::cell::Cell;
 
     #[test]
     fn find_subslice_locates_ack_sequence_inside_status_prefix() {
@@ -283,4 +382,109 @@ mod tests {
         };
         assert!(matches!(error, Error::DriverOpenFailed(_)));
     }
+
+    #[test]
+    fn spi_connstring_takes_an_optional_irq_line() {
+        let decode = |value: &str| decode_spi_descriptor(&ConnectionString::new(value).unwrap());
+
+        let descriptor = decode("pn532_spi:/dev/spidev0.0:500000:gpiochip0/25").unwrap();
+        assert_eq!(descriptor.path, "/dev/spidev0.0");
+        assert_eq!(descriptor.speed, 500_000);
+        assert_eq!(descriptor.irq, GpioLineSpec::parse("gpiochip0/25"));
+
+        let descriptor = decode("pn532_spi:/dev/spidev0.0::gpiochip0/25").unwrap();
+        assert_eq!(descriptor.speed, DEFAULT_SPEED);
+        assert!(descriptor.irq.is_some());
+
+        assert_eq!(decode("pn532_spi:/dev/spidev0.0").unwrap().irq, None);
+        assert!(matches!(
+            decode("pn532_spi:/dev/spidev0.0:500000:gpiochip0"),
+            Err(Error::InvalidConnectionString(_))
+        ));
+    }
+
+    #[test]
+    fn wait_ready_reads_the_status_only_once_the_irq_line_is_active() {
+        let (mut line, pin) = fake::irq_line();
+        let cancel = CancelToken::new().unwrap();
+        let status_reads = Cell::new(0);
+        let raise = thread::spawn(move || {
+            thread::sleep(Duration::from_millis(30));
+            pin.set_active(true);
+            pin
+        });
+
+        wait_ready(Some(&mut line), &cancel, 5_000, || {
+            status_reads.set(status_reads.get() + 1);
+            Ok(true)
+        })
+        .unwrap();
+        raise.join().unwrap();
+        assert_eq!(status_reads.get(), 1);
+    }
+
+    #[test]
+    fn wait_ready_on_an_irq_line_times_out_and_aborts() {
+        let (mut line, _pin) = fake::irq_line();
+        let cancel = CancelToken::new().unwrap();
+        let error = wait_ready(Some(&mut line), &cancel, 20, || {
+            panic!("status read while the IRQ line is inactive")
+        })
+        .unwrap_err();
+        assert!(matches!(
+            error,
+            Error::DeviceOperationFailed {
+                code: NFC_ETIMEOUT,
+                ..
+            }
+        ));
+
+        let canceller = cancel.clone();
+        let abort = thread::spawn(move || {
+            thread::sleep(Duration::from_millis(20));
+            canceller.cancel();
+        });
+        let error = wait_ready(Some(&mut line), &cancel, -1, || Ok(false)).unwrap_err();
+        abort.join().unwrap();
+        assert!(matches!(
+            error,
+            Error::DeviceOperationFailed {
+                code: NFC_EOPABORTED,
+                ..
+            }
+        ));
+    }
+
+    #[test]
+    fn wait_ready_without_an_irq_line_backs_off_between_status_reads() {
+        let cancel = CancelToken::new().unwrap();
+        let status_reads = Cell::new(0);
+        let error = wait_ready(None, &cancel, 100, || {
+            status_reads.set(status_reads.get() + 1);
+            Ok(false)
+        })
+        .unwrap_err();
+        assert!(matches!(
+            error,
+            Error::DeviceOperationFailed {
+                code: NFC_ETIMEOUT,
+                ..
+            }
+        ));
+        // 1 + 2 + 4 + 8 ms, then every 10 ms: about 14 reads, against 100
+        // at a fixed 1 ms or a first reply up to 10 ms late.
+        assert!(
+            (5..=20).contains(&status_reads.get()),
+            "{}",
+            status_reads.get()
+        );
+
+        let status_reads = Cell::new(0);
+        wait_ready(None, &cancel, 1_000, || {
+            status_reads.set(status_reads.get() + 1);
+            Ok(status_reads.get() == 3)
+        })
+        .unwrap();
+        assert_eq!(status_reads.get(), 3);
+    }
 }
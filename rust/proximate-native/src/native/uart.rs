@@ -1,21 +1,26 @@
 use super::connstring::{build_path_speed_connstring, decode_path_speed_descriptor};
-use super::pn53x::{Pn53xDevice, Pn53xProfile, Pn53xTransport, is_ack_frame};
+use super::pn53x::{
+    ChipIdentityKey, Pn53xDevice, Pn53xProfile, Pn53xTransport, is_ack_frame, switch_serial_speed,
+};
 use proximate_driver::{ConnectionString, Context, DeviceHandle, Driver, Error, ScanType};
 use std::fs;
-use std::sync::{
-    Arc,
-    atomic::{AtomicBool, Ordering},
-};
-use std::time::Duration;
+use std::path::Path;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
+use std::time::{Duration, Instant};
 
 #[cfg(target_os = "linux")]
-use rustix::event::{PollFd, PollFlags, Timespec, poll};
+use crate::cancel::{CancelToken, Wake};
+#[cfg(target_os = "linux")]
+use rustix::event::PollFlags;
 #[cfg(target_os = "linux")]
-use rustix::fd::OwnedFd;
+use rustix::fd::{AsFd, OwnedFd};
 #[cfg(target_os = "linux")]
 use rustix::fs::{FlockOperation, Mode, OFlags, flock, open};
 #[cfg(target_os = "linux")]
-use rustix::io::{ioctl_fionread, read, write};
+use rustix::io::{Errno, ioctl_fionread, read, write};
+#[cfg(target_os = "linux")]
+use rustix::ioctl::{self, Getter, Opcode, Setter};
 #[cfg(target_os = "linux")]
 use rustix::termios::{OptionalActions, QueueSelector, Termios, tcflush, tcgetattr, tcsetattr};
 
@@ -25,9 +30,48 @@ const DRIVER_NAME: &str = "pn532_uart";
 const DEFAULT_SPEED: u32 = 115_200;
 #[cfg_attr(not(any(test, libnfc_driver_pn532_uart)), allow(dead_code))]
 const PROBE_TIMEOUT_MS: i32 = 250;
+const MAX_PROBE_WORKERS: usize = 8;
+// Time set aside for probing one port: opening it and the chip's answer to
+// the probe commands, each bounded by PROBE_TIMEOUT_MS.
+#[cfg_attr(not(any(test, libnfc_driver_pn532_uart)), allow(dead_code))]
+const PORT_PROBE_BUDGET: Duration = Duration::from_millis(500);
+const UUCP_LOCK_DIRS: [&str; 2] = ["/run/lock", "/var/lock"];
 const NFC_EIO: i32 = -1;
 const NFC_ETIMEOUT: i32 = -6;
 const NFC_EOPABORTED: i32 = -7;
+// Larger than any PN53x frame, so one read can take a whole response.
+#[cfg(target_os = "linux")]
+const READ_CHUNK_LEN: usize = 512;
+#[cfg(target_os = "linux")]
+const ACK_FRAME_LEN: usize = 6;
+// TIOCGSERIAL and TIOCSSERIAL from <asm/ioctls.h>. MIPS numbers them apart;
+// powerpc, sparc and alpha keep the generic values.
+#[cfg(all(
+    target_os = "linux",
+    any(
+        target_arch = "mips",
+        target_arch = "mips32r6",
+        target_arch = "mips64",
+        target_arch = "mips64r6"
+    )
+))]
+const SERIAL_IOCTLS: (Opcode, Opcode) = (0x5484, 0x5485);
+#[cfg(all(
+    target_os = "linux",
+    not(any(
+        target_arch = "mips",
+        target_arch = "mips32r6",
+        target_arch = "mips64",
+        target_arch = "mips64r6"
+    ))
+))]
+const SERIAL_IOCTLS: (Opcode, Opcode) = (0x541e, 0x541f);
+#[cfg(target_os = "linux")]
+const TIOCGSERIAL: Opcode = SERIAL_IOCTLS.0;
+#[cfg(target_os = "linux")]
+const TIOCSSERIAL: Opcode = SERIAL_IOCTLS.1;
+#[cfg(target_os = "linux")]
+const ASYNC_LOW_LATENCY: i32 = 1 << 13;
 const WAKEUP_FRAME: [u8; 16] = [
     0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
 ];
@@ -51,66 +95,55 @@ impl Driver for Pn532UartDriver {
         ScanType::Intrusive
     }
 
-    fn scan(&self, _context: &Context) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
-        let mut devices = Vec::new();
-
-        for path in list_candidate_paths() {
-            let Ok(connstring) = build_path_speed_connstring(DRIVER_NAME, &path, DEFAULT_SPEED)
-            else {
-                continue;
-            };
-
-            #[cfg(target_os = "linux")]
-            {
-                let Ok(port) = UartPort::open(&path, DEFAULT_SPEED) else {
-                    continue;
-                };
-                if Pn53xDevice::probe_with_profile(
-                    format!("PN532 UART ({path})"),
-                    connstring.clone(),
-                    Pn53xProfile::pn532(DRIVER_NAME),
-                    port,
-                    PROBE_TIMEOUT_MS,
-                )
-                .is_ok()
-                {
-                    devices.push(self.describe_discovered(
-                        format!("PN532 UART ({path})"),
-                        connstring,
-                        Some(super::pn53x::scan_caps(Pn53xProfile::pn532(DRIVER_NAME))),
-                    ));
-                }
-            }
+    fn scan(&self, context: &Context) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        self.scan_until(context, None)
+    }
 
-            #[cfg(not(target_os = "linux"))]
-            {
-                devices.push(self.describe_discovered(
-                    format!("PN532 UART ({path})"),
-                    connstring,
-                    Some(super::pn53x::scan_caps(Pn53xProfile::pn532(DRIVER_NAME))),
-                ));
-            }
-        }
+    fn scan_until(
+        &self,
+        _context: &Context,
+        deadline: Option<Instant>,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        Ok(probe_candidate_ports(
+            list_candidate_paths(),
+            probe_cutoff(deadline, PORT_PROBE_BUDGET),
+            probe_port,
+        ))
+    }
 
-        Ok(devices)
+    fn probe_node(
+        &self,
+        _context: &Context,
+        path: &str,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        Ok(probe_single_port(path, probe_port))
     }
 
     fn open(
         &self,
-        _context: &Context,
+        context: &Context,
         connstring: &ConnectionString,
     ) -> Result<Box<dyn DeviceHandle>, Error> {
         let descriptor = decode_path_speed_descriptor(connstring, DRIVER_NAME, DEFAULT_SPEED)?;
         #[cfg(target_os = "linux")]
         {
-            let port = UartPort::open(&descriptor.path, descriptor.speed)?;
-            let device = Pn53xDevice::probe_with_profile(
+            let mut port = UartPort::open(&descriptor.path, descriptor.speed)?;
+            if context.config.uart_low_latency {
+                port.set_low_latency();
+            }
+            let identity = ChipIdentityKey::for_path(context, connstring, &descriptor.path);
+            let mut device = Pn53xDevice::open_with_profile(
                 format!("PN532 UART ({})", descriptor.path),
                 connstring.clone(),
                 Pn53xProfile::pn532(DRIVER_NAME),
                 port,
                 PROBE_TIMEOUT_MS,
+                identity,
             )?;
+            let max_speed = context.config.uart_max_speed;
+            if max_speed > descriptor.speed {
+                device.negotiate_serial_speed(descriptor.speed, max_speed)?;
+            }
             Ok(Box::new(device))
         }
 
@@ -124,6 +157,29 @@ impl Driver for Pn532UartDriver {
     }
 }
 
+fn probe_port(path: &str) -> Option<proximate_driver::DiscoveredDevice> {
+    let connstring = build_path_speed_connstring(DRIVER_NAME, path, DEFAULT_SPEED).ok()?;
+
+    #[cfg(target_os = "linux")]
+    {
+        let port = UartPort::open(path, DEFAULT_SPEED).ok()?;
+        Pn53xDevice::probe_with_profile(
+            format!("PN532 UART ({path})"),
+            connstring.clone(),
+            Pn53xProfile::pn532(DRIVER_NAME),
+            port,
+            PROBE_TIMEOUT_MS,
+        )
+        .ok()?;
+    }
+
+    Some(Pn532UartDriver.describe_discovered(
+        format!("PN532 UART ({path})"),
+        connstring,
+        Some(super::pn53x::scan_caps(Pn53xProfile::pn532(DRIVER_NAME))),
+    ))
+}
+
 pub(crate) fn list_candidate_paths() -> Vec<String> {
     let mut ports = Vec::new();
     let Ok(entries) = fs::read_dir("/dev") else {
@@ -133,36 +189,173 @@ pub(crate) fn list_candidate_paths() -> Vec<String> {
     for entry in entries.flatten() {
         let name = entry.file_name();
         let name = name.to_string_lossy();
-        if !serial_name_prefixes()
-            .iter()
-            .any(|prefix| name.starts_with(prefix))
-        {
-            continue;
+        if is_candidate_name(&name) {
+            ports.push(format!("/dev/{name}"));
         }
-        if !name
-            .bytes()
-            .last()
-            .is_some_and(|byte| byte.is_ascii_digit())
-        {
-            continue;
-        }
-        ports.push(format!("/dev/{name}"));
     }
 
     ports.sort();
     ports
 }
 
+fn is_candidate_name(name: &str) -> bool {
+    serial_name_prefixes()
+        .iter()
+        .any(|prefix| name.starts_with(prefix))
+        && name
+            .bytes()
+            .last()
+            .is_some_and(|byte| byte.is_ascii_digit())
+}
+
 fn serial_name_prefixes() -> &'static [&'static str] {
     &["ttyUSB", "ttyS", "ttyACM", "ttyAMA", "ttyO"]
 }
 
+/// Latest time a serial scan bounded by `deadline` may start probing another
+/// port: a probe taking up to `port_budget` has to fit before the deadline, so
+/// the scan is done by the time the registry stops waiting for it.
+pub(crate) fn probe_cutoff(deadline: Option<Instant>, port_budget: Duration) -> Option<Instant> {
+    deadline.map(|deadline| {
+        deadline
+            .checked_sub(port_budget)
+            .unwrap_or_else(Instant::now)
+    })
+}
+
+/// Runs `probe` over `paths` on a small worker pool and returns the hits in
+/// candidate order. Ports claimed through a UUCP lock file are skipped, and
+/// past `cutoff` no worker starts another probe; each still probes its first
+/// port, so a budget shorter than a probe does not hide every reader. Every
+/// probe that did start is waited for, so no port is left open behind the
+/// scan.
+pub(crate) fn probe_candidate_ports<T, F>(
+    paths: Vec<String>,
+    cutoff: Option<Instant>,
+    probe: F,
+) -> Vec<T>
+where
+    T: Send,
+    F: Fn(&str) -> Option<T> + Sync,
+{
+    let paths: Vec<String> = paths
+        .into_iter()
+        .filter(|path| !port_is_lock_claimed(path))
+        .collect();
+    let next = AtomicUsize::new(0);
+    let worker = || {
+        let mut hits = Vec::new();
+        let mut probed_any = false;
+        loop {
+            if probed_any && cutoff.is_some_and(|cutoff| Instant::now() >= cutoff) {
+                break;
+            }
+            probed_any = true;
+            let index = next.fetch_add(1, Ordering::SeqCst);
+            let Some(path) = paths.get(index) else {
+                break;
+            };
+            if let Some(hit) = probe(path) {
+                hits.push((index, hit));
+            }
+        }
+        hits
+    };
+
+    let mut hits: Vec<(usize, T)> = thread::scope(|scope| {
+        let workers: Vec<_> = (0..MAX_PROBE_WORKERS.min(paths.len()))
+            .map_while(|_| {
+                thread::Builder::new()
+                    .name("nfc-uart-probe".into())
+                    .spawn_scoped(scope, worker)
+                    .ok()
+            })
+            .collect();
+        let mut hits = if workers.is_empty() {
+            worker()
+        } else {
+            Vec::new()
+        };
+        for worker in workers {
+            hits.extend(worker.join().unwrap_or_default());
+        }
+        hits
+    });
+    hits.sort_by_key(|(index, _)| *index);
+    hits.into_iter().map(|(_, hit)| hit).collect()
+}
+
+/// Hotplug counterpart of `probe_candidate_ports` for a single new node.
+pub(crate) fn probe_single_port<T>(path: &str, probe: impl Fn(&str) -> Option<T>) -> Vec<T> {
+    let is_candidate = Path::new(path)
+        .file_name()
+        .and_then(|name| name.to_str())
+        .is_some_and(is_candidate_name);
+    if !is_candidate || port_is_lock_claimed(path) {
+        return Vec::new();
+    }
+    probe(path).into_iter().collect()
+}
+
+fn port_is_lock_claimed(path: &str) -> bool {
+    let Some(name) = Path::new(path).file_name().and_then(|name| name.to_str()) else {
+        return false;
+    };
+    UUCP_LOCK_DIRS
+        .iter()
+        .any(|dir| lock_file_claims_port(Path::new(dir), name))
+}
+
+// A UUCP lock file holds the owner's pid; a lock whose owner is gone is stale
+// and does not keep the port busy.
+fn lock_file_claims_port(lock_dir: &Path, port_name: &str) -> bool {
+    let Ok(contents) = fs::read_to_string(lock_dir.join(format!("LCK..{port_name}"))) else {
+        return false;
+    };
+    match contents.trim().parse::<u32>() {
+        Ok(pid) => Path::new(&format!("/proc/{pid}")).exists(),
+        Err(_) => true,
+    }
+}
+
 #[cfg(target_os = "linux")]
 pub struct UartPort {
     fd: OwnedFd,
     original_termios: Termios,
+    // Rate the port was opened at, and the one it runs at now.
+    open_speed: u32,
+    speed: u32,
     read_buffer: Vec<u8>,
-    abort_requested: Arc<AtomicBool>,
+    cancel: CancelToken,
+    // Read whatever has arrived without asking the driver how much first.
+    low_latency: bool,
+    // Serial flags to put back on close when low-latency mode changed them.
+    original_serial_flags: Option<i32>,
+}
+
+// `struct serial_struct` from <linux/serial.h>.
+#[cfg(target_os = "linux")]
+#[repr(C)]
+#[derive(Clone, Copy)]
+struct SerialStruct {
+    kind: i32,
+    line: i32,
+    port: u32,
+    irq: i32,
+    flags: i32,
+    xmit_fifo_size: i32,
+    custom_divisor: i32,
+    baud_base: i32,
+    close_delay: u16,
+    io_type: u8,
+    reserved_char: u8,
+    hub6: i32,
+    closing_wait: u16,
+    closing_wait2: u16,
+    iomem_base: *mut u8,
+    iomem_reg_shift: u16,
+    port_high: u32,
+    iomap_base: usize,
 }
 
 #[cfg(target_os = "linux")]
@@ -197,15 +390,70 @@ impl UartPort {
         tcflush(&fd, QueueSelector::IFlush).map_err(|_| {
             Error::DriverOpenFailed(format!("failed to flush UART input for {path}"))
         })?;
+        let cancel = CancelToken::new().map_err(|_| {
+            Error::DriverOpenFailed(format!("failed to create abort event for {path}"))
+        })?;
 
         Ok(Self {
             fd,
             original_termios,
-            read_buffer: Vec::new(),
-            abort_requested: Arc::new(AtomicBool::new(false)),
+            open_speed: speed,
+            speed,
+            read_buffer: Vec::with_capacity(READ_CHUNK_LEN),
+            cancel,
+            low_latency: false,
+            original_serial_flags: None,
         })
     }
 
+    /// Switches the port to low-latency mode. The tty driver is asked for
+    /// ASYNC_LOW_LATENCY, which makes USB adapters forward each byte as it
+    /// arrives instead of holding it for their latency timer (16 ms on FTDI
+    /// parts), and each wakeup is served by a single read. Ports whose driver
+    /// has no serial settings, such as ptys, only get the read side.
+    pub(crate) fn set_low_latency(&mut self) {
+        self.low_latency = true;
+        if self.original_serial_flags.is_some() {
+            return;
+        }
+        // SAFETY: TIOCGSERIAL fills in a `struct serial_struct`.
+        let Ok(mut serial) =
+            (unsafe { ioctl::ioctl(&self.fd, Getter::<TIOCGSERIAL, SerialStruct>::new()) })
+        else {
+            return;
+        };
+        if serial.flags & ASYNC_LOW_LATENCY != 0 {
+            return;
+        }
+        let original_flags = serial.flags;
+        serial.flags |= ASYNC_LOW_LATENCY;
+        // SAFETY: TIOCSSERIAL reads a `struct serial_struct`.
+        if unsafe { ioctl::ioctl(&self.fd, Setter::<TIOCSSERIAL, SerialStruct>::new(serial)) }
+            .is_ok()
+        {
+            self.original_serial_flags = Some(original_flags);
+        }
+    }
+
+    fn restore_serial_flags(&mut self) {
+        let Some(flags) = self.original_serial_flags.take() else {
+            return;
+        };
+        // SAFETY: as in `set_low_latency`.
+        if let Ok(mut serial) =
+            unsafe { ioctl::ioctl(&self.fd, Getter::<TIOCGSERIAL, SerialStruct>::new()) }
+        {
+            serial.flags = flags;
+            let _ =
+                unsafe { ioctl::ioctl(&self.fd, Setter::<TIOCSSERIAL, SerialStruct>::new(serial)) };
+        }
+    }
+
+    /// Lowers an abort left over from the previous command.
+    pub(crate) fn clear_abort(&self) {
+        self.cancel.reset();
+    }
+
     pub(crate) fn flush_input(&mut self) -> Result<(), Error> {
         tcflush(&self.fd, QueueSelector::IFlush)
             .map_err(|_| device_error("uart_flush_input", NFC_EIO))?;
@@ -230,19 +478,17 @@ impl UartPort {
     }
 
     fn wait_for(&self, flags: PollFlags, timeout_ms: i32) -> Result<(), Error> {
-        if self.abort_requested.swap(false, Ordering::SeqCst) {
-            return Err(device_error("uart_abort", NFC_EOPABORTED));
-        }
-
-        let mut pollfd = [PollFd::new(&self.fd, flags)];
-        let timeout = timeout_spec(timeout_ms);
-        let ready =
-            poll(&mut pollfd, timeout.as_ref()).map_err(|_| device_error("uart_poll", NFC_EIO))?;
-        if ready == 0 {
-            return Err(device_error("uart_poll", NFC_ETIMEOUT));
-        }
+        let timeout = u64::try_from(timeout_ms).ok().map(Duration::from_millis);
+        let revents = match self
+            .cancel
+            .wait_fd(self.fd.as_fd(), flags, timeout)
+            .map_err(|_| device_error("uart_poll", NFC_EIO))?
+        {
+            Wake::Ready(revents) => revents,
+            Wake::TimedOut => return Err(device_error("uart_poll", NFC_ETIMEOUT)),
+            Wake::Cancelled => return Err(device_error("uart_abort", NFC_EOPABORTED)),
+        };
 
-        let revents = pollfd[0].revents();
         if revents.intersects(PollFlags::ERR | PollFlags::HUP | PollFlags::NVAL) {
             return Err(device_error("uart_poll", NFC_EIO));
         }
@@ -267,16 +513,30 @@ impl UartPort {
     }
 
     fn fill_read_buffer(&mut self, timeout_ms: i32) -> Result<(), Error> {
-        self.wait_for(PollFlags::IN, timeout_ms)?;
-        let available = ioctl_fionread(&self.fd).unwrap_or(1).max(1) as usize;
-        let mut chunk = vec![0u8; available.min(512)];
-        let len = read(&self.fd, chunk.as_mut_slice())
-            .map_err(|_| device_error("uart_receive", NFC_EIO))?;
-        if len == 0 {
-            return Err(device_error("uart_receive", NFC_EIO));
+        loop {
+            self.wait_for(PollFlags::IN, timeout_ms)?;
+            let chunk_len = if self.low_latency {
+                READ_CHUNK_LEN
+            } else {
+                (ioctl_fionread(&self.fd).unwrap_or(1) as usize).clamp(1, READ_CHUNK_LEN)
+            };
+            let start = self.read_buffer.len();
+            self.read_buffer.resize(start + chunk_len, 0);
+            let len = match read(&self.fd, &mut self.read_buffer[start..]) {
+                Ok(len) => len,
+                // A wakeup another reader took, or a signal: wait again.
+                Err(Errno::AGAIN | Errno::INTR) => {
+                    self.read_buffer.truncate(start);
+                    continue;
+                }
+                Err(_) => 0,
+            };
+            self.read_buffer.truncate(start + len);
+            if len == 0 {
+                return Err(device_error("uart_receive", NFC_EIO));
+            }
+            return Ok(());
         }
-        self.read_buffer.extend_from_slice(&chunk[..len]);
-        Ok(())
     }
 
     pub(crate) fn read_exact(&mut self, buffer: &mut [u8], timeout_ms: i32) -> Result<(), Error> {
@@ -321,7 +581,13 @@ impl UartPort {
 
 #[cfg(target_os = "linux")]
 impl Drop for UartPort {
+    // A chip left at a negotiated rate would not answer the next open.
     fn drop(&mut self) {
+        if self.speed != self.open_speed {
+            let _ = self.wake_up();
+            let _ = switch_serial_speed(self, self.open_speed, PROBE_TIMEOUT_MS);
+        }
+        self.restore_serial_flags();
         let _ = tcsetattr(&self.fd, OptionalActions::Now, &self.original_termios);
     }
 }
@@ -329,7 +595,7 @@ impl Drop for UartPort {
 #[cfg(target_os = "linux")]
 impl Pn53xTransport for UartPort {
     fn send(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error> {
-        self.abort_requested.store(false, Ordering::SeqCst);
+        self.clear_abort();
         self.flush_input()?;
         self.write_all(payload, timeout_ms)
     }
@@ -339,7 +605,7 @@ impl Pn53xTransport for UartPort {
     }
 
     fn abort_command(&mut self) -> Result<(), Error> {
-        self.abort_requested.store(true, Ordering::SeqCst);
+        self.cancel.cancel();
         Ok(())
     }
 
@@ -348,6 +614,18 @@ impl Pn53xTransport for UartPort {
         std::thread::sleep(Duration::from_millis(1));
         Ok(())
     }
+
+    fn set_line_speed(&mut self, speed: u32) -> Result<(), Error> {
+        let mut configured =
+            tcgetattr(&self.fd).map_err(|_| device_error("uart_set_speed", NFC_EIO))?;
+        configured
+            .set_speed(speed)
+            .map_err(|_| device_error("uart_set_speed", NFC_EIO))?;
+        tcsetattr(&self.fd, OptionalActions::Drain, &configured)
+            .map_err(|_| device_error("uart_set_speed", NFC_EIO))?;
+        self.speed = speed;
+        self.flush_input()
+    }
 }
 
 #[cfg(not(target_os = "linux"))]
@@ -366,18 +644,6 @@ fn device_error(operation: &'static str, code: i32) -> Error {
     Error::DeviceOperationFailed { operation, code }
 }
 
-#[cfg(target_os = "linux")]
-fn timeout_spec(timeout_ms: i32) -> Option<Timespec> {
-    if timeout_ms < 0 {
-        None
-    } else {
-        Some(Timespec {
-            tv_sec: (timeout_ms / 1000) as i64,
-            tv_nsec: ((timeout_ms % 1000) as i64) * 1_000_000,
-        })
-    }
-}
-
 #[cfg(target_os = "linux")]
 fn expected_frame_len(frame: &[u8]) -> Result<Option<usize>, Error> {
     if frame.len() >= 6 && is_ack_frame(frame) {
@@ -389,6 +655,14 @@ fn expected_frame_len(frame: &[u8]) -> Result<Option<usize>, Error> {
     if !frame.starts_with(&[0x00, 0x00, 0xff]) {
         return Err(device_error("uart_receive", NFC_EIO));
     }
+    // LEN 0x00 with LCS 0xff only starts an ACK; wait for its last byte.
+    if frame[3] == 0x00 && frame[4] == 0xff {
+        return if frame.len() < ACK_FRAME_LEN {
+            Ok(None)
+        } else {
+            Err(device_error("uart_receive", NFC_EIO))
+        };
+    }
     if frame[3] == 0xff && frame[4] == 0xff {
         if frame.len() < 8 {
             return Ok(None);
@@ -416,6 +690,102 @@ mod tests {
         assert!(serial_name_prefixes().contains(&"ttyUSB"));
     }
 
+    #[test]
+    fn probe_candidate_ports_keeps_candidate_order() {
+        let paths = (0..20)
+            .map(|index| format!("/dev/ttyFAKE{index}"))
+            .collect();
+        let hits = probe_candidate_ports(paths, None, |path| {
+            let index: u64 = path.trim_start_matches("/dev/ttyFAKE").parse().unwrap();
+            thread::sleep(Duration::from_millis(20 - index));
+            index.is_multiple_of(3).then(|| path.to_string())
+        });
+
+        assert_eq!(
+            hits,
+            [0, 3, 6, 9, 12, 15, 18]
+                .iter()
+                .map(|index| format!("/dev/ttyFAKE{index}"))
+                .collect::<Vec<_>>()
+        );
+    }
+
+    #[test]
+    fn probe_candidate_ports_finishes_started_probes_and_starts_none_past_the_cutoff() {
+        let paths: Vec<String> = (0..40)
+            .map(|index| format!("/dev/ttyFAKE{index}"))
+            .collect();
+        let running = AtomicUsize::new(0);
+        let hits = probe_candidate_ports(
+            paths.clone(),
+            Some(Instant::now() + Duration::from_millis(50)),
+            |path| {
+                running.fetch_add(1, Ordering::SeqCst);
+                thread::sleep(Duration::from_millis(30));
+                running.fetch_sub(1, Ordering::SeqCst);
+                Some(path.to_string())
+            },
+        );
+
+        assert_eq!(running.load(Ordering::SeqCst), 0);
+        assert!(hits.len() >= MAX_PROBE_WORKERS && hits.len() < paths.len());
+        assert_eq!(hits, paths[..hits.len()]);
+    }
+
+    #[test]
+    fn probe_candidate_ports_starts_the_first_batch_past_the_cutoff() {
+        let paths: Vec<String> = (0..40)
+            .map(|index| format!("/dev/ttyFAKE{index}"))
+            .collect();
+        let hits = probe_candidate_ports(paths.clone(), Some(Instant::now()), |path| {
+            Some(path.to_string())
+        });
+
+        assert_eq!(hits, paths[..MAX_PROBE_WORKERS]);
+    }
+
+    #[test]
+    fn probe_cutoff_leaves_room_for_one_port_probe() {
+        assert_eq!(probe_cutoff(None, PORT_PROBE_BUDGET), None);
+        let deadline = Instant::now() + Duration::from_secs(2);
+        assert_eq!(
+            probe_cutoff(Some(deadline), PORT_PROBE_BUDGET),
+            Some(deadline - PORT_PROBE_BUDGET)
+        );
+    }
+
+    #[test]
+    fn probe_single_port_ignores_non_serial_nodes() {
+        assert!(probe_single_port("/tmp/monitor/ttyUSB", |path| Some(path.to_string())).is_empty());
+        assert!(probe_single_port("/tmp/monitor/sda1", |path| Some(path.to_string())).is_empty());
+        assert_eq!(
+            probe_single_port("/tmp/monitor/ttyACM3", |path| Some(path.to_string())),
+            vec!["/tmp/monitor/ttyACM3".to_string()]
+        );
+    }
+
+    #[test]
+    fn uucp_lock_files_claim_ports_only_while_owner_lives() {
+        let lock_dir = std::env::temp_dir().join(format!(
+            "proximate-uart-lock-{}-{}",
+            std::process::id(),
+            line!()
+        ));
+        fs::create_dir_all(&lock_dir).unwrap();
+
+        assert!(!lock_file_claims_port(&lock_dir, "ttyUSB0"));
+        fs::write(
+            lock_dir.join("LCK..ttyUSB0"),
+            format!("{:>10}\n", std::process::id()),
+        )
+        .unwrap();
+        assert!(lock_file_claims_port(&lock_dir, "ttyUSB0"));
+        fs::write(lock_dir.join("LCK..ttyUSB0"), format!("{:>10}\n", u32::MAX)).unwrap();
+        assert!(!lock_file_claims_port(&lock_dir, "ttyUSB0"));
+
+        fs::remove_dir_all(&lock_dir).unwrap();
+    }
+
     #[test]
     fn uart_frame_length_recognizes_ack_and_response() {
         #[cfg(target_os = "linux")]
@@ -424,6 +794,10 @@ mod tests {
                 expected_frame_len(&[0x00, 0x00, 0xff, 0x00, 0xff, 0x00]).unwrap(),
                 Some(6)
             );
+            assert_eq!(
+                expected_frame_len(&[0x00, 0x00, 0xff, 0x00, 0xff]).unwrap(),
+                None
+            );
             let frame = build_response_frame(0x02, &[0x32, 0x01, 0x06, 0x07]).unwrap();
             assert_eq!(expected_frame_len(&frame).unwrap(), Some(frame.len()));
         }
@@ -1,12 +1,21 @@
 use super::connstring::{UsbSelector, build_usb_connstring, decode_usb_selector};
-use super::pn53x::{Pn53xDevice, Pn53xProfile, Pn53xTransport, Pn53xUsbModel};
-use crate::usb::{UsbDeviceInfo, UsbError, UsbHandle, bulk_endpoints, list_devices, strerror};
+use super::pn53x::{
+    ChipIdentityKey, PN532_BUFFER_LEN, Pn53xDevice, Pn53xProfile, Pn53xTransport, Pn53xUsbModel,
+};
+use crate::cancel::CancelToken;
+use crate::usb::{
+    UsbDeviceInfo, UsbError, UsbHandle, bulk_endpoints, list_devices, read_node_ids, strerror,
+};
 use proximate_driver::{ConnectionString, Context, DeviceHandle, Driver, Error, ScanType};
 
 const DRIVER_NAME: &str = "pn53x_usb";
 const PROBE_TIMEOUT_MS: i32 = 250;
 const NFC_EIO: i32 = -1;
 const NFC_ETIMEOUT: i32 = -6;
+const NFC_EOPABORTED: i32 = -7;
+// IN transfers kept posted, so the response is already in flight behind
+// the ACK when the host asks for it.
+const READ_QUEUE_DEPTH: usize = 2;
 
 #[derive(Clone, Copy)]
 struct SupportedUsbDevice {
@@ -116,21 +125,45 @@ impl Driver for Pn53xUsbDriver {
         Ok(found)
     }
 
-    fn open(
+    fn probe_node(
         &self,
         _context: &Context,
+        path: &str,
+    ) -> Result<Vec<proximate_driver::DiscoveredDevice>, Error> {
+        let Some(ids) = read_node_ids(path) else {
+            return Ok(Vec::new());
+        };
+        let Some(supported) = supported_ids(ids.vendor_id, ids.product_id) else {
+            return Ok(Vec::new());
+        };
+        // String descriptors need the device opened; the table name stands in.
+        Ok(vec![self.describe_discovered(
+            supported.display_name.to_string(),
+            build_usb_connstring(ids.bus_number, ids.device_address)?,
+            Some(super::pn53x::scan_caps(Pn53xProfile::pn53x_usb(
+                supported.model,
+            ))),
+        )])
+    }
+
+    fn open(
+        &self,
+        context: &Context,
         connstring: &ConnectionString,
     ) -> Result<Box<dyn DeviceHandle>, Error> {
         let selector = decode_usb_selector(connstring)?;
         let (info, supported) = select_usb_device(selector)?;
         let display_name = usb_display_name(&info, supported);
+        let identity =
+            ChipIdentityKey::for_usb(context, connstring, info.bus_number, info.device_address);
         let transport = UsbTransport::open(&info, supported)?;
-        let device = Pn53xDevice::probe_with_profile(
+        let device = Pn53xDevice::open_with_profile(
             display_name,
             connstring.clone(),
             Pn53xProfile::pn53x_usb(supported.model),
             transport,
             PROBE_TIMEOUT_MS,
+            identity,
         )?;
         Ok(Box::new(device))
     }
@@ -174,10 +207,14 @@ fn usb_display_name(info: &UsbDeviceInfo, supported: SupportedUsbDevice) -> Stri
 }
 
 fn supported_device(info: &UsbDeviceInfo) -> Option<SupportedUsbDevice> {
+    supported_ids(info.vendor_id, info.product_id)
+}
+
+fn supported_ids(vendor_id: u16, product_id: u16) -> Option<SupportedUsbDevice> {
     SUPPORTED_DEVICES
         .iter()
         .copied()
-        .find(|device| device.vendor_id == info.vendor_id && device.product_id == info.product_id)
+        .find(|device| device.vendor_id == vendor_id && device.product_id == product_id)
 }
 
 fn usb_open_error(error: UsbError) -> Error {
@@ -188,6 +225,7 @@ pub struct UsbTransport {
     handle: UsbHandle,
     endpoint_in: u8,
     endpoint_out: u8,
+    cancel: CancelToken,
 }
 
 impl UsbTransport {
@@ -212,16 +250,31 @@ impl UsbTransport {
                 .map_err(usb_open_error)?;
         }
 
+        let cancel = CancelToken::new()
+            .map_err(|_| Error::DriverOpenFailed("failed to create USB abort event".into()))?;
+        handle
+            .set_cancel_token(cancel.clone())
+            .map_err(usb_open_error)?;
+        handle
+            .set_read_queue(
+                endpoint_selection.endpoint_in,
+                READ_QUEUE_DEPTH,
+                PN532_BUFFER_LEN,
+            )
+            .map_err(usb_open_error)?;
+
         Ok(Self {
             handle,
             endpoint_in: endpoint_selection.endpoint_in,
             endpoint_out: endpoint_selection.endpoint_out,
+            cancel,
         })
     }
 }
 
 impl Pn53xTransport for UsbTransport {
     fn send(&mut self, payload: &[u8], timeout_ms: i32) -> Result<(), Error> {
+        self.cancel.reset();
         let sent = self
             .handle
             .bulk_write(self.endpoint_out, payload, timeout_ms)
@@ -239,6 +292,7 @@ impl Pn53xTransport for UsbTransport {
     }
 
     fn abort_command(&mut self) -> Result<(), Error> {
+        self.cancel.cancel();
         Ok(())
     }
 }
@@ -281,6 +335,7 @@ fn device_error(operation: &'static str, code: i32) -> Error {
 fn map_usb_error(operation: &'static str, error: UsbError) -> Error {
     let code = match error {
         UsbError::Timeout => NFC_ETIMEOUT,
+        UsbError::Interrupted => NFC_EOPABORTED,
         UsbError::NoDevice
         | UsbError::Io
         | UsbError::InvalidParam
@@ -289,7 +344,6 @@ fn map_usb_error(operation: &'static str, error: UsbError) -> Error {
         | UsbError::Busy
         | UsbError::Overflow
         | UsbError::Pipe
-        | UsbError::Interrupted
         | UsbError::NoMem
         | UsbError::NotSupported
         | UsbError::Other => NFC_EIO,
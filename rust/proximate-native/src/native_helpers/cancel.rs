@@ -0,0 +1,306 @@
+//! Cancellation shared between a transport and whoever aborts its command.
+//!
+//! A `CancelToken` is a level-triggered flag that blocking waits can sleep
+//! on. On Linux it is an eventfd: `cancel` makes it readable, so a transport
+//! can put it in the same `poll` as its own descriptor and wake up as soon
+//! as another thread aborts, instead of when the remaining timeout runs out.
+//! Elsewhere a mutex and condition variable stand in for it, which covers
+//! the waits that are plain sleeps.
+
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+#[cfg(target_os = "linux")]
+use rustix::event::{EventfdFlags, PollFd, PollFlags, Timespec, eventfd, poll};
+#[cfg(target_os = "linux")]
+use rustix::fd::{AsFd, BorrowedFd, OwnedFd};
+#[cfg(target_os = "linux")]
+use rustix::io::{Errno, read, write};
+#[cfg(not(target_os = "linux"))]
+use std::sync::{Condvar, Mutex};
+
+/// The wait ended because the token was cancelled. Observing a cancellation
+/// consumes it.
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub struct Cancelled;
+
+/// How a wait on a descriptor alongside the token ended.
+#[cfg(target_os = "linux")]
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub enum Wake {
+    Ready(PollFlags),
+    TimedOut,
+    Cancelled,
+}
+
+#[derive(Clone)]
+pub struct CancelToken {
+    inner: Arc<Signal>,
+}
+
+impl CancelToken {
+    pub fn new() -> std::io::Result<Self> {
+        Ok(Self {
+            inner: Arc::new(Signal::new()?),
+        })
+    }
+
+    pub fn cancel(&self) {
+        self.inner.raise();
+    }
+
+    /// Drops a cancellation nobody has observed yet, before a new command.
+    pub fn reset(&self) {
+        self.inner.take();
+    }
+
+    /// Consumes a pending cancellation without waiting.
+    pub fn check(&self) -> Result<(), Cancelled> {
+        if self.inner.take() {
+            Err(Cancelled)
+        } else {
+            Ok(())
+        }
+    }
+
+    /// Sleeps for `duration` unless the token is cancelled first.
+    pub fn sleep(&self, duration: Duration) -> Result<(), Cancelled> {
+        self.inner.wait(duration)
+    }
+
+    /// Waits until `fd` reports one of `flags`, the token is cancelled or
+    /// `timeout` passes; `None` waits forever. A cancellation wins over a
+    /// descriptor that became ready at the same time.
+    #[cfg(target_os = "linux")]
+    pub fn wait_fd(
+        &self,
+        fd: BorrowedFd<'_>,
+        flags: PollFlags,
+        timeout: Option<Duration>,
+    ) -> rustix::io::Result<Wake> {
+        let deadline = timeout.map(|timeout| Instant::now() + timeout);
+        loop {
+            let mut pollfds = [
+                PollFd::from_borrowed_fd(fd, flags),
+                PollFd::new(&self.inner.fd, PollFlags::IN),
+            ];
+            let timespec = deadline
+                .map(|deadline| timespec(deadline.saturating_duration_since(Instant::now())));
+            match poll(&mut pollfds, timespec.as_ref()) {
+                Ok(0) => return Ok(Wake::TimedOut),
+                Ok(_) => {}
+                Err(Errno::INTR) => continue,
+                Err(error) => return Err(error),
+            }
+            if !pollfds[1].revents().is_empty() && self.inner.take() {
+                return Ok(Wake::Cancelled);
+            }
+            let revents = pollfds[0].revents();
+            if !revents.is_empty() {
+                return Ok(Wake::Ready(revents));
+            }
+        }
+    }
+}
+
+#[cfg(target_os = "linux")]
+impl AsFd for CancelToken {
+    fn as_fd(&self) -> BorrowedFd<'_> {
+        self.inner.fd.as_fd()
+    }
+}
+
+#[cfg(target_os = "linux")]
+struct Signal {
+    fd: OwnedFd,
+}
+
+#[cfg(target_os = "linux")]
+impl Signal {
+    fn new() -> std::io::Result<Self> {
+        let fd = eventfd(0, EventfdFlags::CLOEXEC | EventfdFlags::NONBLOCK)?;
+        Ok(Self { fd })
+    }
+
+    fn raise(&self) {
+        // Only fails once the counter is about to overflow, and then the
+        // token is already readable.
+        let _ = write(&self.fd, &1u64.to_ne_bytes());
+    }
+
+    // Reading an eventfd returns its counter and clears it in one step.
+    fn take(&self) -> bool {
+        let mut counter = [0u8; 8];
+        loop {
+            match read(&self.fd, &mut counter[..]) {
+                Ok(_) => return true,
+                Err(Errno::INTR) => continue,
+                Err(_) => return false,
+            }
+        }
+    }
+
+    fn wait(&self, duration: Duration) -> Result<(), Cancelled> {
+        let deadline = Instant::now() + duration;
+        loop {
+            let mut pollfds = [PollFd::new(&self.fd, PollFlags::IN)];
+            let timeout = timespec(deadline.saturating_duration_since(Instant::now()));
+            match poll(&mut pollfds, Some(&timeout)) {
+                Ok(0) => return Ok(()),
+                Ok(_) if self.take() => return Err(Cancelled),
+                // Someone else consumed it first; sleep out the rest.
+                Ok(_) | Err(Errno::INTR) => {}
+                Err(_) => {
+                    std::thread::sleep(deadline.saturating_duration_since(Instant::now()));
+                    return Ok(());
+                }
+            }
+            if Instant::now() >= deadline {
+                return Ok(());
+            }
+        }
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn timespec(duration: Duration) -> Timespec {
+    Timespec {
+        tv_sec: duration.as_secs() as i64,
+        tv_nsec: i64::from(duration.subsec_nanos()),
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+struct Signal {
+    cancelled: Mutex<bool>,
+    changed: Condvar,
+}
+
+#[cfg(not(target_os = "linux"))]
+impl Signal {
+    fn new() -> std::io::Result<Self> {
+        Ok(Self {
+            cancelled: Mutex::new(false),
+            changed: Condvar::new(),
+        })
+    }
+
+    fn raise(&self) {
+        *self
+            .cancelled
+            .lock()
+            .unwrap_or_else(|error| error.into_inner()) = true;
+        self.changed.notify_all();
+    }
+
+    fn take(&self) -> bool {
+        std::mem::take(
+            &mut *self
+                .cancelled
+                .lock()
+                .unwrap_or_else(|error| error.into_inner()),
+        )
+    }
+
+    fn wait(&self, duration: Duration) -> Result<(), Cancelled> {
+        let deadline = Instant::now() + duration;
+        let mut cancelled = self
+            .cancelled
+            .lock()
+            .unwrap_or_else(|error| error.into_inner());
+        loop {
+            if std::mem::take(&mut *cancelled) {
+                return Err(Cancelled);
+            }
+            let remaining = deadline.saturating_duration_since(Instant::now());
+            if remaining.is_zero() {
+                return Ok(());
+            }
+            cancelled = self
+                .changed
+                .wait_timeout(cancelled, remaining)
+                .unwrap_or_else(|error| error.into_inner())
+                .0;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    #[cfg(target_os = "linux")]
+    use std::io::Write;
+    #[cfg(target_os = "linux")]
+    use std::os::unix::net::UnixStream;
+    use std::thread;
+
+    const WAIT: Duration = Duration::from_secs(5);
+
+    #[test]
+    fn cancel_wakes_a_sleeper_on_another_thread() {
+        let token = CancelToken::new().unwrap();
+        let canceller = token.clone();
+        let waiter = thread::spawn(move || {
+            let started = Instant::now();
+            (token.sleep(WAIT), started.elapsed())
+        });
+        thread::sleep(Duration::from_millis(20));
+        canceller.cancel();
+
+        let (result, elapsed) = waiter.join().unwrap();
+        assert_eq!(result, Err(Cancelled));
+        assert!(elapsed < WAIT / 2, "woke after {elapsed:?}");
+    }
+
+    #[test]
+    fn a_cancellation_is_consumed_once_and_cleared_by_reset() {
+        let token = CancelToken::new().unwrap();
+        assert_eq!(token.check(), Ok(()));
+
+        token.cancel();
+        token.cancel();
+        assert_eq!(token.sleep(Duration::from_millis(1)), Err(Cancelled));
+        assert_eq!(token.check(), Ok(()));
+
+        token.cancel();
+        token.reset();
+        assert_eq!(token.sleep(Duration::from_millis(1)), Ok(()));
+    }
+
+    #[cfg(target_os = "linux")]
+    #[test]
+    fn wait_fd_ends_on_whichever_comes_first() {
+        let token = CancelToken::new().unwrap();
+        let (reader, mut writer) = UnixStream::pair().unwrap();
+
+        assert_eq!(
+            token
+                .wait_fd(
+                    reader.as_fd(),
+                    PollFlags::IN,
+                    Some(Duration::from_millis(1))
+                )
+                .unwrap(),
+            Wake::TimedOut
+        );
+
+        let canceller = token.clone();
+        let cancel = thread::spawn(move || {
+            thread::sleep(Duration::from_millis(20));
+            canceller.cancel();
+        });
+        assert_eq!(
+            token.wait_fd(reader.as_fd(), PollFlags::IN, None).unwrap(),
+            Wake::Cancelled
+        );
+        cancel.join().unwrap();
+
+        writer.write_all(&[0x55]).unwrap();
+        assert_eq!(
+            token
+                .wait_fd(reader.as_fd(), PollFlags::IN, Some(WAIT))
+                .unwrap(),
+            Wake::Ready(PollFlags::IN)
+        );
+    }
+}
@@ -0,0 +1,312 @@
+//! ISO/IEC 14443 CRC_A and CRC_B (CRC-16/CCITT, reflected, x^16 + x^12 +
+//! x^5 + 1). CRC_A starts from 0x6363; CRC_B starts from 0xffff and is
+//! inverted at the end. Both are returned least significant byte first, the
+//! order they are sent on the air.
+//!
+//! Three kernels compute the same register update. `Bytewise` is the
+//! original shift-and-xor loop and serves as the reference; `SliceBy8`
+//! consumes eight bytes per step from eight lookup tables; `Clmul` folds
+//! 16-byte blocks with carry-less multiplication and is only available on
+//! x86_64 CPUs with PCLMULQDQ. `CrcKernel::detect` picks the fastest one the
+//! running CPU supports.
+
+const POLY: u32 = 0x1_1021;
+const POLY_REFLECTED: u16 = 0x8408;
+const CRC_A_INIT: u16 = 0x6363;
+const CRC_B_INIT: u16 = 0xffff;
+
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub enum CrcKernel {
+    Bytewise,
+    SliceBy8,
+    Clmul,
+}
+
+impl CrcKernel {
+    pub const ALL: [Self; 3] = [Self::Bytewise, Self::SliceBy8, Self::Clmul];
+
+    /// Fastest kernel the running CPU supports.
+    pub fn detect() -> Self {
+        if Self::Clmul.is_available() {
+            Self::Clmul
+        } else {
+            Self::SliceBy8
+        }
+    }
+
+    pub fn is_available(self) -> bool {
+        match self {
+            Self::Bytewise | Self::SliceBy8 => true,
+            Self::Clmul => clmul_available(),
+        }
+    }
+
+    // Advances the CRC register over `data`. An unavailable kernel falls
+    // back to slice-by-8.
+    fn update(self, crc: u16, data: &[u8]) -> u16 {
+        match self {
+            Self::Bytewise => update_bytewise(crc, data),
+            Self::SliceBy8 => update_slice_by_8(crc, data),
+            Self::Clmul => update_clmul(crc, data),
+        }
+    }
+}
+
+pub fn iso14443a_crc(data: &[u8]) -> [u8; 2] {
+    iso14443a_crc_with(CrcKernel::detect(), data)
+}
+
+pub fn iso14443b_crc(data: &[u8]) -> [u8; 2] {
+    iso14443b_crc_with(CrcKernel::detect(), data)
+}
+
+pub fn iso14443a_crc_with(kernel: CrcKernel, data: &[u8]) -> [u8; 2] {
+    kernel.update(CRC_A_INIT, data).to_le_bytes()
+}
+
+pub fn iso14443b_crc_with(kernel: CrcKernel, data: &[u8]) -> [u8; 2] {
+    (!kernel.update(CRC_B_INIT, data)).to_le_bytes()
+}
+
+fn update_bytewise(mut crc: u16, data: &[u8]) -> u16 {
+    for byte in data {
+        let mut value = *byte ^ (crc as u8);
+        value ^= value << 4;
+        crc = (crc >> 8)
+            ^ (u16::from(value) << 8)
+            ^ (u16::from(value) << 3)
+            ^ (u16::from(value) >> 4);
+    }
+    crc
+}
+
+// TABLES[0] is the classic byte table; TABLES[k] advances a byte's
+// contribution over k further zero bytes.
+static TABLES: [[u16; 256]; 8] = slice_tables();
+
+const fn slice_tables() -> [[u16; 256]; 8] {
+    let mut tables = [[0u16; 256]; 8];
+    let mut index = 0;
+    while index < 256 {
+        let mut crc = index as u16;
+        let mut bit = 0;
+        while bit < 8 {
+            crc = if crc & 1 != 0 {
+                (crc >> 1) ^ POLY_REFLECTED
+            } else {
+                crc >> 1
+            };
+            bit += 1;
+        }
+        tables[0][index] = crc;
+        index += 1;
+    }
+    let mut table = 1;
+    while table < 8 {
+        let mut index = 0;
+        while index < 256 {
+            let previous = tables[table - 1][index];
+            tables[table][index] = (previous >> 8) ^ tables[0][(previous & 0xff) as usize];
+            index += 1;
+        }
+        table += 1;
+    }
+    tables
+}
+
+fn update_slice_by_8(mut crc: u16, data: &[u8]) -> u16 {
+    let mut chunks = data.chunks_exact(8);
+    for chunk in &mut chunks {
+        let low = chunk[0] ^ crc as u8;
+        let high = chunk[1] ^ (crc >> 8) as u8;
+        crc = TABLES[7][usize::from(low)]
+            ^ TABLES[6][usize::from(high)]
+            ^ TABLES[5][usize::from(chunk[2])]
+            ^ TABLES[4][usize::from(chunk[3])]
+            ^ TABLES[3][usize::from(chunk[4])]
+            ^ TABLES[2][usize::from(chunk[5])]
+            ^ TABLES[1][usize::from(chunk[6])]
+            ^ TABLES[0][usize::from(chunk[7])];
+    }
+    for byte in chunks.remainder() {
+        crc = (crc >> 8) ^ TABLES[0][usize::from(*byte ^ crc as u8)];
+    }
+    crc
+}
+
+// x^n mod P, in normal (most significant bit first) order.
+const fn x_pow_mod(n: u32) -> u16 {
+    let mut remainder = 1u32;
+    let mut step = 0;
+    while step < n {
+        remainder <<= 1;
+        if remainder & 0x1_0000 != 0 {
+            remainder ^= POLY;
+        }
+        step += 1;
+    }
+    remainder as u16
+}
+
+// Places a polynomial of degree < 16 in a reflected 64-bit lane, where bit i
+// holds the coefficient of x^(63 - i).
+const fn reflect_lane(value: u16) -> u64 {
+    (value.reverse_bits() as u64) << 48
+}
+
+// A 16-byte block loaded little-endian puts the coefficient of x^(127 - i)
+// in bit i. Its low lane H and high lane L stand for H * x^64 + L, so the
+// block shifted past the next one is congruent to H * (x^192 mod P) +
+// L * (x^128 mod P).
+const FOLD_HIGH: u64 = reflect_lane(x_pow_mod(192));
+const FOLD_LOW: u64 = reflect_lane(x_pow_mod(128));
+
+#[cfg(target_arch = "x86_64")]
+fn clmul_available() -> bool {
+    std::arch::is_x86_feature_detected!("pclmulqdq") && std::arch::is_x86_feature_detected!("sse2")
+}
+
+#[cfg(not(target_arch = "x86_64"))]
+fn clmul_available() -> bool {
+    false
+}
+
+#[cfg(target_arch = "x86_64")]
+fn update_clmul(crc: u16, data: &[u8]) -> u16 {
+    if !clmul_available() {
+        return update_slice_by_8(crc, data);
+    }
+    // SAFETY: the CPU supports PCLMULQDQ and SSE2, checked above.
+    unsafe { update_clmul_x86(crc, data) }
+}
+
+#[cfg(not(target_arch = "x86_64"))]
+fn update_clmul(crc: u16, data: &[u8]) -> u16 {
+    update_slice_by_8(crc, data)
+}
+
+// Folds every full block into the first one, which keeps the message
+// congruent modulo P, then finishes the folded block and the tail with the
+// tables. The register is xored into the first two bytes, so the folding
+// itself starts from zero.
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "pclmulqdq,sse2")]
+unsafe fn update_clmul_x86(crc: u16, data: &[u8]) -> u16 {
+    const BLOCK: usize = 16;
+    if data.len() < 2 * BLOCK {
+        return update_slice_by_8(crc, data);
+    }
+    let (first, rest) = data.split_at(BLOCK);
+    let mut state = load_block(first) ^ u128::from(crc);
+    let mut blocks = rest.chunks_exact(BLOCK);
+    for block in &mut blocks {
+        let folded = clmul(state as u64, FOLD_HIGH) ^ clmul((state >> 64) as u64, FOLD_LOW);
+        state = (folded << 1) ^ load_block(block);
+    }
+    update_slice_by_8(
+        update_slice_by_8(0, &state.to_le_bytes()),
+        blocks.remainder(),
+    )
+}
+
+#[cfg(target_arch = "x86_64")]
+fn load_block(block: &[u8]) -> u128 {
+    let mut bytes = [0u8; 16];
+    bytes.copy_from_slice(block);
+    u128::from_le_bytes(bytes)
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "pclmulqdq,sse2")]
+fn clmul(a: u64, b: u64) -> u128 {
+    use std::arch::x86_64::{_mm_clmulepi64_si128, _mm_cvtsi64_si128};
+
+    let product = _mm_clmulepi64_si128(
+        _mm_cvtsi64_si128(a as i64),
+        _mm_cvtsi64_si128(b as i64),
+        0x00,
+    );
+    // SAFETY: __m128i and u128 have the same size; lane 0 is the low half.
+    unsafe { std::mem::transmute::<_, u128>(product) }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_rng::TestRng;
+
+    fn available_kernels() -> impl Iterator<Item = CrcKernel> {
+        CrcKernel::ALL
+            .into_iter()
+            .filter(|kernel| kernel.is_available())
+    }
+
+    #[test]
+    fn kernels_match_known_values() {
+        for kernel in available_kernels() {
+            assert_eq!(iso14443a_crc_with(kernel, &[0x26]), [0xca, 0x15]);
+            assert_eq!(iso14443a_crc_with(kernel, &[0x00, 0x00]), [0xa0, 0x1e]);
+            assert_eq!(iso14443a_crc_with(kernel, &[0x12, 0x34]), [0x26, 0xcf]);
+            assert_eq!(
+                iso14443b_crc_with(kernel, &[0x0a, 0x12, 0x34, 0x56]),
+                [0x2c, 0xf6]
+            );
+        }
+    }
+
+    #[test]
+    fn kernels_match_the_reference_on_every_two_byte_input() {
+        for kernel in available_kernels() {
+            for value in 0..=u16::MAX {
+                let data = value.to_le_bytes();
+                for init in [CRC_A_INIT, CRC_B_INIT] {
+                    assert_eq!(
+                        kernel.update(init, &data),
+                        update_bytewise(init, &data),
+                        "{kernel:?} {data:02x?}"
+                    );
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn kernels_match_the_reference_on_every_length_and_alignment() {
+        let mut rng = TestRng(0x9e37_79b9_7f4a_7c15);
+        let mut buffer = vec![0u8; 1024 + 16];
+        for round in 0..4 {
+            rng.fill(&mut buffer);
+            for offset in 0..16 {
+                for len in 0..=1024 {
+                    let data = &buffer[offset..offset + len];
+                    let expected_a = iso14443a_crc_with(CrcKernel::Bytewise, data);
+                    let expected_b = iso14443b_crc_with(CrcKernel::Bytewise, data);
+                    for kernel in available_kernels() {
+                        assert_eq!(
+                            iso14443a_crc_with(kernel, data),
+                            expected_a,
+                            "{kernel:?} round {round} offset {offset} len {len}"
+                        );
+                        assert_eq!(
+                            iso14443b_crc_with(kernel, data),
+                            expected_b,
+                            "{kernel:?} round {round} offset {offset} len {len}"
+                        );
+                    }
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn appending_the_crc_a_leaves_a_zero_residue() {
+        let mut rng = TestRng(7);
+        let mut frame = [0u8; 66];
+        rng.fill(&mut frame[..64]);
+        let crc = iso14443a_crc(&frame[..64]);
+        frame[64..].copy_from_slice(&crc);
+        for kernel in available_kernels() {
+            assert_eq!(kernel.update(CRC_A_INIT, &frame), 0, "{kernel:?}");
+        }
+    }
+}
@@ -0,0 +1,300 @@
+//! Interrupt lines read through the Linux GPIO character device.
+//!
+//! A reader that flags a pending response on a GPIO, like the PN532 on its
+//! IRQ pin, can be slept on instead of polled. The line is requested from
+//! its gpiochip with edge detection, and the request descriptor becomes
+//! readable each time the line turns active, so it can share a `poll` with
+//! a `CancelToken`. Transports take any `IrqLine`; tests drive
+//! `fake::FakeIrqLine` instead of hardware.
+
+use std::io;
+use std::mem;
+
+use rustix::fd::{AsFd, BorrowedFd, FromRawFd, OwnedFd};
+use rustix::fs::{Mode, OFlags, fcntl_getfl, fcntl_setfl, open};
+use rustix::io::{Errno, read};
+use rustix::ioctl::{self, Opcode, Updater, opcode};
+
+const GPIO_V2_GET_LINE_IOCTL: Opcode = opcode::read_write::<LineRequest>(0xb4, 0x07);
+const GPIO_V2_LINE_GET_VALUES_IOCTL: Opcode = opcode::read_write::<LineValues>(0xb4, 0x0e);
+const GPIO_V2_LINE_FLAG_ACTIVE_LOW: u64 = 1 << 1;
+const GPIO_V2_LINE_FLAG_INPUT: u64 = 1 << 2;
+// Inactive to active, whatever the polarity.
+const GPIO_V2_LINE_FLAG_EDGE_RISING: u64 = 1 << 4;
+const LINE_EVENT_LEN: usize = 48;
+
+/// A line given as the gpiochip it belongs to and its offset on that chip.
+#[derive(Clone, Debug, Eq, PartialEq)]
+pub struct GpioLineSpec {
+    pub chip: String,
+    pub offset: u32,
+}
+
+impl GpioLineSpec {
+    /// Parses `<chip>/<offset>`, where `<chip>` is a node under `/dev` such
+    /// as `gpiochip0`, or a full path to one.
+    pub fn parse(value: &str) -> Option<Self> {
+        let (chip, offset) = value.rsplit_once('/')?;
+        if chip.is_empty() {
+            return None;
+        }
+        Some(Self {
+            chip: chip.to_string(),
+            offset: offset.parse().ok()?,
+        })
+    }
+
+    pub fn chip_path(&self) -> String {
+        if self.chip.starts_with('/') {
+            self.chip.clone()
+        } else {
+            format!("/dev/{}", self.chip)
+        }
+    }
+}
+
+impl std::fmt::Display for GpioLineSpec {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        write!(f, "{}/{}", self.chip, self.offset)
+    }
+}
+
+/// An interrupt input. Its descriptor polls readable once the line has
+/// turned active since the last `clear_events`.
+pub trait IrqLine: AsFd + Send {
+    /// Whether the line is active right now.
+    fn is_active(&self) -> io::Result<bool>;
+
+    /// Drops the edges seen so far.
+    fn clear_events(&mut self) -> io::Result<()>;
+}
+
+/// A line requested from a gpiochip as an input with edge detection.
+pub struct GpioIrqLine {
+    fd: OwnedFd,
+}
+
+impl GpioIrqLine {
+    pub fn request(spec: &GpioLineSpec, consumer: &str, active_low: bool) -> io::Result<Self> {
+        let chip = open(
+            spec.chip_path(),
+            OFlags::RDONLY | OFlags::CLOEXEC,
+            Mode::empty(),
+        )?;
+
+        // SAFETY: every field is an integer, for which zero is valid.
+        let mut request: LineRequest = unsafe { mem::zeroed() };
+        request.offsets[0] = spec.offset;
+        request.num_lines = 1;
+        let consumer_len = consumer.len().min(request.consumer.len() - 1);
+        request.consumer[..consumer_len].copy_from_slice(&consumer.as_bytes()[..consumer_len]);
+        request.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING;
+        if active_low {
+            request.config.flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+        }
+        // SAFETY: GPIO_V2_GET_LINE_IOCTL reads and updates a
+        // `struct gpio_v2_line_request`.
+        unsafe {
+            ioctl::ioctl(
+                &chip,
+                Updater::<GPIO_V2_GET_LINE_IOCTL, LineRequest>::new(&mut request),
+            )
+        }?;
+        // SAFETY: on success the kernel stored a new descriptor we now own.
+        let fd = unsafe { OwnedFd::from_raw_fd(request.fd) };
+        fcntl_setfl(&fd, fcntl_getfl(&fd)? | OFlags::NONBLOCK)?;
+        Ok(Self { fd })
+    }
+}
+
+impl AsFd for GpioIrqLine {
+    fn as_fd(&self) -> BorrowedFd<'_> {
+        self.fd.as_fd()
+    }
+}
+
+impl IrqLine for GpioIrqLine {
+    fn is_active(&self) -> io::Result<bool> {
+        let mut values = LineValues { bits: 0, mask: 1 };
+        // SAFETY: GPIO_V2_LINE_GET_VALUES_IOCTL reads and updates a
+        // `struct gpio_v2_line_values`.
+        unsafe {
+            ioctl::ioctl(
+                &self.fd,
+                Updater::<GPIO_V2_LINE_GET_VALUES_IOCTL, LineValues>::new(&mut values),
+            )
+        }?;
+        Ok(values.bits & 1 != 0)
+    }
+
+    fn clear_events(&mut self) -> io::Result<()> {
+        let mut events = [0u8; LINE_EVENT_LEN * 16];
+        loop {
+            match read(&self.fd, &mut events[..]) {
+                Ok(len) if len == events.len() => {}
+                Ok(_) | Err(Errno::AGAIN) => return Ok(()),
+                Err(Errno::INTR) => {}
+                Err(error) => return Err(error.into()),
+            }
+        }
+    }
+}
+
+// The v2 uAPI structures from <linux/gpio.h>.
+#[repr(C)]
+struct LineAttribute {
+    id: u32,
+    padding: u32,
+    value: u64,
+}
+
+#[repr(C)]
+struct LineConfigAttribute {
+    attr: LineAttribute,
+    mask: u64,
+}
+
+#[repr(C)]
+struct LineConfig {
+    flags: u64,
+    num_attrs: u32,
+    padding: [u32; 5],
+    attrs: [LineConfigAttribute; 10],
+}
+
+#[repr(C)]
+struct LineRequest {
+    offsets: [u32; 64],
+    consumer: [u8; 32],
+    config: LineConfig,
+    num_lines: u32,
+    event_buffer_size: u32,
+    padding: [u32; 5],
+    fd: i32,
+}
+
+#[repr(C)]
+struct LineValues {
+    bits: u64,
+    mask: u64,
+}
+
+const _: () = assert!(mem::size_of::<LineRequest>() == 592);
+
+#[cfg(test)]
+pub(crate) mod fake {
+    use super::*;
+    use std::io::{ErrorKind, Read, Write};
+    use std::os::unix::net::UnixStream;
+    use std::sync::Arc;
+    use std::sync::atomic::{AtomicBool, Ordering};
+
+    /// Line whose level a test sets through the paired `FakeIrqPin`. Edges
+    /// are bytes on a socket pair, so waits poll a real descriptor.
+    pub(crate) struct FakeIrqLine {
+        events: UnixStream,
+        active: Arc<AtomicBool>,
+    }
+
+    #[derive(Clone)]
+    pub(crate) struct FakeIrqPin {
+        events: Arc<UnixStream>,
+        active: Arc<AtomicBool>,
+    }
+
+    pub(crate) fn irq_line() -> (FakeIrqLine, FakeIrqPin) {
+        let (reader, writer) = UnixStream::pair().unwrap();
+        reader.set_nonblocking(true).unwrap();
+        let active = Arc::new(AtomicBool::new(false));
+        (
+            FakeIrqLine {
+                events: reader,
+                active: Arc::clone(&active),
+            },
+            FakeIrqPin {
+                events: Arc::new(writer),
+                active,
+            },
+        )
+    }
+
+    impl FakeIrqPin {
+        pub(crate) fn set_active(&self, active: bool) {
+            let was_active = self.active.swap(active, Ordering::SeqCst);
+            if active && !was_active {
+                (&*self.events).write_all(&[1]).unwrap();
+            }
+        }
+    }
+
+    impl AsFd for FakeIrqLine {
+        fn as_fd(&self) -> BorrowedFd<'_> {
+            self.events.as_fd()
+        }
+    }
+
+    impl IrqLine for FakeIrqLine {
+        fn is_active(&self) -> io::Result<bool> {
+            Ok(self.active.load(Ordering::SeqCst))
+        }
+
+        fn clear_events(&mut self) -> io::Result<()> {
+            let mut edges = [0u8; 16];
+            loop {
+                match self.events.read(&mut edges) {
+                    Ok(0) => return Ok(()),
+                    Ok(_) => {}
+                    Err(error) if error.kind() == ErrorKind::WouldBlock => return Ok(()),
+                    Err(error) => return Err(error),
+                }
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use rustix::event::{PollFd, PollFlags, Timespec, poll};
+
+    fn has_edge(line: &impl IrqLine) -> bool {
+        let mut pollfds = [PollFd::new(line, PollFlags::IN)];
+        poll(&mut pollfds, Some(&Timespec::default())).unwrap() == 1
+    }
+
+    #[test]
+    fn line_specs_name_a_chip_and_an_offset() {
+        let spec = GpioLineSpec::parse("gpiochip0/25").unwrap();
+        assert_eq!(spec.chip_path(), "/dev/gpiochip0");
+        assert_eq!(spec.offset, 25);
+        assert_eq!(spec.to_string(), "gpiochip0/25");
+        assert_eq!(
+            GpioLineSpec::parse("/dev/gpiochip4/3").unwrap().chip_path(),
+            "/dev/gpiochip4"
+        );
+
+        for invalid in ["gpiochip0", "gpiochip0/", "/7", "gpiochip0/x"] {
+            assert_eq!(GpioLineSpec::parse(invalid), None, "{invalid}");
+        }
+    }
+
+    #[test]
+    fn fake_line_edges_stay_readable_until_cleared() {
+        let (mut line, pin) = fake::irq_line();
+        assert!(!line.is_active().unwrap());
+        assert!(!has_edge(&line));
+
+        pin.set_active(true);
+        pin.set_active(true);
+        assert!(line.is_active().unwrap());
+        assert!(has_edge(&line));
+
+        line.clear_events().unwrap();
+        assert!(!has_edge(&line));
+        assert!(line.is_active().unwrap());
+
+        pin.set_active(false);
+        pin.set_active(true);
+        assert!(has_edge(&line));
+    }
+}
@@ -0,0 +1,628 @@
+use std::collections::{BTreeMap, BTreeSet, VecDeque};
+use std::path::{Path, PathBuf};
+#[cfg(target_os = "linux")]
+use std::time::{Duration, Instant};
+
+use proximate_driver::{ConnectionString, Context, DiscoveredDevice, DriverRegistry, Error};
+
+#[cfg(target_os = "linux")]
+use rustix::event::{EventfdFlags, PollFd, PollFlags, Timespec, epoll, eventfd, poll};
+#[cfg(target_os = "linux")]
+use rustix::fd::{AsRawFd, OwnedFd, RawFd};
+#[cfg(target_os = "linux")]
+use rustix::fs::inotify::{self, CreateFlags, ReadFlags, WatchFlags};
+#[cfg(target_os = "linux")]
+use rustix::fs::{Access, access};
+#[cfg(target_os = "linux")]
+use rustix::io::{Errno, read, write};
+
+pub const DEFAULT_DEVICE_DIR: &str = "/dev";
+/// Where usbfs keeps one directory per bus, holding one node per device.
+pub const USB_DEVICE_SUBDIR: &str = "bus/usb";
+
+#[cfg(target_os = "linux")]
+const NFC_EIO: i32 = -1;
+#[cfg(target_os = "linux")]
+const EVENT_BUFFER_LEN: usize = 4096;
+
+#[derive(Clone, Debug, Eq, PartialEq)]
+pub enum DeviceEvent {
+    Added(DiscoveredDevice),
+    Removed(ConnectionString),
+}
+
+/// Watches a device directory and turns node arrivals and departures into
+/// device events. Only the node that changed is probed; devices found on it
+/// are remembered so its removal can be reported by connection string.
+/// USB readers appear as `bus/usb/<bus>/<device>` below the directory, so
+/// that tree is watched as well.
+pub struct DeviceMonitor {
+    #[cfg(target_os = "linux")]
+    fd: OwnedFd,
+    // Raised while `pending` holds events, so the exported descriptor stays
+    // readable until every event drained from inotify has been handed out.
+    #[cfg(target_os = "linux")]
+    ready: OwnedFd,
+    #[cfg(target_os = "linux")]
+    ready_raised: bool,
+    // Polls readable when either of the above does; this is the descriptor
+    // callers wait on.
+    #[cfg(target_os = "linux")]
+    epoll: OwnedFd,
+    #[cfg(target_os = "linux")]
+    watches: BTreeMap<i32, PathBuf>,
+    dir: PathBuf,
+    known: BTreeMap<String, Vec<ConnectionString>>,
+    // Nodes whose probe found nothing because we could not open them yet.
+    denied: BTreeSet<String>,
+    pending: VecDeque<DeviceEvent>,
+}
+
+impl DeviceMonitor {
+    pub fn new() -> Result<Self, Error> {
+        Self::watch_dir(Path::new(DEFAULT_DEVICE_DIR))
+    }
+
+    pub fn dir(&self) -> &Path {
+        &self.dir
+    }
+
+    fn node_added(&mut self, registry: &DriverRegistry, context: &Context, path: String) {
+        if self.known.contains_key(&path) {
+            return;
+        }
+        let devices = registry.probe_node(context, &path).unwrap_or_default();
+        if devices.is_empty() {
+            // A node may appear before udev has fixed its permissions; the
+            // probe is retried once they change.
+            if access_denied(&path) {
+                self.denied.insert(path);
+            }
+            return;
+        }
+        self.denied.remove(&path);
+        registry.invalidate_scan_cache();
+        self.known.insert(
+            path,
+            devices
+                .iter()
+                .map(|device| device.connstring.clone())
+                .collect(),
+        );
+        self.pending
+            .extend(devices.into_iter().map(DeviceEvent::Added));
+    }
+
+    /// An attribute change only matters to a node we were denied access
+    /// to: touching or re-labelling any other node must not probe it again.
+    fn node_attributes_changed(
+        &mut self,
+        registry: &DriverRegistry,
+        context: &Context,
+        path: String,
+    ) {
+        if self.denied.remove(&path) {
+            self.node_added(registry, context, path);
+        }
+    }
+
+    fn node_removed(&mut self, registry: &DriverRegistry, path: &str) {
+        self.denied.remove(path);
+        if let Some(connstrings) = self.known.remove(path) {
+            registry.invalidate_scan_cache();
+            self.pending
+                .extend(connstrings.into_iter().map(DeviceEvent::Removed));
+        }
+    }
+
+    fn dir_removed(&mut self, registry: &DriverRegistry, dir: &Path) {
+        let gone = self
+            .known
+            .keys()
+            .filter(|path| Path::new(path).starts_with(dir))
+            .cloned()
+            .collect::<Vec<_>>();
+        self.denied.retain(|path| !Path::new(path).starts_with(dir));
+        for path in gone {
+            self.node_removed(registry, &path);
+        }
+    }
+
+    /// Whether `path` is `bus/usb`, one of its parents below the watched
+    /// directory, or one of its bus directories.
+    fn is_usb_tree_dir(&self, path: &Path) -> bool {
+        let usb_root = self.dir.join(USB_DEVICE_SUBDIR);
+        (path.starts_with(&self.dir) && path != self.dir && usb_root.starts_with(path))
+            || path.parent() == Some(usb_root.as_path())
+    }
+}
+
+#[cfg(target_os = "linux")]
+impl DeviceMonitor {
+    pub fn watch_dir(dir: &Path) -> Result<Self, Error> {
+        let fd = inotify::init(CreateFlags::CLOEXEC | CreateFlags::NONBLOCK)
+            .map_err(|_| device_error("inotify_init"))?;
+        let ready = eventfd(0, EventfdFlags::CLOEXEC | EventfdFlags::NONBLOCK)
+            .map_err(|_| device_error("device_monitor_eventfd"))?;
+        let epoll = epoll::create(epoll::CreateFlags::CLOEXEC)
+            .map_err(|_| device_error("device_monitor_epoll"))?;
+        for source in [&fd, &ready] {
+            epoll::add(
+                &epoll,
+                source,
+                epoll::EventData::new_u64(0),
+                epoll::EventFlags::IN,
+            )
+            .map_err(|_| device_error("device_monitor_epoll"))?;
+        }
+
+        let mut monitor = Self {
+            fd,
+            ready,
+            ready_raised: false,
+            epoll,
+            watches: BTreeMap::new(),
+            dir: dir.to_path_buf(),
+            known: BTreeMap::new(),
+            denied: BTreeSet::new(),
+            pending: VecDeque::new(),
+        };
+        monitor.add_watch(dir)?;
+        // Nodes already present are not reported, only later changes.
+        let usb_root = dir.join(USB_DEVICE_SUBDIR);
+        if usb_root.is_dir() {
+            monitor.add_watch(&usb_root)?;
+            for bus in subdirectories(&usb_root) {
+                monitor.add_watch(&bus)?;
+            }
+        }
+        Ok(monitor)
+    }
+
+    /// Descriptor that stays readable while device events may be waiting,
+    /// whether queued by the kernel or already drained into this monitor.
+    pub fn as_raw_fd(&self) -> RawFd {
+        self.epoll.as_raw_fd()
+    }
+
+    /// Waits up to `timeout_ms` (negative blocks) for the next device event.
+    /// Node changes that no driver claims are consumed silently.
+    pub fn next_event(
+        &mut self,
+        registry: &DriverRegistry,
+        context: &Context,
+        timeout_ms: i32,
+    ) -> Result<Option<DeviceEvent>, Error> {
+        let deadline = u64::try_from(timeout_ms)
+            .ok()
+            .map(|ms| Instant::now() + Duration::from_millis(ms));
+
+        loop {
+            if let Some(event) = self.pending.pop_front() {
+                self.sync_ready()?;
+                return Ok(Some(event));
+            }
+
+            if !self.wait_readable(deadline)? {
+                self.sync_ready()?;
+                return Ok(None);
+            }
+            self.drain_changes(registry, context)?;
+        }
+    }
+
+    fn add_watch(&mut self, dir: &Path) -> Result<(), Error> {
+        let wd = inotify::add_watch(
+            &self.fd,
+            dir,
+            WatchFlags::CREATE
+                | WatchFlags::ATTRIB
+                | WatchFlags::DELETE
+                | WatchFlags::MOVED_FROM
+                | WatchFlags::MOVED_TO
+                | WatchFlags::ONLYDIR,
+        )
+        .map_err(|_| device_error("inotify_add_watch"))?;
+        self.watches.insert(wd, dir.to_path_buf());
+        Ok(())
+    }
+
+    /// Starts watching a directory of the USB tree that just appeared. Its
+    /// contents may have been created before the watch was in place, so
+    /// they are treated as arrivals.
+    fn usb_dir_added(&mut self, registry: &DriverRegistry, context: &Context, dir: &Path) {
+        if self.watches.values().any(|watched| watched == dir) || self.add_watch(dir).is_err() {
+            return;
+        }
+        let Ok(entries) = std::fs::read_dir(dir) else {
+            return;
+        };
+        for entry in entries.flatten() {
+            let path = entry.path();
+            if path.is_dir() {
+                if self.is_usb_tree_dir(&path) {
+                    self.usb_dir_added(registry, context, &path);
+                }
+            } else {
+                self.node_added(registry, context, path.to_string_lossy().into_owned());
+            }
+        }
+    }
+
+    /// Raises the readiness eventfd while events are pending, and lowers it
+    /// once they have all been handed out.
+    fn sync_ready(&mut self) -> Result<(), Error> {
+        let queued = !self.pending.is_empty();
+        if queued == self.ready_raised {
+            return Ok(());
+        }
+        let mut counter = 1u64.to_ne_bytes();
+        let result = if queued {
+            write(&self.ready, &counter)
+        } else {
+            read(&self.ready, &mut counter)
+        };
+        match result {
+            Ok(_) | Err(Errno::AGAIN) => {
+                self.ready_raised = queued;
+                Ok(())
+            }
+            Err(_) => Err(device_error("device_monitor_eventfd")),
+        }
+    }
+
+    fn wait_readable(&self, deadline: Option<Instant>) -> Result<bool, Error> {
+        loop {
+            let timeout = deadline.map(|deadline| {
+                let remaining = deadline.saturating_duration_since(Instant::now());
+                Timespec {
+                    tv_sec: remaining.as_secs() as i64,
+                    tv_nsec: i64::from(remaining.subsec_nanos()),
+                }
+            });
+            let mut pollfd = [PollFd::new(&self.fd, PollFlags::IN)];
+            match poll(&mut pollfd, timeout.as_ref()) {
+                Ok(ready) => return Ok(ready > 0),
+                Err(Errno::INTR) => continue,
+                Err(_) => return Err(device_error("device_monitor_poll")),
+            }
+        }
+    }
+
+    fn drain_changes(&mut self, registry: &DriverRegistry, context: &Context) -> Result<(), Error> {
+        let mut changes = Vec::new();
+        let mut buffer = [std::mem::MaybeUninit::<u8>::uninit(); EVENT_BUFFER_LEN];
+        let mut reader = inotify::Reader::new(&self.fd, &mut buffer);
+        loop {
+            match reader.next() {
+                Ok(event) => {
+                    let flags = event.events();
+                    if flags.contains(ReadFlags::IGNORED) {
+                        changes.push((flags, event.wd(), None));
+                        continue;
+                    }
+                    let Some(name) = event.file_name() else {
+                        continue;
+                    };
+                    let Some(dir) = self.watches.get(&event.wd()) else {
+                        continue;
+                    };
+                    let path = dir.join(name.to_string_lossy().as_ref());
+                    changes.push((flags, event.wd(), Some(path)));
+                }
+                Err(Errno::AGAIN) => break,
+                Err(Errno::INTR) => continue,
+                Err(_) => return Err(device_error("device_monitor_read")),
+            }
+        }
+
+        for (flags, wd, path) in changes {
+            let Some(path) = path else {
+                self.watches.remove(&wd);
+                continue;
+            };
+            let removed = flags.intersects(ReadFlags::DELETE | ReadFlags::MOVED_FROM);
+            if flags.contains(ReadFlags::ISDIR) {
+                if removed {
+                    self.dir_removed(registry, &path);
+                } else if flags.intersects(ReadFlags::CREATE | ReadFlags::MOVED_TO)
+                    && self.is_usb_tree_dir(&path)
+                {
+                    self.usb_dir_added(registry, context, &path);
+                }
+            } else if removed {
+                self.node_removed(registry, &path.to_string_lossy());
+            } else if flags.intersects(ReadFlags::CREATE | ReadFlags::MOVED_TO) {
+                self.node_added(registry, context, path.to_string_lossy().into_owned());
+            } else if flags.contains(ReadFlags::ATTRIB) {
+                self.node_attributes_changed(
+                    registry,
+                    context,
+                    path.to_string_lossy().into_owned(),
+                );
+            }
+        }
+        Ok(())
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn access_denied(path: &str) -> bool {
+    access(path, Access::READ_OK | Access::WRITE_OK) == Err(Errno::ACCESS)
+}
+
+#[cfg(not(target_os = "linux"))]
+fn access_denied(_path: &str) -> bool {
+    false
+}
+
+#[cfg(target_os = "linux")]
+fn subdirectories(dir: &Path) -> Vec<PathBuf> {
+    std::fs::read_dir(dir)
+        .map(|entries| {
+            entries
+                .flatten()
+                .map(|entry| entry.path())
+                .filter(|path| path.is_dir())
+                .collect()
+        })
+        .unwrap_or_default()
+}
+
+#[cfg(not(target_os = "linux"))]
+impl DeviceMonitor {
+    pub fn watch_dir(_dir: &Path) -> Result<Self, Error> {
+        Err(Error::UnsupportedOperation("device monitor"))
+    }
+
+    pub fn as_raw_fd(&self) -> i32 {
+        -1
+    }
+
+    pub fn next_event(
+        &mut self,
+        _registry: &DriverRegistry,
+        _context: &Context,
+        _timeout_ms: i32,
+    ) -> Result<Option<DeviceEvent>, Error> {
+        Err(Error::UnsupportedOperation("device monitor"))
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn device_error(operation: &'static str) -> Error {
+    Error::DeviceOperationFailed {
+        operation,
+        code: NFC_EIO,
+    }
+}
+
+#[cfg(all(test, target_os = "linux"))]
+mod tests {
+    use super::*;
+    use proximate_driver::{DeviceHandle, Driver, ScanType};
+    use std::fs;
+    use std::sync::Arc;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+
+    #[derive(Default)]
+    struct NodeDriver {
+        probes: Arc<AtomicUsize>,
+    }
+
+    impl Driver for NodeDriver {
+        fn name(&self) -> &str {
+            "node"
+        }
+
+        fn scan_type(&self) -> ScanType {
+            ScanType::NotIntrusive
+        }
+
+        fn scan(&self, _context: &Context) -> Result<Vec<DiscoveredDevice>, Error> {
+            Ok(Vec::new())
+        }
+
+        fn probe_node(
+            &self,
+            _context: &Context,
+            path: &str,
+        ) -> Result<Vec<DiscoveredDevice>, Error> {
+            self.probes.fetch_add(1, Ordering::SeqCst);
+            let name = Path::new(path).file_name().unwrap().to_string_lossy();
+            if !name.starts_with("reader") {
+                return Ok(Vec::new());
+            }
+            Ok(vec![self.describe_discovered(
+                name.to_string(),
+                ConnectionString::new(format!("node:{name}")).unwrap(),
+                None,
+            )])
+        }
+
+        fn open(
+            &self,
+            _context: &Context,
+            connstring: &ConnectionString,
+        ) -> Result<Box<dyn DeviceHandle>, Error> {
+            Err(Error::DriverNotFound(connstring.as_str().to_string()))
+        }
+    }
+
+    struct TempDeviceDir(PathBuf);
+
+    impl TempDeviceDir {
+        fn new(tag: &str) -> Self {
+            let path = std::env::temp_dir()
+                .join(format!("proximate-hotplug-{tag}-{}", std::process::id()));
+            let _ = fs::remove_dir_all(&path);
+            fs::create_dir_all(&path).unwrap();
+            Self(path)
+        }
+    }
+
+    impl Drop for TempDeviceDir {
+        fn drop(&mut self) {
+            let _ = fs::remove_dir_all(&self.0);
+        }
+    }
+
+    fn fd_readable(monitor: &DeviceMonitor) -> bool {
+        // SAFETY: the monitor outlives this borrow of its descriptor.
+        let fd = unsafe { rustix::fd::BorrowedFd::borrow_raw(monitor.as_raw_fd()) };
+        let mut pollfd = [PollFd::new(&fd, PollFlags::IN)];
+        poll(&mut pollfd, Some(&Timespec::default())).unwrap() == 1
+    }
+
+    fn node_registry() -> DriverRegistry {
+        counting_node_registry().0
+    }
+
+    fn counting_node_registry() -> (DriverRegistry, Arc<AtomicUsize>) {
+        let driver = NodeDriver::default();
+        let probes = Arc::clone(&driver.probes);
+        let mut registry = DriverRegistry::new();
+        registry.register_driver(Box::new(driver));
+        (registry, probes)
+    }
+
+    #[test]
+    fn monitor_reports_added_and_removed_nodes_claimed_by_a_driver() {
+        let dir = TempDeviceDir::new("add-remove");
+        let registry = node_registry();
+        let context = Context::new();
+        let mut monitor = DeviceMonitor::watch_dir(&dir.0).unwrap();
+        assert!(monitor.as_raw_fd() >= 0);
+
+        fs::write(dir.0.join("reader0"), b"").unwrap();
+        let Some(DeviceEvent::Added(device)) =
+            monitor.next_event(&registry, &context, 1_000).unwrap()
+        else {
+            panic!("expected an added device");
+        };
+        assert_eq!(device.connstring.as_str(), "node:reader0");
+
+        fs::remove_file(dir.0.join("reader0")).unwrap();
+        assert_eq!(
+            monitor.next_event(&registry, &context, 1_000).unwrap(),
+            Some(DeviceEvent::Removed(
+                ConnectionString::new("node:reader0").unwrap()
+            ))
+        );
+    }
+
+    #[test]
+    fn monitor_ignores_nodes_no_driver_claims() {
+        let dir = TempDeviceDir::new("unclaimed");
+        let registry = node_registry();
+        let context = Context::new();
+        let mut monitor = DeviceMonitor::watch_dir(&dir.0).unwrap();
+
+        fs::write(dir.0.join("disk0"), b"").unwrap();
+        fs::remove_file(dir.0.join("disk0")).unwrap();
+        assert_eq!(monitor.next_event(&registry, &context, 50).unwrap(), None);
+    }
+
+    #[test]
+    fn monitor_reports_an_attribute_change_once() {
+        let dir = TempDeviceDir::new("attrib");
+        let registry = node_registry();
+        let context = Context::new();
+        let mut monitor = DeviceMonitor::watch_dir(&dir.0).unwrap();
+
+        let node = dir.0.join("reader1");
+        fs::write(&node, b"").unwrap();
+        let mut permissions = fs::metadata(&node).unwrap().permissions();
+        permissions.set_readonly(true);
+        fs::set_permissions(&node, permissions).unwrap();
+
+        assert!(matches!(
+            monitor.next_event(&registry, &context, 1_000).unwrap(),
+            Some(DeviceEvent::Added(_))
+        ));
+        assert_eq!(monitor.next_event(&registry, &context, 50).unwrap(), None);
+    }
+
+    #[test]
+    fn monitor_does_not_probe_an_accessible_node_again_on_attribute_changes() {
+        let dir = TempDeviceDir::new("attrib-unclaimed");
+        let (registry, probes) = counting_node_registry();
+        let context = Context::new();
+        let mut monitor = DeviceMonitor::watch_dir(&dir.0).unwrap();
+
+        let node = dir.0.join("ttyS9");
+        fs::write(&node, b"").unwrap();
+        assert_eq!(monitor.next_event(&registry, &context, 50).unwrap(), None);
+        assert_eq!(probes.load(Ordering::SeqCst), 1);
+
+        let mut permissions = fs::metadata(&node).unwrap().permissions();
+        permissions.set_readonly(true);
+        fs::set_permissions(&node, permissions).unwrap();
+        assert_eq!(monitor.next_event(&registry, &context, 50).unwrap(), None);
+        assert_eq!(probes.load(Ordering::SeqCst), 1);
+    }
+
+    #[test]
+    fn monitor_descriptor_stays_readable_while_events_are_queued() {
+        let dir = TempDeviceDir::new("batch");
+        let registry = node_registry();
+        let context = Context::new();
+        let mut monitor = DeviceMonitor::watch_dir(&dir.0).unwrap();
+        assert!(!fd_readable(&monitor));
+
+        fs::write(dir.0.join("reader0"), b"").unwrap();
+        fs::write(dir.0.join("reader1"), b"").unwrap();
+        assert!(fd_readable(&monitor));
+
+        // Both arrivals are drained from inotify by the first call.
+        assert!(matches!(
+            monitor.next_event(&registry, &context, 1_000).unwrap(),
+            Some(DeviceEvent::Added(_))
+        ));
+        assert!(fd_readable(&monitor));
+        assert!(matches!(
+            monitor.next_event(&registry, &context, 0).unwrap(),
+            Some(DeviceEvent::Added(_))
+        ));
+        assert!(!fd_readable(&monitor));
+        assert_eq!(monitor.next_event(&registry, &context, 0).unwrap(), None);
+    }
+
+    #[test]
+    fn monitor_reports_nodes_in_usb_bus_directories() {
+        let dir = TempDeviceDir::new("usb");
+        let usb_root = dir.0.join(USB_DEVICE_SUBDIR);
+        fs::create_dir_all(usb_root.join("001")).unwrap();
+        let registry = node_registry();
+        let context = Context::new();
+        let mut monitor = DeviceMonitor::watch_dir(&dir.0).unwrap();
+
+        fs::write(usb_root.join("001/reader2"), b"").unwrap();
+        let Some(DeviceEvent::Added(device)) =
+            monitor.next_event(&registry, &context, 1_000).unwrap()
+        else {
+            panic!("expected an added device");
+        };
+        assert_eq!(device.connstring.as_str(), "node:reader2");
+
+        // A bus that shows up later is watched too, including a node that
+        // was created before its watch was in place.
+        fs::create_dir(usb_root.join("002")).unwrap();
+        fs::write(usb_root.join("002/reader3"), b"").unwrap();
+        let Some(DeviceEvent::Added(device)) =
+            monitor.next_event(&registry, &context, 1_000).unwrap()
+        else {
+            panic!("expected an added device");
+        };
+        assert_eq!(device.connstring.as_str(), "node:reader3");
+        assert_eq!(monitor.next_event(&registry, &context, 50).unwrap(), None);
+
+        fs::remove_dir_all(usb_root.join("002")).unwrap();
+        assert_eq!(
+            monitor.next_event(&registry, &context, 1_000).unwrap(),
+            Some(DeviceEvent::Removed(
+                ConnectionString::new("node:reader3").unwrap()
+            ))
+        );
+    }
+}
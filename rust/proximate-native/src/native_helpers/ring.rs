@@ -0,0 +1,136 @@
+//! Fixed-capacity byte FIFO for data a transport received ahead of the
+//! caller, such as the rest of a USB transfer longer than the read that
+//! asked for it. Storage is allocated once; reads and writes copy at most
+//! two slices and never shift the bytes already queued.
+
+/// The bytes did not fit in what is left of the ring.
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub struct RingFull;
+
+pub struct ByteRing {
+    storage: Box<[u8]>,
+    head: usize,
+    len: usize,
+}
+
+impl ByteRing {
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self {
+            storage: vec![0u8; capacity].into_boxed_slice(),
+            head: 0,
+            len: 0,
+        }
+    }
+
+    pub fn capacity(&self) -> usize {
+        self.storage.len()
+    }
+
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    pub fn clear(&mut self) {
+        self.head = 0;
+        self.len = 0;
+    }
+
+    /// Moves up to `out.len()` of the oldest bytes into `out` and returns
+    /// how many were moved.
+    pub fn read(&mut self, out: &mut [u8]) -> usize {
+        let count = self.len.min(out.len());
+        let first = count.min(self.capacity() - self.head);
+        out[..first].copy_from_slice(&self.storage[self.head..self.head + first]);
+        out[first..count].copy_from_slice(&self.storage[..count - first]);
+        self.len -= count;
+        // An empty ring starts over at the front, so the common case of one
+        // surplus at a time never wraps.
+        self.head = if self.len == 0 {
+            0
+        } else {
+            (self.head + count) % self.capacity()
+        };
+        count
+    }
+
+    /// Appends all of `data`, or nothing when it does not fit.
+    pub fn write(&mut self, data: &[u8]) -> Result<(), RingFull> {
+        if data.len() > self.capacity() - self.len {
+            return Err(RingFull);
+        }
+        let tail = (self.head + self.len) % self.capacity().max(1);
+        let first = data.len().min(self.capacity() - tail);
+        self.storage[tail..tail + first].copy_from_slice(&data[..first]);
+        self.storage[..data.len() - first].copy_from_slice(&data[first..]);
+        self.len += data.len();
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::VecDeque;
+
+    #[test]
+    fn reads_return_bytes_in_order_across_the_wrap() {
+        let mut ring = ByteRing::with_capacity(8);
+        ring.write(&[1, 2, 3, 4, 5, 6]).unwrap();
+        let mut out = [0u8; 4];
+        assert_eq!(ring.read(&mut out), 4);
+        assert_eq!(out, [1, 2, 3, 4]);
+
+        ring.write(&[7, 8, 9, 10, 11]).unwrap();
+        assert_eq!(ring.len(), 7);
+        let mut out = [0u8; 16];
+        assert_eq!(ring.read(&mut out), 7);
+        assert_eq!(out[..7], [5, 6, 7, 8, 9, 10, 11]);
+        assert!(ring.is_empty());
+    }
+
+    #[test]
+    fn a_write_that_does_not_fit_leaves_the_ring_unchanged() {
+        let mut ring = ByteRing::with_capacity(4);
+        ring.write(&[1, 2, 3]).unwrap();
+        assert_eq!(ring.write(&[4, 5]), Err(RingFull));
+        assert_eq!(ring.len(), 3);
+        ring.write(&[4]).unwrap();
+
+        let mut out = [0u8; 4];
+        assert_eq!(ring.read(&mut out), 4);
+        assert_eq!(out, [1, 2, 3, 4]);
+        assert_eq!(ByteRing::with_capacity(0).write(&[]), Ok(()));
+    }
+
+    #[test]
+    fn matches_a_deque_over_mixed_reads_and_writes() {
+        let mut ring = ByteRing::with_capacity(13);
+        let mut model = VecDeque::new();
+        let mut next = 0u8;
+        for step in 0..2000usize {
+            let len = (step * 7 + 3) % 11;
+            if step % 3 == 2 {
+                let mut out = vec![0u8; len];
+                let count = ring.read(&mut out);
+                let expected: Vec<u8> = model.drain(..len.min(model.len())).collect();
+                assert_eq!(out[..count], expected[..], "step {step}");
+            } else {
+                let data: Vec<u8> = (0..len)
+                    .map(|_| {
+                        next = next.wrapping_add(1);
+                        next
+                    })
+                    .collect();
+                match ring.write(&data) {
+                    Ok(()) => model.extend(&data),
+                    Err(RingFull) => assert!(model.len() + len > 13, "step {step}"),
+                }
+            }
+            assert_eq!(ring.len(), model.len());
+        }
+    }
+}
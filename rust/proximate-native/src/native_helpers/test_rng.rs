@@ -0,0 +1,16 @@
+//! Deterministic test data for the randomized tests of the native helpers
+//! and drivers.
+
+/// xorshift64*, enough to spread test data over all byte values.
+pub(crate) struct TestRng(pub(crate) u64);
+
+impl TestRng {
+    pub(crate) fn fill(&mut self, buffer: &mut [u8]) {
+        for byte in buffer {
+            self.0 ^= self.0 >> 12;
+            self.0 ^= self.0 << 25;
+            self.0 ^= self.0 >> 27;
+            *byte = (self.0.wrapping_mul(0x2545_f491_4f6c_dd1d) >> 56) as u8;
+        }
+    }
+}
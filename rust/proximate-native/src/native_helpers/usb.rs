@@ -1,13 +1,28 @@
+use crate::cancel::CancelToken;
+use crate::ring::ByteRing;
 use nusb::descriptors::{ConfigurationDescriptor, TransferType, language_id};
-use nusb::transfer::{Buffer, Bulk, In, Out, TransferError};
+use nusb::transfer::{Buffer, Bulk, Completion, In, Out, TransferError};
 use nusb::{
-    Device, DeviceInfo as NusbDeviceInfo, Error as NusbError, ErrorKind as NusbErrorKind,
+    Device, DeviceInfo as NusbDeviceInfo, Endpoint, Error as NusbError, ErrorKind as NusbErrorKind,
     Interface, MaybeFuture,
 };
 use std::collections::HashMap;
 use std::num::NonZeroU8;
 use std::time::Duration;
 
+#[cfg(target_os = "linux")]
+use crate::cancel::Wake;
+#[cfg(target_os = "linux")]
+use rustix::event::PollFlags;
+#[cfg(target_os = "linux")]
+use rustix::fd::AsFd;
+#[cfg(target_os = "linux")]
+use std::sync::Arc;
+#[cfg(target_os = "linux")]
+use std::task::{Context, Poll, Waker};
+#[cfg(target_os = "linux")]
+use std::time::Instant;
+
 #[derive(Clone, Debug)]
 pub struct UsbEndpointInfo {
     pub address: u8,
@@ -87,8 +102,222 @@ pub struct UsbHandle {
     key: UsbDeviceKey,
     device: Device,
     claimed_interfaces: HashMap<u8, Interface>,
-    read_overflow: HashMap<u8, Vec<u8>>,
+    in_endpoints: Vec<InEndpoint>,
+    spare_write_buffer: Option<Buffer>,
     string_descriptors: HashMap<u8, String>,
+    cancel: Option<CancelWait>,
+}
+
+// Room for the surplus of a transfer longer than the read that asked for
+// it: a few packets, or the rest of a queued transfer.
+const READ_OVERFLOW_CAPACITY: usize = 4096;
+
+// State of one bulk IN endpoint: what the last transfer delivered beyond
+// the read, and the transfers kept posted once a read queue is set. Readers
+// use one or two IN endpoints, so a scan beats hashing.
+struct InEndpoint {
+    address: u8,
+    overflow: ReadOverflow,
+    queue: Option<ReadQueue>,
+}
+
+fn in_endpoint(in_endpoints: &mut Vec<InEndpoint>, address: u8) -> &mut InEndpoint {
+    match in_endpoints
+        .iter()
+        .position(|state| state.address == address)
+    {
+        Some(index) => &mut in_endpoints[index],
+        None => {
+            in_endpoints.push(InEndpoint {
+                address,
+                overflow: ReadOverflow::with_capacity(READ_OVERFLOW_CAPACITY),
+                queue: None,
+            });
+            in_endpoints.last_mut().expect("just pushed")
+        }
+    }
+}
+
+// IN transfers kept posted on one endpoint, so a reply the device sends
+// before the host asks for it is already on its way. Completed buffers are
+// submitted again instead of being reallocated.
+struct ReadQueue {
+    endpoint: Endpoint<Bulk, In>,
+    depth: usize,
+    transfer_len: usize,
+    spare: Vec<Buffer>,
+}
+
+impl ReadQueue {
+    fn top_up(&mut self) {
+        while self.endpoint.pending() < self.depth {
+            let mut buffer = self
+                .spare
+                .pop()
+                .unwrap_or_else(|| Buffer::new(self.transfer_len));
+            buffer.clear();
+            buffer.set_requested_len(self.transfer_len);
+            self.endpoint.submit(buffer);
+        }
+    }
+}
+
+/// A bulk IN endpoint as the read path sees it: each call completes one
+/// transfer. `UsbHandle` reads its nusb endpoints through this; tests and
+/// benches plug in fakes.
+pub trait BulkInSource {
+    type Transfer: AsRef<[u8]>;
+
+    /// Waits for the next transfer. `request_len` is what the read still
+    /// needs, for sources that submit a transfer per read.
+    fn next_transfer(&mut self, request_len: usize) -> Result<Self::Transfer, UsbError>;
+
+    /// Takes back a transfer once its bytes have been copied out.
+    fn recycle(&mut self, _transfer: Self::Transfer) {}
+}
+
+/// What a bulk IN endpoint delivered beyond the reads that asked for it,
+/// served to the reads that follow.
+pub struct ReadOverflow {
+    ring: ByteRing,
+    // Surplus was dropped because it did not fit. The read that reaches
+    // the gap reports it instead of splicing the stream.
+    lost: bool,
+}
+
+impl ReadOverflow {
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self {
+            ring: ByteRing::with_capacity(capacity),
+            lost: false,
+        }
+    }
+
+    /// Fills `out` from the surplus and, when that is not enough, from one
+    /// transfer of `source`, keeping what the transfer had left over. Bytes
+    /// copied into `out` are always returned, short if the transfer fails;
+    /// a surplus too large to keep fails the read that would have started
+    /// with it, with `UsbError::Overflow`.
+    pub fn read<S: BulkInSource + ?Sized>(
+        &mut self,
+        source: &mut S,
+        out: &mut [u8],
+    ) -> Result<usize, UsbError> {
+        let copied = self.ring.read(out);
+        if copied == out.len() {
+            return Ok(copied);
+        }
+        if self.lost {
+            if copied > 0 {
+                return Ok(copied);
+            }
+            self.lost = false;
+            return Err(UsbError::Overflow);
+        }
+
+        let transfer = match source.next_transfer(out.len() - copied) {
+            Ok(transfer) => transfer,
+            // The caller still gets the bytes; the next read sees the error.
+            Err(_) if copied > 0 => return Ok(copied),
+            Err(error) => return Err(error),
+        };
+        let data = transfer.as_ref();
+        let copy_len = data.len().min(out.len() - copied);
+        out[copied..copied + copy_len].copy_from_slice(&data[..copy_len]);
+        self.lost = self.ring.write(&data[copy_len..]).is_err();
+        source.recycle(transfer);
+        Ok(copied + copy_len)
+    }
+}
+
+// The nusb side of one bulk read: the endpoint's posted transfers if it
+// has a read queue, a transfer submitted for the read otherwise.
+struct NusbBulkIn<'a> {
+    address: u8,
+    queue: &'a mut Option<ReadQueue>,
+    interfaces: &'a HashMap<u8, Interface>,
+    cancel: Option<&'a CancelWait>,
+    timeout: Duration,
+}
+
+struct InTransfer {
+    buffer: Buffer,
+    len: usize,
+}
+
+impl AsRef<[u8]> for InTransfer {
+    fn as_ref(&self) -> &[u8] {
+        &self.buffer[..self.len]
+    }
+}
+
+impl NusbBulkIn<'_> {
+    fn recycle_buffer(&mut self, buffer: Buffer) {
+        if let Some(queue) = self.queue.as_mut()
+            && queue.spare.len() < queue.depth
+        {
+            queue.spare.push(buffer);
+        }
+    }
+}
+
+impl BulkInSource for NusbBulkIn<'_> {
+    type Transfer = InTransfer;
+
+    fn next_transfer(&mut self, request_len: usize) -> Result<InTransfer, UsbError> {
+        let completion = if let Some(queue) = self.queue.as_mut() {
+            queue.top_up();
+            // A transfer that is still pending stays posted for the next read.
+            let completion = next_completion(&mut queue.endpoint, self.timeout, self.cancel)?
+                .ok_or(UsbError::Timeout)?;
+            queue.top_up();
+            completion
+        } else {
+            let interface = find_bulk_interface(self.interfaces, self.address)?;
+            let mut bulk_in = interface
+                .endpoint::<Bulk, In>(self.address)
+                .map_err(|error| map_nusb_error(&error))?;
+            let request_len = round_up_transfer_len(request_len, bulk_in.max_packet_size());
+            bulk_in.submit(Buffer::new(request_len));
+            match next_completion(&mut bulk_in, self.timeout, self.cancel) {
+                Ok(Some(completion)) => completion,
+                result => {
+                    // The transfer completes with TransferError::Cancelled,
+                    // reported as a timeout, unless it finished meanwhile.
+                    bulk_in.cancel_all();
+                    let completion = bulk_in.wait_next_complete(Duration::MAX);
+                    result?;
+                    completion.ok_or(UsbError::Timeout)?
+                }
+            }
+        };
+        let actual_len = completion.actual_len;
+        let status = completion.status;
+        let buffer = completion.buffer;
+        if let Err(error) = status {
+            self.recycle_buffer(buffer);
+            return Err(map_transfer_error(error));
+        }
+        Ok(InTransfer {
+            len: actual_len.min(buffer.len()),
+            buffer,
+        })
+    }
+
+    fn recycle(&mut self, transfer: InTransfer) {
+        self.recycle_buffer(transfer.buffer);
+    }
+}
+
+// A bulk read with a cancel token waits on the token and on `completed`,
+// which the endpoint's waker raises when the transfer finishes, in one poll.
+struct CancelWait {
+    #[cfg_attr(not(target_os = "linux"), allow(dead_code))]
+    cancel: CancelToken,
+    #[cfg(target_os = "linux")]
+    completed: CancelToken,
+    #[cfg(target_os = "linux")]
+    waker: Waker,
 }
 
 impl UsbDeviceKey {
@@ -250,9 +479,11 @@ fn build_device_info(info: &NusbDeviceInfo) -> UsbDeviceInfo {
     device
 }
 
-fn find_bulk_interface(handle: &UsbHandle, endpoint: u8) -> Result<&Interface, UsbError> {
-    handle
-        .claimed_interfaces
+fn find_bulk_interface(
+    claimed_interfaces: &HashMap<u8, Interface>,
+    endpoint: u8,
+) -> Result<&Interface, UsbError> {
+    claimed_interfaces
         .values()
         .find(|interface| {
             interface
@@ -268,27 +499,6 @@ fn find_bulk_interface(handle: &UsbHandle, endpoint: u8) -> Result<&Interface, U
         .ok_or(UsbError::NotFound)
 }
 
-fn copy_from_overflow(handle: &mut UsbHandle, endpoint: u8, out: &mut [u8]) -> usize {
-    if out.is_empty() {
-        return 0;
-    }
-
-    let mut copied = 0usize;
-    let mut remove_entry = false;
-    if let Some(overflow) = handle.read_overflow.get_mut(&endpoint) {
-        copied = overflow.len().min(out.len());
-        out[..copied].copy_from_slice(&overflow[..copied]);
-        overflow.drain(..copied);
-        remove_entry = overflow.is_empty();
-    }
-
-    if remove_entry {
-        handle.read_overflow.remove(&endpoint);
-    }
-
-    copied
-}
-
 pub fn prepare() -> Result<(), UsbError> {
     Ok(())
 }
@@ -301,6 +511,42 @@ pub fn list_devices() -> Result<Vec<UsbDeviceInfo>, UsbError> {
     Ok(devices.iter().map(build_device_info).collect())
 }
 
+/// Bus, address and IDs of a usbfs node such as `/dev/bus/usb/001/004`.
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub struct UsbNodeIds {
+    pub bus_number: u8,
+    pub device_address: u8,
+    pub vendor_id: u16,
+    pub product_id: u16,
+}
+
+/// Identifies the device behind one usbfs node without enumerating the
+/// bus: the node is named after its bus and address, and reading it yields
+/// the cached device descriptor, which carries the IDs.
+pub fn read_node_ids(path: &str) -> Option<UsbNodeIds> {
+    use std::io::Read;
+
+    let path = std::path::Path::new(path);
+    let device_address = path.file_name()?.to_str()?.parse().ok()?;
+    let bus_number = path.parent()?.file_name()?.to_str()?.parse().ok()?;
+
+    let mut descriptor = [0u8; 18];
+    std::fs::File::open(path)
+        .ok()?
+        .read_exact(&mut descriptor)
+        .ok()?;
+    // bLength and bDescriptorType of a device descriptor.
+    if descriptor[0] != 18 || descriptor[1] != 0x01 {
+        return None;
+    }
+    Some(UsbNodeIds {
+        bus_number,
+        device_address,
+        vendor_id: u16::from_le_bytes([descriptor[8], descriptor[9]]),
+        product_id: u16::from_le_bytes([descriptor[10], descriptor[11]]),
+    })
+}
+
 pub fn bus_device_strings(device: &UsbDeviceInfo) -> (String, String) {
     (
         format!("{:03}", device.bus_number),
@@ -360,8 +606,10 @@ impl UsbHandle {
             key: UsbDeviceKey::from_device_info(&info),
             device: opened,
             claimed_interfaces: HashMap::new(),
-            read_overflow: HashMap::new(),
+            in_endpoints: Vec::new(),
+            spare_write_buffer: None,
             string_descriptors,
+            cancel: None,
         })
     }
 
@@ -398,9 +646,64 @@ impl UsbHandle {
         Ok(())
     }
 
+    /// Lets `cancel` end a bulk read early with `UsbError::Interrupted`.
+    /// Only Linux waits on the token; elsewhere reads run to their timeout.
+    pub fn set_cancel_token(&mut self, cancel: CancelToken) -> Result<(), UsbError> {
+        #[cfg(target_os = "linux")]
+        {
+            let completed = CancelToken::new().map_err(|_| UsbError::NoMem)?;
+            let waker = Waker::from(Arc::new(CompletionWaker(completed.clone())));
+            self.cancel = Some(CancelWait {
+                cancel,
+                completed,
+                waker,
+            });
+        }
+        #[cfg(not(target_os = "linux"))]
+        {
+            self.cancel = Some(CancelWait { cancel });
+        }
+        Ok(())
+    }
+
+    /// Keeps `depth` IN transfers of `transfer_len` bytes, rounded up to
+    /// whole packets, posted on `endpoint` from now on. A read then takes
+    /// the oldest completed transfer; a read larger than one transfer returns
+    /// short. Depth 0 goes back to one transfer per read.
+    pub fn set_read_queue(
+        &mut self,
+        endpoint: u8,
+        depth: usize,
+        transfer_len: usize,
+    ) -> Result<(), UsbError> {
+        if endpoint & 0x80 != 0x80 || transfer_len == 0 {
+            return Err(UsbError::InvalidParam);
+        }
+        let state = in_endpoint(&mut self.in_endpoints, endpoint);
+        state.queue = None;
+        if depth == 0 {
+            return Ok(());
+        }
+
+        let interface = find_bulk_interface(&self.claimed_interfaces, endpoint)?;
+        let bulk_in = interface
+            .endpoint::<Bulk, In>(endpoint)
+            .map_err(|error| map_nusb_error(&error))?;
+        let transfer_len = round_up_transfer_len(transfer_len, bulk_in.max_packet_size());
+        let mut queue = ReadQueue {
+            endpoint: bulk_in,
+            depth,
+            transfer_len,
+            spare: Vec::with_capacity(depth),
+        };
+        queue.top_up();
+        state.queue = Some(queue);
+        Ok(())
+    }
+
     pub fn release_interface(&mut self, interface_number: u8) -> Result<(), UsbError> {
         if self.claimed_interfaces.remove(&interface_number).is_some() {
-            self.read_overflow.clear();
+            self.in_endpoints.clear();
             Ok(())
         } else {
             Err(UsbError::NotFound)
@@ -415,11 +718,11 @@ impl UsbHandle {
         let Some(interface) = self.claimed_interfaces.get(&interface_number) else {
             return Err(UsbError::NotFound);
         };
+        self.in_endpoints.clear();
         interface
             .set_alt_setting(alternate_setting)
             .wait()
             .map_err(|error| map_nusb_error(&error))?;
-        self.read_overflow.clear();
         Ok(())
     }
 
@@ -428,10 +731,10 @@ impl UsbHandle {
             .reset()
             .wait()
             .map_err(|error| map_nusb_error(&error))?;
+        self.in_endpoints.clear();
         let (_, reopened) = open_matching_device(&self.key)?;
         self.device = reopened;
         self.claimed_interfaces.clear();
-        self.read_overflow.clear();
         Ok(())
     }
 
@@ -448,37 +751,15 @@ impl UsbHandle {
             return Ok(0);
         }
 
-        let mut copied = copy_from_overflow(self, endpoint, out);
-        if copied == out.len() {
-            return Ok(copied);
-        }
-
-        let interface = find_bulk_interface(self, endpoint)?;
-        let mut bulk_in = interface
-            .endpoint::<Bulk, In>(endpoint)
-            .map_err(|error| map_nusb_error(&error))?;
-        let request_len = round_up_transfer_len(out.len() - copied, bulk_in.max_packet_size());
-        let completion =
-            bulk_in.transfer_blocking(Buffer::new(request_len), duration_from_timeout(timeout));
-        let actual_len = completion.actual_len;
-        let buffer = completion
-            .into_result()
-            .map(|buffer| buffer.into_vec())
-            .map_err(map_transfer_error)?;
-
-        let transfer_len = actual_len.min(buffer.len());
-        let copy_len = transfer_len.min(out.len() - copied);
-        out[copied..copied + copy_len].copy_from_slice(&buffer[..copy_len]);
-        copied += copy_len;
-
-        if transfer_len > copy_len {
-            self.read_overflow
-                .entry(endpoint)
-                .or_default()
-                .extend_from_slice(&buffer[copy_len..transfer_len]);
-        }
-
-        Ok(copied)
+        let state = in_endpoint(&mut self.in_endpoints, endpoint);
+        let mut source = NusbBulkIn {
+            address: endpoint,
+            queue: &mut state.queue,
+            interfaces: &self.claimed_interfaces,
+            cancel: self.cancel.as_ref(),
+            timeout: duration_from_timeout(timeout),
+        };
+        state.overflow.read(&mut source, out)
     }
 
     pub fn bulk_write(
@@ -491,18 +772,22 @@ impl UsbHandle {
             return Err(UsbError::InvalidParam);
         }
 
-        let interface = find_bulk_interface(self, endpoint)?;
+        let interface = find_bulk_interface(&self.claimed_interfaces, endpoint)?;
         let mut bulk_out = interface
             .endpoint::<Bulk, Out>(endpoint)
             .map_err(|error| map_nusb_error(&error))?;
-        let buffer = if data.is_empty() {
-            Buffer::new(0)
-        } else {
-            data.to_vec().into()
-        };
+        let mut buffer = self
+            .spare_write_buffer
+            .take()
+            .filter(|buffer| buffer.capacity() >= data.len())
+            .unwrap_or_else(|| Buffer::new(data.len()));
+        buffer.clear();
+        buffer.extend_from_slice(data);
         let completion = bulk_out.transfer_blocking(buffer, duration_from_timeout(timeout));
         let actual_len = completion.actual_len;
-        completion.into_result().map_err(map_transfer_error)?;
+        let status = completion.status;
+        self.spare_write_buffer = Some(completion.buffer);
+        status.map_err(map_transfer_error)?;
         Ok(actual_len)
     }
 
@@ -536,6 +821,52 @@ impl UsbHandle {
     }
 }
 
+// Waits for the oldest transfer on `endpoint`, which stays posted when
+// `timeout` passes first (None) or the cancel token fires.
+fn next_completion(
+    endpoint: &mut Endpoint<Bulk, In>,
+    timeout: Duration,
+    cancel: Option<&CancelWait>,
+) -> Result<Option<Completion>, UsbError> {
+    #[cfg(target_os = "linux")]
+    if let Some(CancelWait {
+        cancel,
+        completed,
+        waker,
+    }) = cancel
+    {
+        completed.reset();
+        let mut context = Context::from_waker(waker);
+        let deadline = Instant::now().checked_add(timeout);
+        loop {
+            if let Poll::Ready(completion) = endpoint.poll_next_complete(&mut context) {
+                return Ok(Some(completion));
+            }
+            let remaining =
+                deadline.map(|deadline| deadline.saturating_duration_since(Instant::now()));
+            match cancel.wait_fd(completed.as_fd(), PollFlags::IN, remaining) {
+                Ok(Wake::Ready(_)) => completed.reset(),
+                Ok(Wake::TimedOut) => return Ok(None),
+                Ok(Wake::Cancelled) => return Err(UsbError::Interrupted),
+                Err(_) => return Err(UsbError::Io),
+            }
+        }
+    }
+    #[cfg(not(target_os = "linux"))]
+    let _ = cancel;
+    Ok(endpoint.wait_next_complete(timeout))
+}
+
+#[cfg(target_os = "linux")]
+struct CompletionWaker(CancelToken);
+
+#[cfg(target_os = "linux")]
+impl std::task::Wake for CompletionWaker {
+    fn wake(self: Arc<Self>) {
+        self.0.cancel();
+    }
+}
+
 pub fn strerror(error: UsbError) -> &'static str {
     match error {
         UsbError::Io => "input/output error",
@@ -561,3 +892,52 @@ pub fn error_is_timeout(error: UsbError) -> bool {
 pub fn error_is_access(error: UsbError) -> bool {
     error == UsbError::Access
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::VecDeque;
+
+    struct FakeBulkIn(VecDeque<Vec<u8>>);
+
+    impl BulkInSource for FakeBulkIn {
+        type Transfer = Vec<u8>;
+
+        fn next_transfer(&mut self, _request_len: usize) -> Result<Vec<u8>, UsbError> {
+            self.0.pop_front().ok_or(UsbError::Timeout)
+        }
+    }
+
+    #[test]
+    fn surplus_of_a_transfer_serves_the_next_read() {
+        let mut source = FakeBulkIn(VecDeque::from([vec![1, 2, 3, 4, 5]]));
+        let mut overflow = ReadOverflow::with_capacity(8);
+        let mut out = [0u8; 2];
+
+        assert_eq!(overflow.read(&mut source, &mut out), Ok(2));
+        assert_eq!(out, [1, 2]);
+        assert_eq!(overflow.read(&mut source, &mut out), Ok(2));
+        assert_eq!(out, [3, 4]);
+        // The last byte comes back short when no transfer follows it.
+        assert_eq!(overflow.read(&mut source, &mut out), Ok(1));
+        assert_eq!(out[0], 5);
+        assert_eq!(overflow.read(&mut source, &mut out), Err(UsbError::Timeout));
+    }
+
+    #[test]
+    fn dropped_surplus_fails_the_read_that_reaches_it() {
+        let mut source = FakeBulkIn(VecDeque::from([vec![1, 2, 3, 4, 5, 6], vec![7]]));
+        let mut overflow = ReadOverflow::with_capacity(2);
+        let mut out = [0u8; 2];
+
+        // The copied bytes are returned although the surplus did not fit.
+        assert_eq!(overflow.read(&mut source, &mut out), Ok(2));
+        assert_eq!(out, [1, 2]);
+        assert_eq!(
+            overflow.read(&mut source, &mut out),
+            Err(UsbError::Overflow)
+        );
+        assert_eq!(overflow.read(&mut source, &mut out), Ok(1));
+        assert_eq!(out[0], 7);
+    }
+}
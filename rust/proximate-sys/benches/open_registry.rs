@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+//
+// Measures the fixed per-call cost of `nfc_open` on a context whose driver
+// registry is cached, against rebuilding the builtin registry on every call.
+//
+//     cargo bench --manifest-path rust/Cargo.toml -p proximate-sys \
+//         --no-default-features --features c_ffi --bench open_registry
+
+use proximate_driver::DriverRegistry;
+use std::hint::black_box;
+use std::ptr;
+use std::time::Instant;
+
+const ITERATIONS: u32 = 20_000;
+
+fn nanos_per_iteration(mut operation: impl FnMut()) -> f64 {
+    for _ in 0..ITERATIONS / 10 {
+        operation();
+    }
+
+    let started = Instant::now();
+    for _ in 0..ITERATIONS {
+        operation();
+    }
+    started.elapsed().as_nanos() as f64 / f64::from(ITERATIONS)
+}
+
+fn main() {
+    let mut context = ptr::null_mut();
+    unsafe { proximate_sys::nfc_init(&mut context) };
+    assert!(!context.is_null(), "nfc_init failed");
+
+    // No driver accepts this family, so each open stops right after the
+    // registry lookup and never touches a bus.
+    let connstring = c"bench_missing:registry";
+
+    let open = nanos_per_iteration(|| {
+        let device = unsafe { proximate_sys::nfc_open(context, connstring.as_ptr()) };
+        assert!(device.is_null());
+    });
+    let rebuild = nanos_per_iteration(|| {
+        let mut registry = DriverRegistry::new();
+        proximate_native::register_builtin_drivers(&mut registry);
+        black_box(registry);
+    });
+
+    unsafe { proximate_sys::nfc_exit(context) };
+
+    println!("nfc_open (cached registry):  {open:>10.1} ns/op");
+    println!("registry rebuild (avoided):  {rebuild:>10.1} ns/op");
+    println!(
+        "saved per open:              {:>10.1} ns ({:.1}%)",
+        rebuild,
+        rebuild * 100.0 / (open + rebuild)
+    );
+}
@@ -2,6 +2,7 @@ use crate::c_abi::types::{
     nfc_baud_rate, nfc_dep_info, nfc_dep_mode, nfc_mode, nfc_modulation, nfc_modulation_type,
     nfc_property, nfc_target,
 };
+use crate::core::monitor::nfc_device_monitor;
 use crate::lifecycle::{nfc_connstring, nfc_context, nfc_device, nfc_driver};
 
 #[cfg(any(feature = "c_ffi", cbindgen))]
@@ -35,6 +36,46 @@ pub unsafe extern "C" fn nfc_list_devices(
     unsafe { crate::core::runtime::nfc_list_devices(context, connstrings, connstrings_len) }
 }
 
+#[cfg(any(feature = "c_ffi", cbindgen))]
+/// # Safety
+/// The caller must uphold the libnfc C ABI requirements for all pointers, lengths, and output buffers passed to this function.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn nfc_device_monitor_new(
+    context: *mut nfc_context,
+) -> *mut nfc_device_monitor {
+    unsafe { crate::core::monitor::nfc_device_monitor_new(context) }
+}
+
+#[cfg(any(feature = "c_ffi", cbindgen))]
+/// # Safety
+/// The caller must uphold the libnfc C ABI requirements for all pointers, lengths, and output buffers passed to this function.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn nfc_device_monitor_get_fd(
+    monitor: *const nfc_device_monitor,
+) -> libc::c_int {
+    unsafe { crate::core::monitor::nfc_device_monitor_get_fd(monitor) }
+}
+
+#[cfg(any(feature = "c_ffi", cbindgen))]
+/// # Safety
+/// The caller must uphold the libnfc C ABI requirements for all pointers, lengths, and output buffers passed to this function.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn nfc_device_monitor_next_event(
+    monitor: *mut nfc_device_monitor,
+    connstring: *mut libc::c_char,
+    timeout: libc::c_int,
+) -> libc::c_int {
+    unsafe { crate::core::monitor::nfc_device_monitor_next_event(monitor, connstring, timeout) }
+}
+
+#[cfg(any(feature = "c_ffi", cbindgen))]
+/// # Safety
+/// The caller must uphold the libnfc C ABI requirements for all pointers, lengths, and output buffers passed to this function.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn nfc_device_monitor_free(monitor: *mut nfc_device_monitor) {
+    unsafe { crate::core::monitor::nfc_device_monitor_free(monitor) }
+}
+
 #[cfg(any(feature = "c_ffi", cbindgen))]
 /// # Safety
 /// The caller must uphold the libnfc C ABI requirements for all pointers, lengths, and output buffers passed to this function.
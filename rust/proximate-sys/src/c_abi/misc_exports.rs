@@ -11,7 +11,8 @@ use crate::c_abi::types::{
     nfc_iso14443biclass_info, nfc_jewel_info, nfc_modulation_type, nfc_target,
 };
 use crate::c_boundary::raw::optional_ref;
-use crate::domain_bridge::c_driver::{free_rust_device, is_rust_shim_device};
+use crate::core::runtime::close_rust_device;
+use crate::domain_bridge::c_driver::is_rust_shim_device;
 use crate::domain_bridge::decode::{
     InputBytes, OutputBytes, baud_rate_from_c, modulation_type_from_c,
 };
@@ -22,6 +23,7 @@ use crate::{
     ffi_catch_unwind_int, ffi_catch_unwind_ptr, ffi_catch_unwind_void, release_allocated_ptr,
 };
 use libc::{c_char, c_int, c_void, size_t};
+use proximate_native::crc as iso14443_crc;
 
 #[cfg(test)]
 use crate::c_boundary::NFC_BUFSIZE_CONNSTRING;
@@ -221,27 +223,6 @@ fn baud_rate_label(value: nfc_baud_rate) -> *const c_char {
     baud_rate_label_cstr(baud_rate_from_c(value)).as_ptr()
 }
 
-fn iso14443a_crc_bytes(data: &[u8]) -> [u8; 2] {
-    let mut crc = 0x6363u16;
-    for byte in data {
-        let mut bt = *byte ^ (crc as u8);
-        bt ^= bt << 4;
-        crc = (crc >> 8) ^ (u16::from(bt) << 8) ^ (u16::from(bt) << 3) ^ (u16::from(bt) >> 4);
-    }
-    [(crc & 0xff) as u8, (crc >> 8) as u8]
-}
-
-fn iso14443b_crc_bytes(data: &[u8]) -> [u8; 2] {
-    let mut crc = 0xffffu16;
-    for byte in data {
-        let mut bt = *byte ^ (crc as u8);
-        bt ^= bt << 4;
-        crc = (crc >> 8) ^ (u16::from(bt) << 8) ^ (u16::from(bt) << 3) ^ (u16::from(bt) >> 4);
-    }
-    crc = !crc;
-    [(crc & 0xff) as u8, (crc >> 8) as u8]
-}
-
 fn locate_historical_bytes_offset(ats: &[u8]) -> Option<usize> {
     let t0 = *ats.first()?;
     let mut offset = 1usize;
@@ -896,7 +877,7 @@ fn render_nfc_target(target: *const nfc_target, verbose: bool) -> String {
 pub unsafe fn nfc_close(device: *mut nfc_device) {
     ffi_catch_unwind_void("nfc_close", || unsafe {
         if is_rust_shim_device(device) {
-            free_rust_device(device);
+            close_rust_device(device);
             return;
         }
 
@@ -963,7 +944,7 @@ pub unsafe fn iso14443a_crc(data: *mut u8, len: size_t, crc: *mut u8) {
             Ok(bytes) => bytes,
             Err(_) => return,
         };
-        let out = iso14443a_crc_bytes(bytes.as_slice());
+        let out = iso14443_crc::iso14443a_crc(bytes.as_slice());
         let buffer = crc_out.as_mut_slice();
         if buffer.len() < out.len() {
             return;
@@ -981,7 +962,7 @@ pub unsafe fn iso14443a_crc_append(data: *mut u8, len: size_t) {
             Ok(bytes) => bytes,
             Err(_) => return,
         };
-        let out = iso14443a_crc_bytes(bytes.as_slice());
+        let out = iso14443_crc::iso14443a_crc(bytes.as_slice());
         *data.add(len) = out[0];
         *data.add(len + 1) = out[1];
     });
@@ -1000,7 +981,7 @@ pub unsafe fn iso14443b_crc(data: *mut u8, len: size_t, crc: *mut u8) {
             Ok(bytes) => bytes,
             Err(_) => return,
         };
-        let out = iso14443b_crc_bytes(bytes.as_slice());
+        let out = iso14443_crc::iso14443b_crc(bytes.as_slice());
         let buffer = crc_out.as_mut_slice();
         if buffer.len() < out.len() {
             return;
@@ -1018,7 +999,7 @@ pub unsafe fn iso14443b_crc_append(data: *mut u8, len: size_t) {
             Ok(bytes) => bytes,
             Err(_) => return,
         };
-        let out = iso14443b_crc_bytes(bytes.as_slice());
+        let out = iso14443_crc::iso14443b_crc(bytes.as_slice());
         *data.add(len) = out[0];
         *data.add(len + 1) = out[1];
     });
@@ -1249,7 +1230,7 @@ mod tests {
         let mut atqb = [0x05u8, 0x00, 0x08];
         let mut b_crc = [0u8; 2];
         unsafe { iso14443b_crc(atqb.as_mut_ptr(), atqb.len(), b_crc.as_mut_ptr()) };
-        assert_eq!(b_crc, iso14443b_crc_bytes(&atqb));
+        assert_eq!(b_crc, iso14443_crc::iso14443b_crc(&atqb));
 
         let mut appended = [0x26u8, 0x00, 0x00];
         unsafe { iso14443a_crc_append(appended.as_mut_ptr(), 1) };
@@ -25,6 +25,8 @@ pub enum nfc_property {
     NP_FORCE_ISO14443_A = 12,
     NP_FORCE_ISO14443_B = 13,
     NP_FORCE_SPEED_106 = 14,
+    NP_AUTO_BIT_RATE = 15,
+    NP_PRESENCE_WINDOW = 16,
 }
 
 #[derive(Clone, Copy, Debug, Eq, PartialEq)]
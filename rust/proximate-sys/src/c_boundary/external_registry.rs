@@ -12,12 +12,14 @@ unsafe impl Send for DriverHandle {}
 
 pub(crate) struct RegisteredDriverSet<T> {
     drivers: Vec<T>,
+    generation: u64,
 }
 
 impl<T> Default for RegisteredDriverSet<T> {
     fn default() -> Self {
         Self {
             drivers: Vec::new(),
+            generation: 0,
         }
     }
 }
@@ -30,11 +32,19 @@ impl<T> RegisteredDriverSet<T> {
     pub(crate) fn register(&mut self, driver: T) -> Result<(), std::collections::TryReserveError> {
         self.drivers.try_reserve(1)?;
         self.drivers.push(driver);
+        self.generation = self.generation.wrapping_add(1);
         Ok(())
     }
 
     pub(crate) fn clear(&mut self) {
         self.drivers.clear();
+        self.generation = self.generation.wrapping_add(1);
+    }
+
+    /// Changes whenever the registered set changes, so callers holding a
+    /// runtime registry built from an earlier snapshot know to rebuild it.
+    pub(crate) fn generation(&self) -> u64 {
+        self.generation
     }
 }
 
@@ -80,6 +90,10 @@ pub(crate) fn registry_snapshot() -> Vec<DriverHandle> {
     with_registry(|registry| registry.snapshot())
 }
 
+pub(crate) fn registry_generation() -> u64 {
+    with_registry(|registry| registry.generation())
+}
+
 pub(crate) fn clear_registry() {
     with_registry(|registry| registry.clear());
 }
@@ -96,4 +110,18 @@ mod tests {
 
         assert_eq!(registry.snapshot(), vec!["alpha", "beta"]);
     }
+
+    #[test]
+    fn generation_changes_on_register_and_clear() {
+        let mut registry = RegisteredDriverSet::new();
+        let initial = registry.generation();
+
+        registry.register("alpha").unwrap();
+        let registered = registry.generation();
+        assert_ne!(registered, initial);
+
+        registry.clear();
+        assert_ne!(registry.generation(), registered);
+        assert!(registry.snapshot().is_empty());
+    }
 }
@@ -1,6 +1,8 @@
 use super::log_general_error;
+use super::runtime::runtime_registry;
 use crate::MALLOC_LABEL;
 use crate::c_boundary::external_registry::clear_registry;
+use crate::domain_bridge::decode::context_from_c;
 use crate::ffi_catch_unwind_void;
 use crate::lifecycle::{nfc_context, nfc_context_free, nfc_context_new};
 
@@ -14,7 +16,10 @@ pub(super) unsafe fn nfc_init_impl(context: *mut *mut nfc_context) {
         *context = nfc_context_new();
         if (*context).is_null() {
             libc::perror(MALLOC_LABEL);
+            return;
         }
+        context_from_c(*context);
+        runtime_registry(*context);
     }
 }
 
@@ -11,6 +11,7 @@ use std::ffi::CString;
 
 pub(crate) mod context;
 pub(crate) mod driver_registration;
+pub(crate) mod monitor;
 pub(crate) mod runtime;
 #[cfg(test)]
 mod tests;
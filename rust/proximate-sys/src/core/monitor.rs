@@ -0,0 +1,125 @@
+use super::log_general_debug;
+use super::runtime::runtime_registry;
+use crate::c_boundary::NFC_BUFSIZE_CONNSTRING;
+use crate::c_boundary::raw::{copy_bytes_to_c_buffer, optional_mut, optional_ref};
+use crate::c_boundary::status::{NFC_EINVARG, NFC_EOVFLOW, error_to_status};
+use crate::domain_bridge::decode::context_from_c;
+use crate::lifecycle::nfc_context;
+use crate::{ffi_catch_unwind_int, ffi_catch_unwind_ptr, ffi_catch_unwind_void};
+use libc::{c_char, c_int};
+use proximate_driver as rt;
+use proximate_native::hotplug::{DeviceEvent, DeviceMonitor};
+use std::panic::AssertUnwindSafe;
+use std::ptr;
+use std::sync::Arc;
+
+pub(crate) const NFC_DEVICE_ADDED: c_int = 1;
+pub(crate) const NFC_DEVICE_REMOVED: c_int = 2;
+
+/// Hotplug monitor handed to C callers. The driver registry and decoded
+/// context are captured when the monitor is created.
+#[allow(non_camel_case_types)]
+pub struct nfc_device_monitor {
+    monitor: DeviceMonitor,
+    registry: Arc<rt::DriverRegistry>,
+    context: Arc<rt::Context>,
+}
+
+pub(super) fn monitor_into_raw(
+    monitor: DeviceMonitor,
+    registry: Arc<rt::DriverRegistry>,
+    context: Arc<rt::Context>,
+) -> *mut nfc_device_monitor {
+    Box::into_raw(Box::new(nfc_device_monitor {
+        monitor,
+        registry,
+        context,
+    }))
+}
+
+unsafe fn nfc_device_monitor_new_impl(context: *mut nfc_context) -> *mut nfc_device_monitor {
+    if context.is_null() {
+        return ptr::null_mut();
+    }
+
+    match DeviceMonitor::new() {
+        Ok(monitor) => monitor_into_raw(
+            monitor,
+            runtime_registry(context.cast_const()),
+            context_from_c(context.cast_const()),
+        ),
+        Err(error) => {
+            log_general_debug(&format!("nfc_device_monitor_new failed: {:?}", error));
+            ptr::null_mut()
+        }
+    }
+}
+
+unsafe fn nfc_device_monitor_next_event_impl(
+    monitor: *mut nfc_device_monitor,
+    connstring: *mut c_char,
+    timeout: c_int,
+) -> c_int {
+    let Some(monitor) = (unsafe { optional_mut(monitor) }) else {
+        return NFC_EINVARG;
+    };
+    if connstring.is_null() {
+        return NFC_EINVARG;
+    }
+
+    let (code, reported) =
+        match monitor
+            .monitor
+            .next_event(&monitor.registry, &monitor.context, timeout)
+        {
+            Ok(None) => return 0,
+            Ok(Some(DeviceEvent::Added(device))) => (NFC_DEVICE_ADDED, device.connstring),
+            Ok(Some(DeviceEvent::Removed(connstring))) => (NFC_DEVICE_REMOVED, connstring),
+            Err(error) => return error_to_status(&error),
+        };
+
+    if !unsafe {
+        copy_bytes_to_c_buffer(
+            connstring,
+            NFC_BUFSIZE_CONNSTRING,
+            reported.as_str().as_bytes(),
+        )
+    } {
+        return NFC_EOVFLOW;
+    }
+    code
+}
+
+pub(crate) unsafe fn nfc_device_monitor_new(context: *mut nfc_context) -> *mut nfc_device_monitor {
+    ffi_catch_unwind_ptr("nfc_device_monitor_new", || unsafe {
+        nfc_device_monitor_new_impl(context)
+    })
+}
+
+pub(crate) unsafe fn nfc_device_monitor_get_fd(monitor: *const nfc_device_monitor) -> c_int {
+    unsafe { optional_ref(monitor) }
+        .map(|monitor| monitor.monitor.as_raw_fd())
+        .unwrap_or(NFC_EINVARG)
+}
+
+pub(crate) unsafe fn nfc_device_monitor_next_event(
+    monitor: *mut nfc_device_monitor,
+    connstring: *mut c_char,
+    timeout: c_int,
+) -> c_int {
+    // The monitor owns driver trait objects, which are not unwind-safe by
+    // type; a panic leaves it usable because events are only queued.
+    let operation = AssertUnwindSafe(|| unsafe {
+        nfc_device_monitor_next_event_impl(monitor, connstring, timeout)
+    });
+    ffi_catch_unwind_int("nfc_device_monitor_next_event", NFC_EINVARG, operation)
+}
+
+pub(crate) unsafe fn nfc_device_monitor_free(monitor: *mut nfc_device_monitor) {
+    let operation = AssertUnwindSafe(|| {
+        if !monitor.is_null() {
+            drop(unsafe { Box::from_raw(monitor) });
+        }
+    });
+    ffi_catch_unwind_void("nfc_device_monitor_free", operation);
+}
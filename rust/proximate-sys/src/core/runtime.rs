@@ -1,13 +1,15 @@
 use super::{log_general_debug, log_general_error, log_general_info};
-use crate::c_boundary::external_registry::register_external_drivers;
-use crate::domain_bridge::c_driver::attach_rust_device;
+use crate::c_boundary::external_registry::{register_external_drivers, registry_generation};
+use crate::c_boundary::raw::optional_ref;
+use crate::domain_bridge::c_driver::{attach_rust_device, detach_rust_device};
 use crate::domain_bridge::decode::{context_from_c, decode_connstring_ptr};
 use crate::domain_bridge::encode::ConnstringsOut;
 use crate::ffi_catch_unwind_ptr;
-use crate::lifecycle::{nfc_connstring, nfc_context, nfc_device};
+use crate::lifecycle::{nfc_connstring, nfc_context, nfc_device, runtime_registry_from_c};
 use libc::{c_char, size_t};
 use proximate_driver as rt;
 use std::ptr;
+use std::sync::Arc;
 
 fn register_compiled_bridge_drivers(_registry: &mut rt::DriverRegistry) {}
 
@@ -19,9 +21,15 @@ fn create_runtime_registry() -> rt::DriverRegistry {
     registry
 }
 
+pub(super) fn runtime_registry(context: *const nfc_context) -> Arc<rt::DriverRegistry> {
+    let generation = registry_generation();
+    unsafe { runtime_registry_from_c(context, generation, create_runtime_registry) }
+        .unwrap_or_else(|| Arc::new(create_runtime_registry()))
+}
+
 unsafe fn nfc_open_impl(context: *mut nfc_context, connstring: *const c_char) -> *mut nfc_device {
     let runtime_context = context_from_c(context.cast_const());
-    let registry = create_runtime_registry();
+    let registry = runtime_registry(context.cast_const());
     let requested: Option<rt::ConnectionString> = match decode_connstring_ptr(connstring) {
         Ok(connstring) => connstring,
         Err(_) => return ptr::null_mut(),
@@ -36,6 +44,26 @@ unsafe fn nfc_open_impl(context: *mut nfc_context, connstring: *const c_char) ->
     }
 }
 
+/// Releases a Rust-backed device. With a device pool configured on its
+/// context the driver handle is parked for the next `nfc_open` of the same
+/// connstring; otherwise it is closed here.
+pub(crate) unsafe fn close_rust_device(device: *mut nfc_device) {
+    let context = unsafe { optional_ref(device) }
+        .map(|device| device.context)
+        .unwrap_or(ptr::null());
+    let Some(handle) = (unsafe { detach_rust_device(device) }) else {
+        return;
+    };
+    if context.is_null() {
+        return;
+    }
+
+    let runtime_context = context_from_c(context);
+    if runtime_context.config.device_pool_size != 0 {
+        runtime_registry(context).park(&runtime_context, handle);
+    }
+}
+
 unsafe fn nfc_list_devices_impl(
     context: *mut nfc_context,
     connstrings: *mut nfc_connstring,
@@ -47,13 +75,18 @@ unsafe fn nfc_list_devices_impl(
         return 0;
     };
     let runtime_context = context_from_c(context.cast_const());
-    let registry = create_runtime_registry();
+    let registry = runtime_registry(context.cast_const());
     let Ok(outcome) = registry.list_devices_outcome(&runtime_context) else {
         return 0;
     };
     if outcome.warn_manual_selection {
         log_general_info("Warning: user must specify device(s) manually when autoscan is disabled");
     }
+    for driver in &outcome.timed_out_drivers {
+        log_general_info(&format!(
+            "Driver {driver} exceeded its scan budget; results may be incomplete"
+        ));
+    }
 
     output.write_back(outcome.devices.into_iter().map(|device| device.connstring))
 }
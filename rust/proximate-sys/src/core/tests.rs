@@ -1,10 +1,17 @@
 use super::context::nfc_exit;
 use super::driver_registration::{bridge_close_device, nfc_register_driver};
-use super::runtime::{nfc_list_devices, nfc_open};
+use super::monitor::{
+    NFC_DEVICE_ADDED, NFC_DEVICE_REMOVED, monitor_into_raw, nfc_device_monitor_free,
+    nfc_device_monitor_get_fd, nfc_device_monitor_new, nfc_device_monitor_next_event,
+};
+use super::runtime::{close_rust_device, nfc_list_devices, nfc_open, runtime_registry};
 use crate::c_boundary::NFC_BUFSIZE_CONNSTRING;
 use crate::c_boundary::external_registry::{clear_registry, registry_snapshot};
 use crate::c_boundary::raw::{c_string_ptr_to_string, fixed_c_buffer_to_string};
+use crate::c_boundary::status::NFC_EINVARG;
 use crate::core::LOG_PRIORITY_INFO;
+use crate::domain_bridge::c_driver::attach_rust_device;
+use crate::lifecycle::alloc::set_runtime_context;
 use crate::lifecycle::{
     DEVICE_NAME_LENGTH, NFC_DRIVER_NAME_MAX, nfc_connstring, nfc_context,
     nfc_context_alloc_defaults, nfc_context_new, nfc_device, nfc_device_free, nfc_driver,
@@ -12,9 +19,11 @@ use crate::lifecycle::{
 };
 use crate::{test_clear_last_log, test_get_last_log};
 use libc::c_char;
+use proximate_driver as rt;
+use proximate_native::hotplug::DeviceMonitor;
 use std::ffi::CString;
 use std::ptr;
-use std::sync::{Mutex, MutexGuard, OnceLock};
+use std::sync::{Arc, Mutex, MutexGuard, OnceLock};
 
 const NFC_SUCCESS: libc::c_int = 0;
 
@@ -486,6 +495,236 @@ fn exit_clears_registry_and_frees_context() {
     assert_eq!(snapshot_lifecycle_test_state().context_free_calls, 1);
 }
 
+#[test]
+fn context_registry_is_reused_until_external_drivers_change() {
+    let _guard = core_test_guard();
+    reset_core_test_world();
+
+    let mut context = ptr::null_mut();
+    unsafe { super::context::nfc_init_impl(&mut context) };
+    assert!(!context.is_null());
+
+    let first = runtime_registry(context);
+    let second = runtime_registry(context);
+    assert!(Arc::ptr_eq(&first, &second));
+    assert!(!first.registered_driver_names().contains(&"alpha"));
+
+    unsafe {
+        assert_eq!(
+            nfc_register_driver(ptr::addr_of!(TEST_DRIVER_ALPHA)),
+            NFC_SUCCESS
+        );
+    }
+
+    let rebuilt = runtime_registry(context);
+    assert!(!Arc::ptr_eq(&first, &rebuilt));
+    assert!(rebuilt.registered_driver_names().contains(&"alpha"));
+    assert!(Arc::ptr_eq(&rebuilt, &runtime_registry(context)));
+
+    unsafe { nfc_exit(context) };
+}
+
+struct NodeDriver;
+
+impl rt::Driver for NodeDriver {
+    fn name(&self) -> &str {
+        "node"
+    }
+
+    fn scan_type(&self) -> rt::ScanType {
+        rt::ScanType::NotIntrusive
+    }
+
+    fn scan(&self, _context: &rt::Context) -> Result<Vec<rt::DiscoveredDevice>, rt::Error> {
+        Ok(Vec::new())
+    }
+
+    fn probe_node(
+        &self,
+        _context: &rt::Context,
+        path: &str,
+    ) -> Result<Vec<rt::DiscoveredDevice>, rt::Error> {
+        let name = std::path::Path::new(path)
+            .file_name()
+            .unwrap()
+            .to_string_lossy();
+        Ok(vec![self.describe_discovered(
+            name.to_string(),
+            rt::ConnectionString::new(format!("node:{name}")).unwrap(),
+            None,
+        )])
+    }
+
+    fn open(
+        &self,
+        _context: &rt::Context,
+        connstring: &rt::ConnectionString,
+    ) -> Result<Box<dyn rt::DeviceHandle>, rt::Error> {
+        Err(rt::Error::DriverNotFound(connstring.as_str().to_string()))
+    }
+}
+
+#[test]
+fn device_monitor_rejects_null_arguments() {
+    let mut connstring: nfc_connstring = [0; NFC_BUFSIZE_CONNSTRING];
+    unsafe {
+        assert!(nfc_device_monitor_new(ptr::null_mut()).is_null());
+        assert_eq!(nfc_device_monitor_get_fd(ptr::null()), NFC_EINVARG);
+        assert_eq!(
+            nfc_device_monitor_next_event(ptr::null_mut(), connstring.as_mut_ptr(), 0),
+            NFC_EINVARG
+        );
+        nfc_device_monitor_free(ptr::null_mut());
+    }
+}
+
+#[test]
+#[cfg(target_os = "linux")]
+fn device_monitor_reports_node_events_as_connstrings() {
+    let dir = std::env::temp_dir().join(format!("proximate-sys-monitor-{}", std::process::id()));
+    let _ = std::fs::remove_dir_all(&dir);
+    std::fs::create_dir_all(&dir).unwrap();
+
+    let mut registry = rt::DriverRegistry::new();
+    registry.register_driver(Box::new(NodeDriver));
+    let monitor = monitor_into_raw(
+        DeviceMonitor::watch_dir(&dir).unwrap(),
+        Arc::new(registry),
+        Arc::new(rt::Context::new()),
+    );
+    let mut connstring: nfc_connstring = [0; NFC_BUFSIZE_CONNSTRING];
+
+    unsafe {
+        assert!(nfc_device_monitor_get_fd(monitor) >= 0);
+        assert_eq!(
+            nfc_device_monitor_next_event(monitor, connstring.as_mut_ptr(), 0),
+            0
+        );
+
+        std::fs::write(dir.join("reader0"), b"").unwrap();
+        assert_eq!(
+            nfc_device_monitor_next_event(monitor, connstring.as_mut_ptr(), 1_000),
+            NFC_DEVICE_ADDED
+        );
+        assert_eq!(fixed_c_buffer_to_string(&connstring), "node:reader0");
+
+        connstring = [0; NFC_BUFSIZE_CONNSTRING];
+        std::fs::remove_file(dir.join("reader0")).unwrap();
+        assert_eq!(
+            nfc_device_monitor_next_event(monitor, connstring.as_mut_ptr(), 1_000),
+            NFC_DEVICE_REMOVED
+        );
+        assert_eq!(fixed_c_buffer_to_string(&connstring), "node:reader0");
+
+        nfc_device_monitor_free(monitor);
+    }
+    std::fs::remove_dir_all(&dir).unwrap();
+}
+
+struct PooledHandle {
+    connstring: rt::ConnectionString,
+}
+
+impl rt::DeviceMeta for PooledHandle {
+    fn name(&self) -> &str {
+        "pooled"
+    }
+
+    fn connstring(&self) -> &rt::ConnectionString {
+        &self.connstring
+    }
+
+    fn caps(&self) -> rt::DeviceCaps {
+        rt::DeviceCaps::IDLE
+    }
+}
+
+impl rt::InfoBackend for PooledHandle {}
+
+impl rt::PropertyBackend for PooledHandle {
+    fn set_property_bool(
+        &mut self,
+        _property: rt::Property,
+        _enable: bool,
+    ) -> Result<(), rt::Error> {
+        Ok(())
+    }
+
+    fn set_property_int(&mut self, _property: rt::Property, _value: i32) -> Result<(), rt::Error> {
+        Ok(())
+    }
+
+    fn supported_modulations(
+        &mut self,
+        _mode: rt::Mode,
+    ) -> Result<Vec<rt::ModulationType>, rt::Error> {
+        Ok(Vec::new())
+    }
+
+    fn supported_baud_rates(
+        &mut self,
+        _mode: rt::Mode,
+        _modulation_type: rt::ModulationType,
+    ) -> Result<Vec<rt::BaudRate>, rt::Error> {
+        Ok(Vec::new())
+    }
+}
+
+impl rt::InitiatorBackend for PooledHandle {
+    fn idle_driver(&mut self) -> Result<(), rt::Error> {
+        Ok(())
+    }
+
+    fn reset_session_driver(&mut self) -> Result<(), rt::Error> {
+        Ok(())
+    }
+}
+
+impl rt::TargetBackend for PooledHandle {}
+
+impl rt::Pn53xBackend for PooledHandle {}
+
+#[test]
+fn close_parks_rust_devices_for_the_next_open_when_pooling() {
+    let _guard = core_test_guard();
+    reset_core_test_world();
+
+    let mut context = ptr::null_mut();
+    unsafe { super::context::nfc_init_impl(&mut context) };
+    assert!(!context.is_null());
+    unsafe {
+        set_runtime_context(
+            context,
+            rt::Context::with_config(rt::ContextConfig {
+                device_pool_size: 1,
+                ..rt::ContextConfig::default()
+            }),
+        )
+    };
+
+    let handle = PooledHandle {
+        connstring: rt::ConnectionString::new("pooled:0").unwrap(),
+    };
+    let device = attach_rust_device(rt::Device::from_handle(Box::new(handle)), context).unwrap();
+    unsafe { close_rust_device(device) };
+    assert_eq!(runtime_registry(context).parked_device_count(), 1);
+
+    // No driver handles the "pooled" family, so only the pool can serve this.
+    let conn = CString::new("pooled:0").unwrap();
+    let reopened = unsafe { nfc_open(context, conn.as_ptr()) };
+    assert!(!reopened.is_null());
+    assert_eq!(
+        fixed_c_buffer_to_string(unsafe { &(*reopened).connstring }),
+        "pooled:0".to_string()
+    );
+    assert_eq!(runtime_registry(context).parked_device_count(), 0);
+
+    unsafe {
+        close_rust_device(reopened);
+        nfc_exit(context);
+    }
+}
+
 #[test]
 fn open_matches_exact_driver_name_and_usb_suffix() {
     let _guard = core_test_guard();
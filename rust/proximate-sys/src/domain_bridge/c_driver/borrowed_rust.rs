@@ -206,6 +206,21 @@ impl rt::InitiatorBackend for RustBorrowedDevice {
         )
     }
 
+    fn list_passive_targets_driver(
+        &mut self,
+        nm: rt::Modulation,
+        init_data: &[u8],
+        max_targets: usize,
+    ) -> Result<Vec<rt::Target>, rt::Error> {
+        let result = self
+            .with_handle(|handle| handle.list_passive_targets_driver(nm, init_data, max_targets));
+        self.normalize(
+            rt::DeviceCaps::LIST_PASSIVE_TARGETS,
+            "initiator_list_passive_targets",
+            result,
+        )
+    }
+
     fn poll_target_driver(
         &mut self,
         modulations: &[rt::Modulation],
@@ -324,6 +339,10 @@ impl rt::InitiatorBackend for RustBorrowedDevice {
         self.normalize(rt::DeviceCaps::IDLE, "idle", result)
     }
 
+    fn reset_session_driver(&mut self) -> Result<(), rt::Error> {
+        self.with_handle(|handle| handle.reset_session_driver())
+    }
+
     fn powerdown_driver(&mut self) -> Result<(), rt::Error> {
         let result = self.with_handle(|handle| handle.powerdown_driver());
         self.normalize(rt::DeviceCaps::POWERDOWN, "powerdown", result)
@@ -21,20 +21,21 @@ fn refresh_cached_strerror(state: &mut RustDeviceState) -> *const c_char {
     state.strerror.as_ptr()
 }
 
-pub(crate) unsafe fn free_rust_device(device: *mut nfc_device) {
-    let Some(device_ref) = (unsafe { optional_mut(device) }) else {
-        return;
-    };
+/// Frees the C-side device and hands back the driver handle it wrapped, so
+/// the caller decides whether the underlying device is closed or kept.
+pub(crate) unsafe fn detach_rust_device(
+    device: *mut nfc_device,
+) -> Option<Box<dyn rt::DeviceHandle>> {
+    let device_ref = unsafe { optional_mut(device) }?;
 
     let state_ptr = device_ref.driver_data as *mut RustDeviceState;
     device_ref.driver_data = ptr::null_mut();
     device_ref.driver = ptr::null();
 
-    if !state_ptr.is_null() {
-        unsafe { drop(Box::from_raw(state_ptr)) };
-    }
+    let handle = (!state_ptr.is_null()).then(|| unsafe { Box::from_raw(state_ptr) }.handle);
 
     unsafe { release_allocated_ptr(device.cast()) };
+    handle
 }
 
 pub(crate) fn attach_rust_device(
@@ -89,7 +90,7 @@ pub(crate) fn is_rust_shim_device(raw: *mut nfc_device) -> bool {
 
 #[cfg(test)]
 unsafe extern "C" fn rust_test_close(device: *mut nfc_device) {
-    unsafe { free_rust_device(device) };
+    drop(unsafe { detach_rust_device(device) });
 }
 
 #[cfg(test)]
@@ -342,6 +342,7 @@ fn external_driver_registry_keeps_usb_fallback_and_name_override_behavior() {
             connstring: rt::ConnectionString::new("usb").unwrap(),
             optional: false,
         }],
+        ..rt::ContextConfig::default()
     });
 
     let connstring = rt::ConnectionString::new("usb").unwrap();
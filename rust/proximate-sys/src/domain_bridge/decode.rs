@@ -10,14 +10,20 @@ use crate::c_boundary::status::invalid_argument_status;
 use crate::lifecycle::{MAX_USER_DEFINED_DEVICES, nfc_context, runtime_context_from_c};
 use libc::{c_char, c_int, size_t};
 use proximate_driver as rt;
+use std::sync::Arc;
 use std::{ptr, slice};
 
-pub(crate) fn context_from_c(context: *const nfc_context) -> rt::Context {
+pub(crate) fn context_from_c(context: *const nfc_context) -> Arc<rt::Context> {
     let Some(context_ref) = (unsafe { optional_ref(context) }) else {
-        return rt::Context::default();
+        return Arc::new(rt::Context::default());
     };
 
-    let mut runtime = unsafe { runtime_context_from_c(context) }.unwrap_or_default();
+    unsafe { runtime_context_from_c(context, decode_context) }
+        .unwrap_or_else(|| Arc::new(decode_context(context_ref, &rt::Context::default())))
+}
+
+fn decode_context(context_ref: &nfc_context, base: &rt::Context) -> rt::Context {
+    let mut runtime = base.clone();
 
     let mut user_defined_devices = Vec::new();
     let count = (context_ref.user_defined_device_count as usize).min(MAX_USER_DEFINED_DEVICES);
@@ -41,6 +47,7 @@ pub(crate) fn context_from_c(context: *const nfc_context) -> rt::Context {
         allow_intrusive_scan: context_ref.allow_intrusive_scan,
         log_level: context_ref.log_level,
         user_defined_devices,
+        ..base.config.clone()
     };
     runtime
 }
@@ -150,6 +157,8 @@ pub(crate) fn property_from_c(property: nfc_property) -> rt::Property {
         nfc_property::NP_FORCE_ISO14443_A => rt::Property::ForceIso14443A,
         nfc_property::NP_FORCE_ISO14443_B => rt::Property::ForceIso14443B,
         nfc_property::NP_FORCE_SPEED_106 => rt::Property::ForceSpeed106,
+        nfc_property::NP_AUTO_BIT_RATE => rt::Property::AutoBitRate,
+        nfc_property::NP_PRESENCE_WINDOW => rt::Property::PresenceWindow,
     }
 }
 
@@ -346,6 +355,25 @@ mod tests {
     use crate::lifecycle::nfc_device;
     use std::ptr;
 
+    #[test]
+    fn context_from_c_shares_decoded_context_until_c_fields_change() {
+        let context = unsafe { crate::lifecycle::nfc_context_alloc_defaults() };
+        assert!(!context.is_null());
+
+        let first = context_from_c(context);
+        let second = context_from_c(context);
+        assert!(Arc::ptr_eq(&first, &second));
+        assert!(!first.config.allow_intrusive_scan);
+
+        unsafe { (*context).allow_intrusive_scan = true };
+        let refreshed = context_from_c(context);
+        assert!(!Arc::ptr_eq(&first, &refreshed));
+        assert!(refreshed.config.allow_intrusive_scan);
+        assert!(Arc::ptr_eq(&refreshed, &context_from_c(context)));
+
+        unsafe { crate::lifecycle::nfc_context_free(context) };
+    }
+
     #[test]
     fn decode_connstring_ptr_handles_null() {
         assert_eq!(decode_connstring_ptr(std::ptr::null()).unwrap(), None);
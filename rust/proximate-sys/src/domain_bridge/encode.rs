@@ -137,6 +137,8 @@ pub(crate) fn property_to_c(property: rt::Property) -> nfc_property {
         rt::Property::ForceIso14443A => nfc_property::NP_FORCE_ISO14443_A,
         rt::Property::ForceIso14443B => nfc_property::NP_FORCE_ISO14443_B,
         rt::Property::ForceSpeed106 => nfc_property::NP_FORCE_SPEED_106,
+        rt::Property::AutoBitRate => nfc_property::NP_AUTO_BIT_RATE,
+        rt::Property::PresenceWindow => nfc_property::NP_PRESENCE_WINDOW,
     }
 }
 
@@ -630,6 +632,11 @@ mod tests {
                 rt::Property::ForceSpeed106,
                 nfc_property::NP_FORCE_SPEED_106,
             ),
+            (rt::Property::AutoBitRate, nfc_property::NP_AUTO_BIT_RATE),
+            (
+                rt::Property::PresenceWindow,
+                nfc_property::NP_PRESENCE_WINDOW,
+            ),
         ];
         for (runtime, raw) in properties {
             assert_eq!(property_to_c(runtime), raw);
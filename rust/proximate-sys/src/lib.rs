@@ -43,6 +43,8 @@ pub(crate) use c_boundary::{
     set_last_error_message,
 };
 #[cfg(any(feature = "c_ffi", cbindgen, test))]
+pub use core::monitor::nfc_device_monitor;
+#[cfg(any(feature = "c_ffi", cbindgen, test))]
 pub use lifecycle::{nfc_connstring, nfc_context, nfc_device, nfc_driver};
 #[cfg(test)]
 pub(crate) use logger::{
@@ -188,6 +188,7 @@ unsafe impl Sync for nfc_driver {}
 
 #[allow(non_camel_case_types)]
 #[allow(non_snake_case)]
+#[derive(Clone, Copy, PartialEq)]
 #[repr(C)]
 pub(crate) struct nfc_user_defined_device {
     pub(crate) name: [c_char; DEVICE_NAME_LENGTH],
@@ -1,4 +1,4 @@
-use super::abi::{nfc_context, nfc_device};
+use super::abi::{MAX_USER_DEFINED_DEVICES, nfc_context, nfc_device, nfc_user_defined_device};
 use super::logging;
 use crate::c_boundary::NFC_BUFSIZE_CONNSTRING;
 use crate::c_boundary::raw::{copy_c_string_to_c_buffer, optional_mut, optional_ref};
@@ -7,10 +7,11 @@ use crate::{
     ffi_catch_unwind_ptr, ffi_catch_unwind_void, log_error, release_allocated_ptr,
     reset_last_error, set_last_error_message,
 };
-use libc::{c_char, c_void};
+use libc::{c_char, c_uint, c_void};
 use proximate_driver as rt;
 use std::mem::size_of;
 use std::ptr;
+use std::sync::{Arc, Mutex};
 
 unsafe fn allocate_zeroed<T>(label: &str) -> *mut T {
     let ptr = unsafe { libc::calloc(1, size_of::<T>()) as *mut T };
@@ -67,34 +68,141 @@ unsafe fn nfc_device_new_impl(
     device
 }
 
+struct CachedRegistry {
+    generation: u64,
+    registry: Arc<rt::DriverRegistry>,
+}
+
+#[derive(Clone, Copy)]
+struct ContextSource {
+    allow_autoscan: bool,
+    allow_intrusive_scan: bool,
+    log_level: u32,
+    user_defined_devices: [nfc_user_defined_device; MAX_USER_DEFINED_DEVICES],
+    user_defined_device_count: c_uint,
+}
+
+impl ContextSource {
+    fn capture(context: &nfc_context) -> Self {
+        Self {
+            allow_autoscan: context.allow_autoscan,
+            allow_intrusive_scan: context.allow_intrusive_scan,
+            log_level: context.log_level,
+            user_defined_devices: context.user_defined_devices,
+            user_defined_device_count: context.user_defined_device_count,
+        }
+    }
+
+    fn matches(&self, context: &nfc_context) -> bool {
+        self.allow_autoscan == context.allow_autoscan
+            && self.allow_intrusive_scan == context.allow_intrusive_scan
+            && self.log_level == context.log_level
+            && self.user_defined_device_count == context.user_defined_device_count
+            && self.user_defined_devices == context.user_defined_devices
+    }
+}
+
+struct DecodedContext {
+    source: ContextSource,
+    context: Arc<rt::Context>,
+}
+
+struct RuntimeData {
+    context: rt::Context,
+    decoded: Mutex<Option<DecodedContext>>,
+    registry: Mutex<Option<CachedRegistry>>,
+}
+
+impl RuntimeData {
+    fn new(context: rt::Context) -> Self {
+        Self {
+            context,
+            decoded: Mutex::new(None),
+            registry: Mutex::new(None),
+        }
+    }
+}
+
+unsafe fn runtime_data_ref<'a>(context: *const nfc_context) -> Option<&'a RuntimeData> {
+    let context_ref = unsafe { optional_ref(context) }?;
+    unsafe { (context_ref.runtime_data as *const RuntimeData).as_ref() }
+}
+
+unsafe fn drop_runtime_data(context_ref: &mut nfc_context) {
+    if !context_ref.runtime_data.is_null() {
+        unsafe { drop(Box::from_raw(context_ref.runtime_data as *mut RuntimeData)) };
+        context_ref.runtime_data = ptr::null_mut();
+    }
+}
+
 pub(crate) unsafe fn set_runtime_context(context: *mut nfc_context, runtime: rt::Context) {
     let Some(context_ref) = (unsafe { optional_mut(context) }) else {
         return;
     };
 
-    if !context_ref.runtime_data.is_null() {
-        unsafe { drop(Box::from_raw(context_ref.runtime_data as *mut rt::Context)) };
-    }
-
-    context_ref.runtime_data = Box::into_raw(Box::new(runtime)).cast();
+    unsafe { drop_runtime_data(context_ref) };
+    context_ref.runtime_data = Box::into_raw(Box::new(RuntimeData::new(runtime))).cast();
 }
 
-pub(crate) unsafe fn runtime_context_from_c(context: *const nfc_context) -> Option<rt::Context> {
+/// Returns the runtime context decoded from the C-visible fields of
+/// `context`. The decoded value is cached and shared until one of those
+/// fields changes, at which point `decode` rebuilds it from the context
+/// loaded at allocation time. Returns `None` when `context` carries no
+/// runtime data.
+pub(crate) unsafe fn runtime_context_from_c(
+    context: *const nfc_context,
+    decode: impl FnOnce(&nfc_context, &rt::Context) -> rt::Context,
+) -> Option<Arc<rt::Context>> {
     let context_ref = unsafe { optional_ref(context) }?;
-    let runtime = context_ref.runtime_data as *const rt::Context;
-    if runtime.is_null() {
-        None
-    } else {
-        Some(unsafe { (*runtime).clone() })
+    let runtime = unsafe { runtime_data_ref(context) }?;
+    let mut decoded = runtime
+        .decoded
+        .lock()
+        .expect("context decode mutex should not be poisoned");
+
+    match decoded.as_ref() {
+        Some(entry) if entry.source.matches(context_ref) => Some(Arc::clone(&entry.context)),
+        _ => {
+            let fresh = Arc::new(decode(context_ref, &runtime.context));
+            *decoded = Some(DecodedContext {
+                source: ContextSource::capture(context_ref),
+                context: Arc::clone(&fresh),
+            });
+            Some(fresh)
+        }
+    }
+}
+
+/// Returns the driver registry cached on `context`, rebuilding it with
+/// `build` when it was built for a different external driver `generation`.
+/// Returns `None` when `context` carries no runtime data.
+pub(crate) unsafe fn runtime_registry_from_c(
+    context: *const nfc_context,
+    generation: u64,
+    build: impl FnOnce() -> rt::DriverRegistry,
+) -> Option<Arc<rt::DriverRegistry>> {
+    let runtime = unsafe { runtime_data_ref(context) }?;
+    let mut cached = runtime
+        .registry
+        .lock()
+        .expect("context registry mutex should not be poisoned");
+
+    match cached.as_ref() {
+        Some(entry) if entry.generation == generation => Some(Arc::clone(&entry.registry)),
+        _ => {
+            let registry = Arc::new(build());
+            *cached = Some(CachedRegistry {
+                generation,
+                registry: Arc::clone(&registry),
+            });
+            Some(registry)
+        }
     }
 }
 
 unsafe fn free_context_allocation(context: *mut nfc_context) {
-    if let Some(context_ref) = unsafe { optional_mut(context) }
-        && !context_ref.runtime_data.is_null()
-    {
-        unsafe { drop(Box::from_raw(context_ref.runtime_data as *mut rt::Context)) };
-        context_ref.runtime_data = ptr::null_mut();
+    if let Some(context_ref) = unsafe { optional_mut(context) } {
+        unsafe { drop_runtime_data(context_ref) };
     }
     unsafe { release_allocated_ptr(context as *mut c_void) };
 }
@@ -12,6 +12,9 @@ pub use abi::{nfc_connstring, nfc_context, nfc_device, nfc_driver};
 
 #[cfg(test)]
 pub(crate) use alloc::{nfc_context_alloc_defaults, nfc_device_free};
-pub(crate) use alloc::{nfc_context_free, nfc_context_new, nfc_device_new, runtime_context_from_c};
+pub(crate) use alloc::{
+    nfc_context_free, nfc_context_new, nfc_device_new, runtime_context_from_c,
+    runtime_registry_from_c,
+};
 #[cfg(test)]
 pub(crate) use logging::{reset_lifecycle_test_state, snapshot_lifecycle_test_state};
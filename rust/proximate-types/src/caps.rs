@@ -41,5 +41,6 @@ bitflags! {
         const PN53X_READ_REGISTER = 1 << 25;
         const PN53X_WRITE_REGISTER = 1 << 26;
         const PN532_SAM_CONFIGURATION = 1 << 27;
+        const LIST_PASSIVE_TARGETS = 1 << 28;
     }
 }
@@ -22,6 +22,8 @@ pub enum Property {
     ForceIso14443A,
     ForceIso14443B,
     ForceSpeed106,
+    AutoBitRate,
+    PresenceWindow,
 }
 
 impl Property {
@@ -43,6 +45,8 @@ impl Property {
             Self::ForceIso14443A => "NP_FORCE_ISO14443_A",
             Self::ForceIso14443B => "NP_FORCE_ISO14443_B",
             Self::ForceSpeed106 => "NP_FORCE_SPEED_106",
+            Self::AutoBitRate => "NP_AUTO_BIT_RATE",
+            Self::PresenceWindow => "NP_PRESENCE_WINDOW",
         }
     }
 }
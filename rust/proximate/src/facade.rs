@@ -1,7 +1,9 @@
 use std::fmt;
 use std::path::Path;
+use std::time::Duration;
 
 use proximate_driver as rt;
+use proximate_native::hotplug;
 
 #[derive(Clone, Debug, Eq, PartialEq)]
 pub struct Selector(rt::ConnectionString);
@@ -84,6 +86,34 @@ impl Config {
         self.0.log_level
     }
 
+    pub fn parallel_scan(&self) -> bool {
+        self.0.parallel_scan
+    }
+
+    pub fn driver_scan_budget_ms(&self) -> u32 {
+        self.0.driver_scan_budget_ms
+    }
+
+    pub fn scan_cache_ttl_ms(&self) -> u32 {
+        self.0.scan_cache_ttl_ms
+    }
+
+    pub fn chip_identity_cache(&self) -> bool {
+        self.0.chip_identity_cache
+    }
+
+    pub fn device_pool_size(&self) -> u32 {
+        self.0.device_pool_size
+    }
+
+    pub fn uart_max_speed(&self) -> u32 {
+        self.0.uart_max_speed
+    }
+
+    pub fn uart_low_latency(&self) -> bool {
+        self.0.uart_low_latency
+    }
+
     pub fn user_defined_devices(&self) -> &[rt::UserDefinedDevice] {
         &self.0.user_defined_devices
     }
@@ -103,6 +133,41 @@ impl Config {
         self
     }
 
+    pub fn with_parallel_scan(mut self, value: bool) -> Self {
+        self.0.parallel_scan = value;
+        self
+    }
+
+    pub fn with_driver_scan_budget_ms(mut self, value: u32) -> Self {
+        self.0.driver_scan_budget_ms = value;
+        self
+    }
+
+    pub fn with_scan_cache_ttl_ms(mut self, value: u32) -> Self {
+        self.0.scan_cache_ttl_ms = value;
+        self
+    }
+
+    pub fn with_chip_identity_cache(mut self, value: bool) -> Self {
+        self.0.chip_identity_cache = value;
+        self
+    }
+
+    pub fn with_device_pool_size(mut self, value: u32) -> Self {
+        self.0.device_pool_size = value;
+        self
+    }
+
+    pub fn with_uart_max_speed(mut self, value: u32) -> Self {
+        self.0.uart_max_speed = value;
+        self
+    }
+
+    pub fn with_uart_low_latency(mut self, value: bool) -> Self {
+        self.0.uart_low_latency = value;
+        self
+    }
+
     pub fn with_user_device(mut self, device: rt::UserDefinedDevice) -> Self {
         self.0.user_defined_devices.push(device);
         self
@@ -137,6 +202,66 @@ pub struct DeviceDescriptor {
     pub origin: rt::DeviceOrigin,
 }
 
+impl From<rt::DiscoveredDevice> for DeviceDescriptor {
+    fn from(value: rt::DiscoveredDevice) -> Self {
+        Self {
+            display_name: value.display_name,
+            selector: value.connstring.into(),
+            caps: value.caps,
+            scan_type: value.scan_type,
+            exclusive: value.exclusive,
+            origin: value.origin,
+        }
+    }
+}
+
+#[derive(Clone, Debug, Eq, PartialEq)]
+pub enum DeviceEvent {
+    Added(DeviceDescriptor),
+    Removed(Selector),
+}
+
+impl From<hotplug::DeviceEvent> for DeviceEvent {
+    fn from(value: hotplug::DeviceEvent) -> Self {
+        match value {
+            hotplug::DeviceEvent::Added(device) => Self::Added(device.into()),
+            hotplug::DeviceEvent::Removed(connstring) => Self::Removed(connstring.into()),
+        }
+    }
+}
+
+/// Blocking iterator over hotplug events for a [`Context`].
+pub struct DeviceEvents<'a> {
+    context: &'a Context,
+    monitor: hotplug::DeviceMonitor,
+}
+
+impl DeviceEvents<'_> {
+    pub fn as_raw_fd(&self) -> i32 {
+        self.monitor.as_raw_fd()
+    }
+
+    pub fn next_timeout(&mut self, timeout: Duration) -> Result<Option<DeviceEvent>, rt::Error> {
+        let timeout_ms = i32::try_from(timeout.as_millis()).unwrap_or(i32::MAX);
+        self.poll(timeout_ms)
+    }
+
+    fn poll(&mut self, timeout_ms: i32) -> Result<Option<DeviceEvent>, rt::Error> {
+        Ok(self
+            .monitor
+            .next_event(&self.context.registry, &self.context.runtime, timeout_ms)?
+            .map(DeviceEvent::from))
+    }
+}
+
+impl Iterator for DeviceEvents<'_> {
+    type Item = Result<DeviceEvent, rt::Error>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        self.poll(-1).transpose()
+    }
+}
+
 pub struct ContextBuilder {
     config: Config,
     registry: rt::DriverRegistry,
@@ -228,17 +353,18 @@ impl Context {
 
     pub fn scan(&self) -> Result<Vec<DeviceDescriptor>, rt::Error> {
         let devices = self.registry.list_devices(&self.runtime)?;
-        Ok(devices
-            .into_iter()
-            .map(|descriptor| DeviceDescriptor {
-                display_name: descriptor.display_name,
-                selector: descriptor.connstring.into(),
-                caps: descriptor.caps,
-                scan_type: descriptor.scan_type,
-                exclusive: descriptor.exclusive,
-                origin: descriptor.origin,
-            })
-            .collect())
+        Ok(devices.into_iter().map(DeviceDescriptor::from).collect())
+    }
+
+    pub fn device_events(&self) -> Result<DeviceEvents<'_>, rt::Error> {
+        self.device_events_in(Path::new(hotplug::DEFAULT_DEVICE_DIR))
+    }
+
+    pub fn device_events_in(&self, dir: &Path) -> Result<DeviceEvents<'_>, rt::Error> {
+        Ok(DeviceEvents {
+            context: self,
+            monitor: hotplug::DeviceMonitor::watch_dir(dir)?,
+        })
     }
 
     pub fn open(&self, selector: &Selector) -> Result<rt::Device, rt::Error> {
@@ -355,6 +481,19 @@ mod tests {
             )])
         }
 
+        fn probe_node(
+            &self,
+            _context: &rt::Context,
+            path: &str,
+        ) -> Result<Vec<rt::DiscoveredDevice>, rt::Error> {
+            let name = Path::new(path).file_name().unwrap().to_string_lossy();
+            Ok(vec![self.describe_discovered(
+                format!("fake node {name}"),
+                rt::ConnectionString::new(format!("fake:{name}")).unwrap(),
+                Some(self.caps),
+            )])
+        }
+
         fn open(
             &self,
             _context: &rt::Context,
@@ -500,6 +639,40 @@ mod tests {
         assert_eq!(device.connstring().as_str(), "fake:001");
     }
 
+    #[test]
+    #[cfg(target_os = "linux")]
+    fn device_events_follow_nodes_in_the_watched_dir() {
+        let dir =
+            std::env::temp_dir().join(format!("proximate-facade-events-{}", std::process::id()));
+        let _ = std::fs::remove_dir_all(&dir);
+        std::fs::create_dir_all(&dir).unwrap();
+        let context = Context::builder()
+            .without_builtin_drivers()
+            .register_driver(FakeDriver {
+                caps: rt::DeviceCaps::SET_PROPERTY_BOOL,
+            })
+            .build();
+        let mut events = context.device_events_in(&dir).unwrap();
+
+        std::fs::write(dir.join("002"), b"").unwrap();
+        let Some(Ok(DeviceEvent::Added(descriptor))) = events.next() else {
+            panic!("expected an added device");
+        };
+        assert_eq!(descriptor.selector.as_str(), "fake:002");
+        assert_eq!(descriptor.display_name, "fake node 002");
+
+        std::fs::remove_file(dir.join("002")).unwrap();
+        assert_eq!(
+            events.next_timeout(Duration::from_secs(1)).unwrap(),
+            Some(DeviceEvent::Removed(Selector::new("fake:002").unwrap()))
+        );
+        assert_eq!(
+            events.next_timeout(Duration::from_millis(20)).unwrap(),
+            None
+        );
+        std::fs::remove_dir_all(&dir).unwrap();
+    }
+
     #[test]
     fn try_load_surfaces_context_load_error() {
         let _env_guard = env_lock().lock().unwrap();
@@ -1,6 +1,8 @@
 mod facade;
 
-pub use facade::{Config, Context, ContextBuilder, DeviceDescriptor, Selector};
+pub use facade::{
+    Config, Context, ContextBuilder, DeviceDescriptor, DeviceEvent, DeviceEvents, Selector,
+};
 pub use proximate_driver::{
     ContextLoadError, DepOps, Device, DeviceOrigin, InfoOps, InitiatorIoOps, PassiveScanOps,
     Pn53xOps, PropertyOps, SessionOps, TargetIoOps, UserDefinedDevice,